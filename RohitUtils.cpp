@@ -78,6 +78,19 @@ namespace RohitUtils {
         fflush(stdout);  // Ensure immediate output
     }
 
+    // Same as above, written to a stream instead of stdout: a VM whose output
+    // is captured (brovm.h) must not print behind the caller's back.
+    void printhex(std::ostream& out, const uint8_t* str, uint16_t size, char delim) {
+        char hex[3];
+        for (uint16_t i = 0; i < size; ++i) {
+            snprintf(hex, sizeof(hex), "%.02x", str[i]);
+            out << hex;
+            if (delim)
+                out << delim;
+        }
+        out << "\n";
+    }
+
     // -------------------------------
     // Function: todotted
     // Purpose: Converts a 32-bit IP address (in_addr_t) to a human-readable dotted decimal format
@@ -85,13 +98,14 @@ namespace RohitUtils {
     // Parameters:
     //   - ip: IPv4 address as a 32-bit integer
     // Returns:
-    //   - A string representing the IP in dotted-decimal format
+    //   - A string representing the IP in dotted-decimal format (a new string
+    //     each call, so threads can convert at the same time)
     // Why it's here:
     //   - Some instructions or debug outputs may involve IP addresses.
     // Helps the code by:
     //   - Turning low-level binary IP into something human-readable.
-    const char* todotted(uint32_t ip) {
-        static char buf[16];  // Enough for "255.255.255.255"
+    std::string todotted(uint32_t ip) {
+        char buf[16];  // Enough for "255.255.255.255"
         snprintf(buf, sizeof(buf), "%u.%u.%u.%u",
             (ip & 0xFF000000) >> 24,
             (ip & 0x00FF0000) >> 16,
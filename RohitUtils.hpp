@@ -2,7 +2,8 @@
 
 #include <cstdint>     // Fixed-width integer types
 #include <cstdio>      // printf and related functions
-#include <string>      // Optional for future use
+#include <ostream>     // printhex to a stream
+#include <string>      // todotted
 #include <arpa/inet.h> // For in_addr_t (IP representation)
 
 // =====================
@@ -24,7 +25,10 @@ namespace RohitUtils {
     // Print memory block as hex values
     void printhex(const uint8_t* str, uint16_t size, char delim = ' ');
 
+    // Same, to `out` (the VM's output stream)
+    void printhex(std::ostream& out, const uint8_t* str, uint16_t size, char delim = ' ');
+
     // Convert a 32-bit IP address to dotted decimal format
-    const char* todotted(uint32_t ip);
+    std::string todotted(uint32_t ip);
 
 } // namespace RohitUtils
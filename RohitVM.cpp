@@ -1,86 +1,172 @@
 #include "RohitVM.hpp"
+#include "brobin.h"
+#include <algorithm>
+#include <fstream>
 #include <iostream>
-#include <map>
 
 // -----------------------------------------------------------------------------
 // loadProgram: write instructions into memory
+// Codegen addresses jump targets by instruction index, while the CPU jumps to
+// byte addresses, so jump operands are rewritten while the program is laid out
+// (BroBin::encode, the same encoding a .brobin image stores).
 // -----------------------------------------------------------------------------
-void VM::loadProgram(const std::vector<Instruction>& program) {
-    auto mem = memory.raw();
-    breakLine = 0;
-    for (auto& instr : program) {
-        mem[breakLine++] = static_cast<uint8_t>(instr.op);
-        uint8_t size = getInstructionSize(instr.op);
-        if (size >= 2) {
-            mem[breakLine++] = instr.a1 & 0xFF;
-            mem[breakLine++] = (instr.a1 >> 8) & 0xFF;
-        }
-        if (size == 5) {
-            mem[breakLine++] = instr.a2 & 0xFF;
-            mem[breakLine++] = (instr.a2 >> 8) & 0xFF;
-        }
+void VM::loadProgram(const Instruction* program, size_t count) {
+    std::vector<uint8_t> bytes;
+    if (!BroBin::encode(program, count, bytes)) handleError("Jump target out of range");
+    std::copy(bytes.begin(), bytes.end(), memory.raw());
+    setCode(memory.raw(), static_cast<uint32_t>(bytes.size()));
+    image.reset();
+    imageSourceMap.clear();
+}
+
+// -----------------------------------------------------------------------------
+// loadImage: map a .brobin file (see brobin.h); the code runs from the mapping
+// -----------------------------------------------------------------------------
+bool VM::loadImage(const std::string& path) {
+    std::string error;
+    BroBin::View view;
+    auto file = BroBin::MappedFile::open(path, error);
+    if (!file || !BroBin::parse(file->data(), file->size(), view, error)) {
+        std::cerr << "Invalid image " << path << ": " << error << "\n";
+        return false;
+    }
+    if (!loadImage(view, file)) {
+        std::cerr << "Invalid image " << path << ": " << error << "\n";
+        return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// loadImage: an image inside memory owned elsewhere (an archive member, a
+// compiled program)
+// -----------------------------------------------------------------------------
+bool VM::loadImage(const BroBin::View& view, std::shared_ptr<const void> owner) {
+    if (view.codeSize > Memory::SIZE ||
+        (view.dataSize > 0 && (view.dataAddress < view.codeSize ||
+                               view.dataAddress + uint64_t(view.dataSize) > Memory::SIZE))) {
+        error = "Image does not fit in memory";
+        return false;
+    }
+    image = std::move(owner);
+    setCode(view.code, view.codeSize);
+    loadData(view.dataAddress, view.data, view.dataSize);
+    imageSourceMap = view.decodeSourceMap();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// setCode: where instructions are fetched from (addresses 0 .. size - 1)
+// -----------------------------------------------------------------------------
+void VM::setCode(const uint8_t* bytes, uint32_t size) {
+    code = bytes;
+    codeSize = size;
+    breakLine = static_cast<uint16_t>(std::min<uint32_t>(size, Memory::SIZE - 1));
+}
+
+// -----------------------------------------------------------------------------
+// prepareProfile: which instruction starts at each byte address
+// -----------------------------------------------------------------------------
+void VM::prepareProfile() {
+    if (!BroBin::decode(code, codeSize, loaded)) handleError("Malformed program");
+    indexAt.assign(Memory::SIZE, -1);
+    uint32_t address = 0;
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        indexAt[address] = static_cast<int>(i);
+        address += instructionSize(loaded[i].op);
     }
+    executedCounts.assign(loaded.size(), 0);
+    takenCounts.assign(loaded.size(), 0);
+}
+
+// -----------------------------------------------------------------------------
+// loadData: copy the read-only data section (string literals) into memory
+// -----------------------------------------------------------------------------
+void VM::loadData(uint16_t address, const uint8_t* bytes, size_t size) {
+    if (size == 0) return;
+    if (address < breakLine) handleError("Data section overlaps the program");
+    if (address + size > Memory::SIZE) handleError("Data section out of memory");
+    std::copy(bytes, bytes + size, memory.raw() + address);
 }
 
 // -----------------------------------------------------------------------------
 // execute: run fetch-decode-execute loop
 // -----------------------------------------------------------------------------
-void VM::execute() {
+bool VM::execute() {
+    error.clear();
+    stop = Stop::Fault;     // Unless HLT or the limit says otherwise
     try {
-        std::cout << "Starting VM Execution...\n";
+        if (profiling) prepareProfile();
+        if (banners) *output << "Starting VM Execution...\n";
         while (true) {
+            if (instructionCount >= instructionLimit) {
+                stop = Stop::Limit;
+                handleError("Instruction limit exceeded");
+            }
+            uint16_t at = cpu.r.ip;
             auto instr = fetchNextInstruction();
+            uint16_t next = cpu.r.ip;
+            ++instructionCount;
             executeInstruction(instr);
+
+            if (profiling && indexAt[at] >= 0) {
+                ++executedCounts[indexAt[at]];
+                if (cpu.r.ip != next) ++takenCounts[indexAt[at]];
+            }
             if (instr.op == Opcode::HLT) {
-                std::cout << "Program Halted.\n";
-                break;
+                if (banners) *output << "Program Halted.\n";
+                stop = Stop::Halted;
+                return true;
             }
         }
     } catch (const std::exception& ex) {
-        handleError(ex.what());
+        if (exitOnError) handleError(ex.what());
+        error = ex.what();
+        return false;
     }
 }
 
+// -----------------------------------------------------------------------------
+// writeProfile: dump the counts gathered while `profiling` was set
+// -----------------------------------------------------------------------------
+bool VM::writeProfile(const std::string& path, const std::vector<int>& sourceMap) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open profile file: " << path << "\n";
+        return false;
+    }
+
+    out << "# BroLang profile: index opcode statement executed taken\n";
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        int statement = i < sourceMap.size() ? sourceMap[i] : -1;
+        out << i << " 0x" << std::hex << static_cast<int>(loaded[i].op) << std::dec
+            << " " << statement << " " << executedCounts[i] << " " << takenCounts[i] << "\n";
+    }
+    return true;
+}
+
 // -----------------------------------------------------------------------------
 // fetchNextInstruction: decode next bytes into Instruction
 // -----------------------------------------------------------------------------
 Instruction VM::fetchNextInstruction() {
     uint16_t ip = cpu.r.ip;
-    Opcode op = static_cast<Opcode>(memory[ip]);
-    uint8_t size = getInstructionSize(op);
+    if (ip >= codeSize) handleError("Illegal Instruction");
+    Opcode op = static_cast<Opcode>(code[ip]);
+    uint8_t size = instructionSize(op);
+    if (size == 0 || ip + size > codeSize) handleError("Illegal Instruction");
 
     Instruction instr;
     instr.op = op;
     if (size >= 2) {
-        instr.a1 = memory[ip + 1] | (memory[ip + 2] << 8);
+        instr.a1 = code[ip + 1] | (code[ip + 2] << 8);
     }
     if (size == 5) {
-        instr.a2 = memory[ip + 3] | (memory[ip + 4] << 8);
+        instr.a2 = code[ip + 3] | (code[ip + 4] << 8);
     }
     cpu.r.ip += size;
     return instr;
 }
 
-// -----------------------------------------------------------------------------
-// getInstructionSize: number of bytes each opcode uses
-// -----------------------------------------------------------------------------
-uint8_t VM::getInstructionSize(Opcode op) {
-    static std::map<Opcode, uint8_t> m = {
-        {Opcode::NOP, 1}, {Opcode::HLT, 1},
-        {Opcode::MOV, 3}, {Opcode::MOV_BX, 3}, {Opcode::MOV_CX, 3},
-        {Opcode::MOV_DX, 3}, {Opcode::MOV_SP, 3},
-        {Opcode::STE, 1}, {Opcode::CLE, 1},
-        {Opcode::STG, 1}, {Opcode::CLG, 1},
-        {Opcode::STH, 1}, {Opcode::CLH, 1},
-        {Opcode::STL, 1}, {Opcode::CLL, 1},
-        {Opcode::PUSH, 3}, {Opcode::POP, 3},
-        {Opcode::ADD, 1}, {Opcode::SUB, 1}, {Opcode::MUL, 1}, {Opcode::DIV, 1},
-        {Opcode::PRN, 1},
-        {Opcode::JMP, 3}, {Opcode::JZ, 3},  {Opcode::JNZ, 3}
-    };
-    return m[op];
-}
-
 // -----------------------------------------------------------------------------
 // executeInstruction: perform the operation
 // -----------------------------------------------------------------------------
@@ -89,11 +175,14 @@ void VM::executeInstruction(const Instruction& instr) {
         case Opcode::NOP: break;
 
         case Opcode::HLT:
-            std::cout << "System Halted\n";
-            std::cout << "AX: " << cpu.r.ax << ", BX: " << cpu.r.bx
-                      << ", CX: " << cpu.r.cx << ", DX: " << cpu.r.dx
-                      << ", SP: " << cpu.r.sp << "\n";
-            RohitUtils::printhex(memory.raw() + 0xFFFF - 32, 32, ' ');
+            if (!banners) break;
+            *output << "System Halted\n";
+            *output << "AX: " << cpu.r.ax << ", BX: " << cpu.r.bx
+                    << ", CX: " << cpu.r.cx << ", DX: " << cpu.r.dx
+                    << ", SP: " << cpu.r.sp << "\n";
+            *output << "Instructions executed: " << instructionCount << "\n";
+            *output << "Taken branches: " << takenBranchCount << "\n";
+            RohitUtils::printhex(*output, memory.raw() + 0xFFFF - 32, 32, ' ');
             break;
 
         // --- MOVs ---
@@ -111,6 +200,33 @@ void VM::executeInstruction(const Instruction& instr) {
             if (cpu.r.bx == 0) handleError("Division by zero");
             cpu.r.ax /= cpu.r.bx;
             break;
+        case Opcode::DIV_NC: cpu.r.ax /= cpu.r.bx; break;
+
+        // --- Intrinsics: a comparison turned into a mask selects the result ---
+        case Opcode::MIN: cpu.r.ax = selectIf(cpu.r.bx < cpu.r.ax, cpu.r.bx, cpu.r.ax); break;
+        case Opcode::MAX: cpu.r.ax = selectIf(cpu.r.bx > cpu.r.ax, cpu.r.bx, cpu.r.ax); break;
+        case Opcode::CLAMP: {
+            uint16_t atLeast = selectIf(cpu.r.bx > cpu.r.ax, cpu.r.bx, cpu.r.ax);
+            cpu.r.ax = selectIf(cpu.r.cx < atLeast, cpu.r.cx, atLeast);
+            break;
+        }
+        case Opcode::ABS: {
+            uint16_t sign = -(cpu.r.ax >> 15);           // 0xFFFF if negative
+            cpu.r.ax = (cpu.r.ax ^ sign) - sign;
+            break;
+        }
+        case Opcode::SGN:
+            cpu.r.ax = -(cpu.r.ax >> 15) | (cpu.r.ax != 0);
+            break;
+
+        // --- Shifts (logical, by an immediate count) ---
+        case Opcode::SHL: cpu.r.ax = instr.a1 < 16 ? cpu.r.ax << instr.a1 : 0; break;
+        case Opcode::SHR: cpu.r.ax = instr.a1 < 16 ? cpu.r.ax >> instr.a1 : 0; break;
+
+        // --- Comparisons (unsigned, result 0/1 in AX) ---
+        case Opcode::EQ: cpu.r.ax = cpu.r.ax == cpu.r.bx; break;
+        case Opcode::GT: cpu.r.ax = cpu.r.ax >  cpu.r.bx; break;
+        case Opcode::LT: cpu.r.ax = cpu.r.ax <  cpu.r.bx; break;
 
         // --- Flags ---
         case Opcode::STE: cpu.setEqual(true);  break;
@@ -139,23 +255,83 @@ void VM::executeInstruction(const Instruction& instr) {
             else handleError("Invalid POP register");
             break;
 
+        // Depth proven by the compiler: SP stays inside the stack, so no checks.
+        // The high byte's address still wraps at 16 bits, so even code broc did
+        // not produce can never reach past the end of memory.
+        case Opcode::PUSH_NC: {
+            uint8_t* mem = memory.raw();
+            uint16_t val = reg(instr.a1);
+            cpu.r.sp -= 2;
+            mem[cpu.r.sp]                             = val & 0xFF;
+            mem[static_cast<uint16_t>(cpu.r.sp + 1)] = (val >> 8) & 0xFF;
+            break;
+        }
+
+        case Opcode::POP_NC: {
+            const uint8_t* mem = memory.raw();
+            reg(instr.a1) = mem[cpu.r.sp] | (mem[static_cast<uint16_t>(cpu.r.sp + 1)] << 8);
+            cpu.r.sp += 2;
+            break;
+        }
+
+        // --- Memory ---
+        case Opcode::LOAD:
+            cpu.r.ax = memory[instr.a1] | (memory[instr.a1 + 1] << 8);
+            break;
+
+        case Opcode::STORE:
+            memory[instr.a1]     = cpu.r.ax & 0xFF;
+            memory[instr.a1 + 1] = (cpu.r.ax >> 8) & 0xFF;
+            break;
+
+        // Element AX of the array at a1 (CHK runs first unless broc proved the index)
+        case Opcode::LDX: {
+            uint16_t addr = instr.a1 + 2 * cpu.r.ax;
+            cpu.r.ax = memory[addr] | (memory[addr + 1] << 8);
+            break;
+        }
+
+        case Opcode::STX: {
+            uint16_t addr = instr.a1 + 2 * cpu.r.ax;
+            memory[addr]     = cpu.r.bx & 0xFF;
+            memory[addr + 1] = (cpu.r.bx >> 8) & 0xFF;
+            break;
+        }
+
+        case Opcode::CHK:
+            if (cpu.r.ax >= instr.a1) handleError("Array index out of bounds");
+            break;
+
         // --- Print ---
         case Opcode::PRN:
-            std::cout << "Output: " << cpu.r.ax << "\n";
-            std::cout << "HUMAN OUTPUT: " << cpu.r.ax << "\n";
+            *output << "Output: " << cpu.r.ax << "\n";
+            *output << "HUMAN OUTPUT: " << cpu.r.ax << "\n";
+            break;
+
+        // Bytes go out in one write, straight from VM memory
+        case Opcode::PRS:
+            if (instr.a1 + instr.a2 > Memory::SIZE) handleError("String out of memory bounds");
+            output->write(reinterpret_cast<const char*>(memory.raw() + instr.a1), instr.a2);
             break;
 
         // --- Jumps ---
         case Opcode::JMP:
             cpu.r.ip = instr.a1;
+            ++takenBranchCount;
             break;
 
         case Opcode::JZ:
-            if (cpu.r.ax == 0) cpu.r.ip = instr.a1;
+            if (cpu.r.ax == 0) {
+                cpu.r.ip = instr.a1;
+                ++takenBranchCount;
+            }
             break;
 
         case Opcode::JNZ:
-            if (cpu.r.ax != 0) cpu.r.ip = instr.a1;
+            if (cpu.r.ax != 0) {
+                cpu.r.ip = instr.a1;
+                ++takenBranchCount;
+            }
             break;
 
         default:
@@ -181,10 +357,20 @@ uint16_t VM::pop() {
     return val;
 }
 
+uint16_t& VM::reg(uint16_t index) {
+    switch (index & 3) {
+        case 0:  return cpu.r.ax;
+        case 1:  return cpu.r.bx;
+        case 2:  return cpu.r.cx;
+        default: return cpu.r.dx;
+    }
+}
+
 // -----------------------------------------------------------------------------
 // handleError
 // -----------------------------------------------------------------------------
 void VM::handleError(const std::string& msg, bool fatal) {
+    if (fatal && !exitOnError) throw std::runtime_error(msg);
     std::cerr << "VM Error: " << msg << "\n";
     if (fatal) std::exit(EXIT_FAILURE);
 }
@@ -1,10 +1,14 @@
 #pragma once  // Ensures this header is only included once during compilation
 
+#include <array>        // For programs embedded as std::array
 #include <cstdint>      // For fixed-width integer types
 #include <vector>       // For std::vector
 #include <cstdlib>      // For exit()
 #include <cstdio>       // For printf()
 #include <stdexcept>    // For exceptions
+#include <string>       // For profile paths
+#include <memory>       // For the mapped image
+#include <iostream>     // For the output stream (std::cout by default)
 #include "RohitUtils.hpp"
 
 // -----------------------------------------------------------------------------
@@ -53,6 +57,9 @@ private:
 class Memory {
 public:
     static constexpr size_t SIZE = 65536;
+    static constexpr uint16_t DATA_BASE = 0xC000; // Variables live here; code below, stack above
+                                                  // (string data ends just below DATA_BASE)
+    static constexpr uint16_t DATA_END = 0xF000;  // Variables stay below, leaving 4 KB of stack
     std::vector<uint8_t> data;
     Memory() : data(SIZE, 0) {}
 
@@ -76,15 +83,30 @@ enum class Opcode : uint8_t {
     STH   = 0x14, CLH   = 0x15,
     STL   = 0x16, CLL   = 0x17,
 
+    LDX   = 0x18, STX   = 0x19,  // AX = word / word = BX at address a1 + 2 * AX (arrays)
+
     PUSH  = 0x1A, POP   = 0x1B,
+    LOAD  = 0x1C, STORE = 0x1D,  // AX <-> 16-bit word at address a1
+    PUSH_NC = 0x1E, POP_NC = 0x1F, // No overflow/underflow check (depth proven by broc)
 
     ADD   = 0x20, SUB   = 0x21, MUL   = 0x22, DIV   = 0x23,
+    EQ    = 0x24, GT    = 0x25, LT    = 0x26,  // AX = (AX op BX) ? 1 : 0
+    SHL   = 0x27, SHR   = 0x28,                // AX = AX shifted by immediate a1
+    DIV_NC = 0x29,                             // No zero check (divisor proven non-zero by broc)
+
+    // Intrinsics (branchless): MIN/MAX with BX, CLAMP to [BX, CX] (unsigned);
+    // ABS/SGN read AX as signed, SGN gives 1, 0 or 0xFFFF
+    MIN   = 0x2A, MAX   = 0x2B, ABS   = 0x2C, SGN   = 0x2D, CLAMP = 0x2E,
+
+    CHK   = 0x2F,        // Array bounds check: error unless AX < a1
 
     PRN   = 0x30,        // Print AX
 
     JMP   = 0x31,        // Unconditional jump
     JZ    = 0x32,        // Jump if AX == 0
-    JNZ   = 0x33         // Jump if AX != 0
+    JNZ   = 0x33,        // Jump if AX != 0
+
+    PRS   = 0x34         // Print a2 bytes of memory from address a1 (string literals)
 };
 
 // -----------------------------------------------------------------------------
@@ -97,26 +119,211 @@ struct Instruction {
     uint16_t a2 = 0;
 };
 
+// Bytes an instruction takes in memory: the opcode, then a1 and a2 (little-endian)
+// when it has them. 0 for a byte that is not an opcode.
+constexpr uint8_t instructionSize(Opcode op) {
+    switch (op) {
+        case Opcode::NOP: case Opcode::HLT:
+        case Opcode::STE: case Opcode::CLE: case Opcode::STG: case Opcode::CLG:
+        case Opcode::STH: case Opcode::CLH: case Opcode::STL: case Opcode::CLL:
+        case Opcode::ADD: case Opcode::SUB: case Opcode::MUL: case Opcode::DIV:
+        case Opcode::DIV_NC:
+        case Opcode::MIN: case Opcode::MAX: case Opcode::ABS: case Opcode::SGN:
+        case Opcode::CLAMP:
+        case Opcode::EQ: case Opcode::GT: case Opcode::LT:
+        case Opcode::PRN:
+            return 1;
+
+        case Opcode::MOV: case Opcode::MOV_BX: case Opcode::MOV_CX:
+        case Opcode::MOV_DX: case Opcode::MOV_SP:
+        case Opcode::PUSH: case Opcode::POP: case Opcode::PUSH_NC: case Opcode::POP_NC:
+        case Opcode::LOAD: case Opcode::STORE:
+        case Opcode::LDX: case Opcode::STX: case Opcode::CHK:
+        case Opcode::SHL: case Opcode::SHR:
+        case Opcode::JMP: case Opcode::JZ: case Opcode::JNZ:
+            return 3;
+
+        case Opcode::PRS:
+            return 5;
+    }
+    return 0;
+}
+
+// The unchecked variants skip the VM's runtime checks, so they are only safe
+// where broc's range analysis placed them (range.h). checkedForm gives the
+// opcode doing the same with its check; both have the same size.
+constexpr bool isUnchecked(Opcode op) {
+    return op == Opcode::DIV_NC || op == Opcode::PUSH_NC || op == Opcode::POP_NC;
+}
+
+constexpr Opcode checkedForm(Opcode op) {
+    switch (op) {
+        case Opcode::DIV_NC:  return Opcode::DIV;
+        case Opcode::PUSH_NC: return Opcode::PUSH;
+        case Opcode::POP_NC:  return Opcode::POP;
+        default:              return op;
+    }
+}
+
+// Mnemonic of an opcode, as written by the Emitter and read by the assembler
+// (assembler.h); nullptr for a byte that is not an opcode.
+constexpr const char* opcodeName(Opcode op) {
+    switch (op) {
+        case Opcode::NOP:     return "NOP";
+        case Opcode::HLT:     return "HLT";
+        case Opcode::MOV:     return "MOV";
+        case Opcode::MOV_BX:  return "MOV_BX";
+        case Opcode::MOV_CX:  return "MOV_CX";
+        case Opcode::MOV_DX:  return "MOV_DX";
+        case Opcode::MOV_SP:  return "MOV_SP";
+        case Opcode::ADD:     return "ADD";
+        case Opcode::SUB:     return "SUB";
+        case Opcode::MUL:     return "MUL";
+        case Opcode::DIV:     return "DIV";
+        case Opcode::DIV_NC:  return "DIV_NC";
+        case Opcode::MIN:     return "MIN";
+        case Opcode::MAX:     return "MAX";
+        case Opcode::ABS:     return "ABS";
+        case Opcode::SGN:     return "SGN";
+        case Opcode::CLAMP:   return "CLAMP";
+        case Opcode::PUSH:    return "PUSH";
+        case Opcode::POP:     return "POP";
+        case Opcode::PUSH_NC: return "PUSH_NC";
+        case Opcode::POP_NC:  return "POP_NC";
+        case Opcode::LOAD:    return "LOAD";
+        case Opcode::STORE:   return "STORE";
+        case Opcode::LDX:     return "LDX";
+        case Opcode::STX:     return "STX";
+        case Opcode::CHK:     return "CHK";
+        case Opcode::EQ:      return "EQ";
+        case Opcode::GT:      return "GT";
+        case Opcode::LT:      return "LT";
+        case Opcode::SHL:     return "SHL";
+        case Opcode::SHR:     return "SHR";
+        case Opcode::STE:     return "STE";
+        case Opcode::CLE:     return "CLE";
+        case Opcode::STG:     return "STG";
+        case Opcode::CLG:     return "CLG";
+        case Opcode::STH:     return "STH";
+        case Opcode::CLH:     return "CLH";
+        case Opcode::STL:     return "STL";
+        case Opcode::CLL:     return "CLL";
+        case Opcode::PRN:     return "PRN";
+        case Opcode::JMP:     return "JMP";
+        case Opcode::JZ:      return "JZ";
+        case Opcode::JNZ:     return "JNZ";
+        case Opcode::PRS:     return "PRS";
+    }
+    return nullptr;
+}
+
 // -----------------------------------------------------------------------------
 // VM Class
 // -----------------------------------------------------------------------------
 
+namespace BroBin { struct View; }  // brobin.h
+
 class VM {
 public:
     CPU cpu;
     Memory memory;
     uint16_t breakLine = 0;
+    uint64_t instructionCount = 0;  // Dynamic instructions dispatched by execute()
+    uint64_t takenBranchCount = 0;  // JMPs, plus JZ/JNZ that jumped
+    bool profiling = false;         // Count executions per instruction (set before execute)
+
+    // Set before execute: where PRN/PRS output goes, whether the start/halt
+    // banners and the register dump are printed, and how many instructions
+    // may run before the program is stopped with a fault
+    std::ostream* output = &std::cout;
+    bool banners = true;
+    uint64_t instructionLimit = UINT64_MAX;
+
+    // true: an error prints "VM Error: ..." and exits the process (the tools).
+    // false: it throws std::runtime_error, which execute() turns into a false
+    // return with getError() set, so a host embedding the VM (brovm.h) lives on.
+    bool exitOnError = true;
 
     VM() = default;
 
-    void loadProgram(const std::vector<Instruction>& program);
-    void execute();
+    // Takes any contiguous run of instructions, so a program embedded as a
+    // constexpr std::array (prog.cpp) is read from .rodata without a copy first
+    void loadProgram(const Instruction* program, size_t count);
+    void loadProgram(const std::vector<Instruction>& program) { loadProgram(program.data(), program.size()); }
+    template <size_t N>
+    void loadProgram(const std::array<Instruction, N>& program) { loadProgram(program.data(), N); }
+
+    // Copies constant data (string literals) to `address`; call after loadProgram,
+    // as the data must not overlap the code
+    void loadData(uint16_t address, const uint8_t* bytes, size_t size);
+    void loadData(uint16_t address, const std::vector<uint8_t>& bytes) { loadData(address, bytes.data(), bytes.size()); }
+    template <size_t N>
+    void loadData(uint16_t address, const std::array<uint8_t, N>& bytes) { loadData(address, bytes.data(), N); }
+
+    // Runs a .brobin image instead (see brobin.h): the file is mapped read-only
+    // and its code executes in place, only the data section is copied to
+    // memory. Prints an error and returns false if the file cannot be used.
+    bool loadImage(const std::string& path);
+
+    // Runs an image already checked by BroBin::parse that lives in memory
+    // owned by `owner`: one program of a mapped archive (broarchive.h), or a
+    // compiled program (brovm.h). `owner` is kept alive for as long as the VM
+    // may fetch from it, and the code is never copied. False, with getError()
+    // saying why, if the sections do not fit in memory.
+    bool loadImage(const BroBin::View& view, std::shared_ptr<const void> owner);
+
+    // Source map stored in the last loaded image (empty after loadProgram)
+    const std::vector<int>& getSourceMap() const { return imageSourceMap; }
+
+    // Why the last execute() stopped
+    enum class Stop {
+        None,           // Not run yet
+        Halted,         // Reached HLT
+        Limit,          // Dispatched instructionLimit instructions
+        Fault           // Any other error
+    };
+
+    // Runs until HLT; false if the program faulted or hit the limit (only when
+    // !exitOnError), with getStop() saying which
+    bool execute();
+
+    Stop getStop() const { return stop; }
+
+    // Message of the fault that stopped the last execute()
+    const std::string& getError() const { return error; }
+
+    // Writes per-instruction execution and taken-jump counts (format in profile.h).
+    // sourceMap[i] is the statement id of instruction i, as emitted by broc.
+    bool writeProfile(const std::string& path, const std::vector<int>& sourceMap) const;
 
 private:
+    // Instructions are fetched from `code`: the start of `memory` after
+    // loadProgram, the mapped file after loadImage (which `image` keeps alive)
+    const uint8_t* code = nullptr;
+    uint32_t codeSize = 0;
+    std::shared_ptr<const void> image;
+    std::string error;
+    Stop stop = Stop::None;
+
+    std::vector<Instruction> loaded;          // Decoded program, while profiling
+    std::vector<int> indexAt;                 // Byte address → instruction index (-1 = none)
+    std::vector<uint64_t> executedCounts;     // Per instruction, while profiling
+    std::vector<uint64_t> takenCounts;
+    std::vector<int> imageSourceMap;          // From loadImage
+
+    void setCode(const uint8_t* bytes, uint32_t size);
+    void prepareProfile();                    // Fills loaded, indexAt and the counts
+
     Instruction fetchNextInstruction();
     void executeInstruction(const Instruction& instr);
     void handleError(const std::string& msg, bool fatal = true);
-    uint8_t getInstructionSize(Opcode op);
     void push(uint16_t val);
     uint16_t pop();
+    uint16_t& reg(uint16_t index);  // AX, BX, CX, DX by operand number (no range check)
+
+    // a if cond else b, with a mask instead of a branch (used by the intrinsics)
+    static uint16_t selectIf(bool cond, uint16_t a, uint16_t b) {
+        uint16_t mask = -static_cast<uint16_t>(cond);
+        return (a & mask) | (b & ~mask);
+    }
 };
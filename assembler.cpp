@@ -0,0 +1,332 @@
+// =======================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: assembler.cpp
+// Purpose:
+//   - Implements the bytecode text format described in assembler.h.
+//
+// Core Idea:
+//   - assemble() reads one line at a time and leaves label and string operands
+//     as fixups, resolved once the whole file is read (so both may be used
+//     before they are defined).
+//   - disassemble() writes labels and string names back in place of jump
+//     targets and data addresses, so its output assembles to the same bytes.
+// =======================================================================================
+
+#include "assembler.h"
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+    bool isJump(Opcode op) {
+        return op == Opcode::JMP || op == Opcode::JZ || op == Opcode::JNZ;
+    }
+
+    bool isAddress(Opcode op) {
+        return op == Opcode::LOAD || op == Opcode::STORE || op == Opcode::LDX || op == Opcode::STX;
+    }
+
+    std::string hex(uint16_t value) {
+        std::ostringstream out;
+        out << "0x" << std::uppercase << std::hex << std::setw(4) << std::setfill('0') << value;
+        return out.str();
+    }
+
+    // Opcode by mnemonic, in any case; false if there is none
+    bool findOpcode(std::string name, Opcode& op) {
+        for (char& c : name) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        for (int byte = 0; byte < 256; ++byte) {
+            const char* known = opcodeName(static_cast<Opcode>(byte));
+            if (known && name == known) {
+                op = static_cast<Opcode>(byte);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parseNumber(const std::string& word, uint16_t& value) {
+        bool isHex = word.size() > 2 && word[0] == '0' && (word[1] == 'x' || word[1] == 'X');
+        size_t start = isHex ? 2 : 0;
+        if (word.empty() || word.size() - start > 8) return false;
+
+        unsigned long result = 0;
+        for (size_t i = start; i < word.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(word[i]);
+            if (isHex ? !std::isxdigit(c) : !std::isdigit(c)) return false;
+            result = result * (isHex ? 16 : 10) + (std::isdigit(c) ? c - '0' : std::tolower(c) - 'a' + 10);
+        }
+        if (result > 0xFFFF) return false;
+        value = static_cast<uint16_t>(result);
+        return true;
+    }
+
+    bool isName(const std::string& word) {
+        return !word.empty() && (std::isalpha(static_cast<unsigned char>(word[0])) || word[0] == '_' || word[0] == '.');
+    }
+
+    // -----------------------------------------------------------------------------------
+    // LineReader: tokens of one line; a `;` outside a string ends it
+    // -----------------------------------------------------------------------------------
+    struct LineReader {
+        const std::string& text;
+        size_t pos = 0;
+
+        explicit LineReader(const std::string& line) : text(line) {}
+
+        void skipSpace() {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) ++pos;
+        }
+
+        bool atEnd() {
+            skipSpace();
+            return pos >= text.size() || text[pos] == ';';
+        }
+
+        bool accept(char c) {
+            skipSpace();
+            if (pos < text.size() && text[pos] == c) {
+                ++pos;
+                return true;
+            }
+            return false;
+        }
+
+        // Letters, digits, `_` and `.`; empty if the next character is none of them
+        std::string word() {
+            skipSpace();
+            size_t start = pos;
+            while (pos < text.size() && (std::isalnum(static_cast<unsigned char>(text[pos])) ||
+                                         text[pos] == '_' || text[pos] == '.'))
+                ++pos;
+            return text.substr(start, pos - start);
+        }
+
+        // A "..." literal with its escapes applied; false if it is malformed
+        bool quoted(std::string& out) {
+            if (!accept('"')) return false;
+            out.clear();
+            while (pos < text.size()) {
+                char c = text[pos++];
+                if (c == '"') return true;
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (pos >= text.size()) return false;
+                char escaped = text[pos++];
+                if (escaped == 'n') out += '\n';
+                else if (escaped == 't') out += '\t';
+                else if (escaped == '\\' || escaped == '"') out += escaped;
+                else if (escaped == 'x' && pos + 2 <= text.size() &&
+                         std::isxdigit(static_cast<unsigned char>(text[pos])) &&
+                         std::isxdigit(static_cast<unsigned char>(text[pos + 1]))) {
+                    out += static_cast<char>(std::stoi(text.substr(pos, 2), nullptr, 16));
+                    pos += 2;
+                }
+                else return false;
+            }
+            return false;
+        }
+    };
+
+    // A label or string name used before the end of the file
+    struct Fixup {
+        size_t instruction;
+        std::string name;
+        int line;
+    };
+
+    std::string escape(const uint8_t* bytes, size_t size) {
+        std::string out;
+        for (size_t i = 0; i < size; ++i) {
+            uint8_t c = bytes[i];
+            if (c == '\n') out += "\\n";
+            else if (c == '\t') out += "\\t";
+            else if (c == '\\' || c == '"') out += std::string("\\") + static_cast<char>(c);
+            else if (c >= 0x20 && c < 0x7F) out += static_cast<char>(c);
+            else out += "\\x" + hex(c).substr(4);
+        }
+        return out;
+    }
+
+} // namespace
+
+// =======================================================================================
+// Function: assemble
+// =======================================================================================
+bool Assembler::assemble(const std::string& source, Assembly& out, std::string& error) {
+    out = Assembly();
+    std::unordered_map<std::string, size_t> labels;
+    std::unordered_map<std::string, std::pair<size_t, size_t>> strings;  // Offset, length
+    std::vector<Fixup> labelFixups, stringFixups;
+    bool dataAddressSet = false;
+
+    std::istringstream in(source);
+    std::string text;
+    int line = 0;
+    auto fail = [&](const std::string& message) {
+        error = "line " + std::to_string(line) + ": " + message;
+        return false;
+    };
+
+    while (std::getline(in, text)) {
+        ++line;
+        LineReader reader(text);
+        std::string word = reader.word();
+
+        // --- Labels: `name:`, any number of them before the instruction ---
+        while (!word.empty() && reader.accept(':')) {
+            if (!isName(word)) return fail("bad label '" + word + "'");
+            if (!labels.emplace(word, out.program.size()).second) return fail("label '" + word + "' defined twice");
+            word = reader.word();
+        }
+
+        if (word.empty()) {
+            if (!reader.atEnd()) return fail(std::string("unexpected '") + text[reader.pos] + "'");
+            continue;
+        }
+
+        if (word == ".string") {
+            std::string name = reader.word(), bytes;
+            if (!isName(name)) return fail(".string needs a name");
+            if (!reader.quoted(bytes)) return fail("malformed string literal");
+            if (!strings.emplace(name, std::make_pair(out.data.size(), bytes.size())).second)
+                return fail("string '" + name + "' defined twice");
+            out.data.insert(out.data.end(), bytes.begin(), bytes.end());
+        } else if (word == ".data") {
+            if (!parseNumber(reader.word(), out.dataAddress)) return fail(".data needs an address");
+            dataAddressSet = true;
+        } else {
+            Opcode op;
+            if (!findOpcode(word, op)) return fail("unknown instruction '" + word + "'");
+            Instruction instr{op};
+
+            std::vector<std::string> operands;
+            if (!reader.atEnd()) {
+                do operands.push_back(reader.word());
+                while (reader.accept(','));
+            }
+
+            size_t wanted = instructionSize(op) == 1 ? 0 : instructionSize(op) == 3 ? 1 : 2;
+            bool named = operands.size() == 1 && isName(operands[0]);
+            if (named && isJump(op)) {
+                labelFixups.push_back({out.program.size(), operands[0], line});
+            } else if (named && op == Opcode::PRS) {
+                stringFixups.push_back({out.program.size(), operands[0], line});
+            } else {
+                if (operands.size() != wanted)
+                    return fail(word + " takes " + std::to_string(wanted) + " operand(s)");
+                if (wanted >= 1 && !parseNumber(operands[0], instr.a1)) return fail("bad operand '" + operands[0] + "'");
+                if (wanted == 2 && !parseNumber(operands[1], instr.a2)) return fail("bad operand '" + operands[1] + "'");
+            }
+            out.program.push_back(instr);
+        }
+
+        if (!reader.atEnd()) return fail("unexpected text after " + word);
+    }
+
+    // --- Resolve names now that every label and string is known ---
+    for (const Fixup& fixup : labelFixups) {
+        line = fixup.line;
+        auto it = labels.find(fixup.name);
+        if (it == labels.end()) return fail("undefined label '" + fixup.name + "'");
+        out.program[fixup.instruction].a1 = static_cast<uint16_t>(it->second);
+    }
+
+    if (!dataAddressSet) {
+        if (out.data.size() > Memory::DATA_BASE) {
+            error = "data section larger than memory";
+            return false;
+        }
+        out.dataAddress = static_cast<uint16_t>(Memory::DATA_BASE - out.data.size());
+    }
+    if (out.dataAddress + out.data.size() > Memory::SIZE) {
+        error = "data section does not fit in memory";
+        return false;
+    }
+    for (const Fixup& fixup : stringFixups) {
+        line = fixup.line;
+        auto it = strings.find(fixup.name);
+        if (it == strings.end()) return fail("undefined string '" + fixup.name + "'");
+        out.program[fixup.instruction].a1 = static_cast<uint16_t>(out.dataAddress + it->second.first);
+        out.program[fixup.instruction].a2 = static_cast<uint16_t>(it->second.second);
+    }
+    return true;
+}
+
+// =======================================================================================
+// Function: disassemble
+// =======================================================================================
+std::string Assembler::disassemble(const Assembly& in) {
+    const std::vector<Instruction>& program = in.program;
+    const size_t dataSize = in.data.size();
+
+    // --- Labels at every jump target ---
+    std::vector<bool> labelAt(program.size() + 1, false);
+    for (const auto& instr : program) {
+        if (isJump(instr.op) && instr.a1 <= program.size()) labelAt[instr.a1] = true;
+    }
+
+    // --- Split the data where the printed strings start and end ---
+    std::set<size_t> cuts = {0, dataSize};
+    for (const auto& instr : program) {
+        if (instr.op == Opcode::PRS && instr.a1 >= in.dataAddress &&
+            instr.a1 + size_t(instr.a2) <= in.dataAddress + dataSize) {
+            cuts.insert(instr.a1 - in.dataAddress);
+            cuts.insert(instr.a1 - in.dataAddress + instr.a2);
+        }
+    }
+    std::unordered_map<size_t, std::pair<std::string, size_t>> chunks;  // Offset → name, length
+
+    std::ostringstream out;
+    out << "; " << program.size() << " instructions, " << dataSize << " bytes of data\n";
+    if (dataSize > 0 && in.dataAddress != Memory::DATA_BASE - dataSize) out << ".data " << hex(in.dataAddress) << "\n";
+    for (auto it = cuts.begin(); it != cuts.end() && std::next(it) != cuts.end(); ++it) {
+        std::string name = "s" + std::to_string(chunks.size());
+        size_t length = *std::next(it) - *it;
+        chunks[*it] = {name, length};
+        out << ".string " << name << " \"" << escape(in.data.data() + *it, length) << "\"\n";
+    }
+    out << "\n";
+
+    // --- Instructions ---
+    bool mapped = in.sourceMap.size() == program.size();
+    for (size_t i = 0; i < program.size(); ++i) {
+        const Instruction& instr = program[i];
+        if (labelAt[i]) out << "L" << i << ":\n";
+
+        const char* name = opcodeName(instr.op);
+        if (!name) {
+            out << "    ; unknown opcode " << static_cast<int>(instr.op) << "\n";
+            continue;
+        }
+
+        std::string text = std::string("    ") + name;
+        uint8_t size = instructionSize(instr.op);
+        if (isJump(instr.op) && instr.a1 <= program.size()) {
+            text += " L" + std::to_string(instr.a1);
+        } else if (instr.op == Opcode::PRS) {
+            auto chunk = instr.a1 >= in.dataAddress ? chunks.find(instr.a1 - in.dataAddress) : chunks.end();
+            if (chunk != chunks.end() && chunk->second.second == instr.a2) text += " " + chunk->second.first;
+            else text += " " + hex(instr.a1) + ", " + std::to_string(instr.a2);
+        } else if (size >= 3) {
+            text += " " + (isAddress(instr.op) ? hex(instr.a1) : std::to_string(instr.a1));
+        }
+
+        if (mapped && in.sourceMap[i] >= 0 && (i == 0 || in.sourceMap[i] != in.sourceMap[i - 1])) {
+            text.resize(std::max<size_t>(text.size() + 1, 28), ' ');
+            text += "; statement " + std::to_string(in.sourceMap[i]);
+        }
+        out << text << "\n";
+    }
+    if (labelAt[program.size()]) out << "L" << program.size() << ":\n";
+    return out.str();
+}
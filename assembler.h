@@ -0,0 +1,72 @@
+// =======================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: assembler.h
+// Purpose:
+//   - A text form of RohitVM bytecode, so VM code can be written by hand
+//     (broasm.cpp) and compiled code can be read back (brodis.cpp).
+//
+// Format (one instruction per line, `;` starts a comment):
+//   .string hello "Hi\n"      ; Adds bytes to the data section under a name
+//   loop:                     ; A label: the index of the next instruction
+//       LOAD 0xC000           ; Mnemonics as in opcodeName (RohitVM.hpp)
+//       JZ done               ; Jumps take a label (or an instruction index)
+//       PRS hello             ; PRS takes a string name (or an address and a length)
+//       JMP loop
+//   done:
+//       HLT
+//
+//   - Numbers are decimal or 0x hex, 0 to 65535.
+//   - Strings accept \n, \t, \\, \" and \xHH.
+//   - The data section ends just below Memory::DATA_BASE, where Codegen puts
+//     it, unless `.data ADDRESS` says where it starts.
+// =======================================================================================
+
+#pragma once
+
+#include "RohitVM.hpp"
+#include <string>
+#include <vector>
+
+// =======================================================================================
+// Struct: Assembly
+// Purpose: A program with its data section, jumps by instruction index (as Codegen
+//          produces them, before VM::loadProgram turns them into byte addresses)
+// =======================================================================================
+struct Assembly {
+    std::vector<Instruction> program;
+    uint16_t dataAddress = Memory::DATA_BASE;
+    std::vector<uint8_t> data;
+    std::vector<int> sourceMap;     // Statement per instruction; only read by disassemble
+};
+
+// =======================================================================================
+// Class: Assembler
+// Role:
+//   - Static utility class converting between the text form and an Assembly.
+//
+// Usage:
+//   Assembly out;
+//   std::string error;
+//   if (!Assembler::assemble(text, out, error)) std::cerr << error << "\n";
+//   std::string text = Assembler::disassemble(out);
+// =======================================================================================
+class Assembler {
+public:
+    // -----------------------------------------------------------------------------------
+    // Function: assemble
+    // Returns:
+    //   - true on success; otherwise false, with `error` naming the line and the problem
+    // -----------------------------------------------------------------------------------
+    static bool assemble(const std::string& source, Assembly& out, std::string& error);
+
+    // -----------------------------------------------------------------------------------
+    // Function: disassemble
+    // Description:
+    //   - Text that assembles back into the same program and data: jump targets
+    //     become labels L<index>, the strings PRS prints become `.string` names,
+    //     and a comment marks where each source statement starts
+    // -----------------------------------------------------------------------------------
+    static std::string disassemble(const Assembly& in);
+};
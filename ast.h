@@ -20,7 +20,7 @@
 // Purpose: Represents binary operators in Brolang.
 // Why we use it:
 //   - Helps the parser and code generator identify which operation to perform.
-//   - Covers arithmetic and comparison operators.
+//   - Covers arithmetic, comparison and logical operators.
 // --------------------------------------------------------------
 enum class BinaryOp {
     Add,
@@ -29,9 +29,73 @@ enum class BinaryOp {
     Div,
     Equal,    // Used for comparisons like a == b
     Greater,  // Used in conditionals like a > b
-    Less      // Used in conditionals like a < b
+    Less,     // Used in conditionals like a < b
+    And,      // a && b: b is evaluated only if a is non-zero; result 0/1
+    Or,       // a || b: b is evaluated only if a is zero; result 0/1
+    Shl,      // Produced by the optimizer only: a * 2^n → a << n (right is a constant)
+    Shr       // Produced by the optimizer only: a / 2^n → a >> n (right is a constant)
 };
 
+// --------------------------------------------------------------
+// Utility: Convert a BinaryOp to its source-level symbol
+// --------------------------------------------------------------
+inline std::string binaryOpToString(BinaryOp op) {
+    switch (op) {
+        case BinaryOp::Add:     return "+";
+        case BinaryOp::Sub:     return "-";
+        case BinaryOp::Mul:     return "*";
+        case BinaryOp::Div:     return "/";
+        case BinaryOp::Equal:   return "==";
+        case BinaryOp::Greater: return ">";
+        case BinaryOp::Less:    return "<";
+        case BinaryOp::And:     return "&&";
+        case BinaryOp::Or:      return "||";
+        case BinaryOp::Shl:     return "<<";
+        case BinaryOp::Shr:     return ">>";
+        default:                return "?";
+    }
+}
+
+// --------------------------------------------------------------
+// Enum: Intrinsic
+// Purpose: Builtin functions like `minbro(a, b)`; each one is a
+//          single VM instruction (see Codegen::genExpression).
+// Semantics (16-bit values):
+//   - minbro, maxbro, clampbro(x, lo, hi): unsigned, like < and >
+//   - absbro, signbro: read the value as signed two's complement,
+//     so absbro(0 - 5) is 5 and signbro(0 - 5) is 65535 (-1)
+// --------------------------------------------------------------
+enum class Intrinsic {
+    Min,    // minbro(a, b)
+    Max,    // maxbro(a, b)
+    Abs,    // absbro(a)
+    Clamp,  // clampbro(x, lo, hi) = minbro(maxbro(x, lo), hi)
+    Sign    // signbro(a): 0, 1 or 65535
+};
+
+// --------------------------------------------------------------
+// Utility: Source-level name and argument count of an Intrinsic
+// --------------------------------------------------------------
+inline std::string intrinsicName(Intrinsic fn) {
+    switch (fn) {
+        case Intrinsic::Min:   return "minbro";
+        case Intrinsic::Max:   return "maxbro";
+        case Intrinsic::Abs:   return "absbro";
+        case Intrinsic::Clamp: return "clampbro";
+        case Intrinsic::Sign:  return "signbro";
+        default:               return "?";
+    }
+}
+
+inline size_t intrinsicArity(Intrinsic fn) {
+    switch (fn) {
+        case Intrinsic::Abs:
+        case Intrinsic::Sign:  return 1;
+        case Intrinsic::Clamp: return 3;
+        default:               return 2;
+    }
+}
+
 // Forward declarations
 struct Expr;
 struct Statement;
@@ -76,20 +140,58 @@ struct VariableExpr : public Expr {
 //   - op: the operation (e.g., Add, Sub, Greater)
 //   - left: the left operand
 //   - right: the right operand
+//   - divisorNonZero: set by range analysis (range.h) when a Div can never
+//     trap at this position; copies start unproven
 // --------------------------------------------------------------
 struct BinaryExpr : public Expr {
     BinaryOp op;
     ExprPtr left;
     ExprPtr right;
+    bool divisorNonZero = false;
     BinaryExpr(BinaryOp op, ExprPtr left, ExprPtr right)
         : op(op), left(left), right(right) {}
 };
 
+// --------------------------------------------------------------
+// Struct: CallExpr
+// Purpose: Represents intrinsic calls like `maxbro(a, b + 1)`.
+// Members:
+//   - fn: which intrinsic
+//   - args: exactly intrinsicArity(fn) operands, evaluated left to right
+// --------------------------------------------------------------
+struct CallExpr : public Expr {
+    Intrinsic fn;
+    std::vector<ExprPtr> args;
+    CallExpr(Intrinsic fn, std::vector<ExprPtr> args)
+        : fn(fn), args(std::move(args)) {}
+};
+
+// --------------------------------------------------------------
+// Struct: IndexExpr
+// Purpose: Represents an array element read like `arr[i + 1]`.
+// Members:
+//   - array: the array name, declared earlier with `letbro arr[N];`
+//   - size: N, copied from the declaration
+//   - index: the element number; reading outside 0..N-1 traps
+//   - inBounds: set by range analysis (range.h) when the index can never be
+//     out of bounds at this position; copies start unproven
+// --------------------------------------------------------------
+struct IndexExpr : public Expr {
+    std::string array;
+    int size;
+    ExprPtr index;
+    bool inBounds = false;
+    IndexExpr(const std::string& array, int size, ExprPtr index)
+        : array(array), size(size), index(index) {}
+};
+
 // --------------------------------------------------------------
 // Base Struct: Statement
 // Purpose: Abstract base for all types of statements.
 // --------------------------------------------------------------
 struct Statement {
+    int id = -1;  // Source statement number from the parser (-1 = made by the optimizer);
+                  // copies keep it, so profiles can be mapped back to the source
     virtual ~Statement() = default;
 };
 
@@ -107,6 +209,38 @@ struct LetStatement : public Statement {
         : name(name), value(value) {}
 };
 
+// --------------------------------------------------------------
+// Struct: ArrayDeclStatement
+// Purpose: Represents array declarations like `letbro arr[10];`
+// Members:
+//   - name: the array being declared
+//   - size: number of elements (every element starts at 0)
+// --------------------------------------------------------------
+struct ArrayDeclStatement : public Statement {
+    std::string name;
+    int size;
+    ArrayDeclStatement(const std::string& name, int size)
+        : name(name), size(size) {}
+};
+
+// --------------------------------------------------------------
+// Struct: ArrayStoreStatement
+// Purpose: Represents element writes like `letbro arr[i] = 5;`
+// Members:
+//   - array, size, inBounds: as in IndexExpr
+//   - index: the element number, evaluated after `value`
+//   - value: the expression assigned to the element
+// --------------------------------------------------------------
+struct ArrayStoreStatement : public Statement {
+    std::string array;
+    int size;
+    ExprPtr index;
+    ExprPtr value;
+    bool inBounds = false;
+    ArrayStoreStatement(const std::string& array, int size, ExprPtr index, ExprPtr value)
+        : array(array), size(size), index(index), value(value) {}
+};
+
 // --------------------------------------------------------------
 // Struct: PrintStatement
 // Purpose: Represents `printbro(expr);` statements for output.
@@ -116,6 +250,16 @@ struct PrintStatement : public Statement {
     PrintStatement(ExprPtr expr) : expr(expr) {}
 };
 
+// --------------------------------------------------------------
+// Struct: PrintStringStatement
+// Purpose: Represents `printbro("text");`, which writes the bytes
+//          of a string literal as they are (no newline added).
+// --------------------------------------------------------------
+struct PrintStringStatement : public Statement {
+    std::string text;  // Escapes already decoded by the Lexer
+    PrintStringStatement(const std::string& text) : text(text) {}
+};
+
 // --------------------------------------------------------------
 // Struct: IfStatement
 // Purpose: Represents conditional blocks:
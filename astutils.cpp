@@ -0,0 +1,357 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: astutils.cpp
+// Purpose:
+//   - Implements the AST walking helpers declared in astutils.h.
+// =====================================================================================
+
+#include "astutils.h"
+#include "codegen_templates.h"
+
+namespace {
+
+    // Instructions emitOperator adds around a computed right operand: the
+    // PUSH of the left one, then the brosuper sequence (4 if it has none)
+    int stackOperatorCost(Opcode op) {
+        for (const auto& entry : STACK_TEMPLATES)
+            if (entry.op == op) return 1 + entry.length;
+        return 5;
+    }
+
+    Opcode opcodeOf(BinaryOp op) {
+        switch (op) {
+            case BinaryOp::Add:     return Opcode::ADD;
+            case BinaryOp::Sub:     return Opcode::SUB;
+            case BinaryOp::Mul:     return Opcode::MUL;
+            case BinaryOp::Div:     return Opcode::DIV;
+            case BinaryOp::Equal:   return Opcode::EQ;
+            case BinaryOp::Greater: return Opcode::GT;
+            default:                return Opcode::LT;
+        }
+    }
+
+    // True if `expr` reads a variable that is not in `declared`
+    bool readsUndeclared(const ExprPtr& expr, const std::set<std::string>& declared) {
+        if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr))
+            return !declared.count(var->name);
+        if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr))
+            return readsUndeclared(bin->left, declared) || readsUndeclared(bin->right, declared);
+        if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+            for (const auto& arg : call->args)
+                if (readsUndeclared(arg, declared)) return true;
+        }
+        if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr))
+            return readsUndeclared(idx->index, declared);
+        return false;
+    }
+
+} // namespace
+
+namespace AstUtils {
+
+    // ---------------------------------------------------------------------------------
+    // collectAssigned: gather the names written by letbro statements
+    // ---------------------------------------------------------------------------------
+    void collectAssigned(const std::vector<StmtPtr>& stmts, std::set<std::string>& out) {
+        for (const auto& stmt : stmts) {
+            if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+                out.insert(let->name);
+            } else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+                collectAssigned(ifs->thenBranch, out);
+                collectAssigned(ifs->elseBranch, out);
+            } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+                collectAssigned(wh->body, out);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------
+    // countAssigned: number of letbro statements per variable
+    // ---------------------------------------------------------------------------------
+    void countAssigned(const std::vector<StmtPtr>& stmts, std::map<std::string, int>& out) {
+        for (const auto& stmt : stmts) {
+            if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+                out[let->name]++;
+            } else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+                countAssigned(ifs->thenBranch, out);
+                countAssigned(ifs->elseBranch, out);
+            } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+                countAssigned(wh->body, out);
+            }
+        }
+    }
+
+    // ---------------------------------------------------------------------------------
+    // readsBeforeDeclared: a read that Codegen would turn into "Unknown variable"
+    // ---------------------------------------------------------------------------------
+    bool readsBeforeDeclared(const std::vector<StmtPtr>& stmts, std::set<std::string>& declared) {
+        for (const auto& stmt : stmts) {
+            if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+                if (readsUndeclared(let->value, declared)) return true;
+                declared.insert(let->name);
+            } else if (auto print = std::dynamic_pointer_cast<PrintStatement>(stmt)) {
+                if (readsUndeclared(print->expr, declared)) return true;
+            } else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt)) {
+                if (readsUndeclared(store->value, declared) || readsUndeclared(store->index, declared))
+                    return true;
+            } else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+                if (readsUndeclared(ifs->condition, declared)) return true;
+                if (readsBeforeDeclared(ifs->thenBranch, declared)) return true;
+                if (readsBeforeDeclared(ifs->elseBranch, declared)) return true;
+            } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+                if (readsUndeclared(wh->condition, declared)) return true;
+                if (readsBeforeDeclared(wh->body, declared)) return true;
+            }
+        }
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // matchIncrement: the shape of a loop counter update
+    // ---------------------------------------------------------------------------------
+    bool matchIncrement(const StmtPtr& stmt, std::string& name, uint16_t& step) {
+        auto let = std::dynamic_pointer_cast<LetStatement>(stmt);
+        if (!let) return false;
+
+        auto bin = std::dynamic_pointer_cast<BinaryExpr>(let->value);
+        if (!bin || (bin->op != BinaryOp::Add && bin->op != BinaryOp::Sub)) return false;
+
+        auto lvar = std::dynamic_pointer_cast<VariableExpr>(bin->left);
+        auto rvar = std::dynamic_pointer_cast<VariableExpr>(bin->right);
+        auto lnum = std::dynamic_pointer_cast<NumberExpr>(bin->left);
+        auto rnum = std::dynamic_pointer_cast<NumberExpr>(bin->right);
+
+        if (lvar && lvar->name == let->name && rnum) {
+            step = static_cast<uint16_t>(rnum->value);
+            if (bin->op == BinaryOp::Sub) step = static_cast<uint16_t>(-step);
+        } else if (bin->op == BinaryOp::Add && rvar && rvar->name == let->name && lnum) {
+            step = static_cast<uint16_t>(lnum->value);
+        } else {
+            return false;
+        }
+
+        name = let->name;
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // usesAny: does the expression read one of the given variables?
+    // ---------------------------------------------------------------------------------
+    bool usesAny(const ExprPtr& expr, const std::set<std::string>& names) {
+        if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr))
+            return names.count(var->name) > 0;
+        if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr))
+            return usesAny(bin->left, names) || usesAny(bin->right, names);
+        if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+            for (const auto& arg : call->args)
+                if (usesAny(arg, names)) return true;
+        }
+        if (std::dynamic_pointer_cast<IndexExpr>(expr))
+            return true;  // Array contents are not tracked: assume they changed
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // mayTrap: DIV when the divisor might be zero, and every array access
+    // ---------------------------------------------------------------------------------
+    bool mayTrap(const ExprPtr& expr) {
+        if (std::dynamic_pointer_cast<IndexExpr>(expr)) return true;
+
+        if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+            for (const auto& arg : call->args)
+                if (mayTrap(arg)) return true;
+            return false;
+        }
+
+        auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr);
+        if (!bin) return false;
+
+        if (bin->op == BinaryOp::Div) {
+            auto num = std::dynamic_pointer_cast<NumberExpr>(bin->right);
+            if (!num || static_cast<uint16_t>(num->value) == 0) return true;
+        }
+        return mayTrap(bin->left) || mayTrap(bin->right);
+    }
+
+    // ---------------------------------------------------------------------------------
+    // readsArray: is there an IndexExpr anywhere in the expression?
+    // ---------------------------------------------------------------------------------
+    bool readsArray(const ExprPtr& expr) {
+        if (std::dynamic_pointer_cast<IndexExpr>(expr)) return true;
+        if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr))
+            return readsArray(bin->left) || readsArray(bin->right);
+        if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+            for (const auto& arg : call->args)
+                if (readsArray(arg)) return true;
+        }
+        return false;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // exprKey: prefix-notation string used to compare expressions structurally
+    // ---------------------------------------------------------------------------------
+    std::string exprKey(const ExprPtr& expr) {
+        if (auto num = std::dynamic_pointer_cast<NumberExpr>(expr))
+            return std::to_string(static_cast<uint16_t>(num->value));
+        if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr))
+            return var->name;
+        if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+            return "(" + binaryOpToString(bin->op) + " " +
+                   exprKey(bin->left) + " " + exprKey(bin->right) + ")";
+        }
+        if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+            std::string key = "(" + intrinsicName(call->fn);
+            for (const auto& arg : call->args) key += " " + exprKey(arg);
+            return key + ")";
+        }
+        if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr))
+            return "(" + idx->array + "[] " + exprKey(idx->index) + ")";
+        return "?";
+    }
+
+    // ---------------------------------------------------------------------------------
+    // estimateCost: mirror of the lowering templates in Codegen::genExpression
+    // ---------------------------------------------------------------------------------
+    int estimateCost(const ExprPtr& expr) {
+        if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr))
+            return estimateCost(idx->index) + 2;  // CHK, LDX
+
+        if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+            if (call->args.empty()) return 1;
+            if (call->fn == Intrinsic::Min || call->fn == Intrinsic::Max) {
+                // Lowered like a binary operator
+                if (std::dynamic_pointer_cast<NumberExpr>(call->args[1]))
+                    return estimateCost(call->args[0]) + 2;  // MOV_BX imm, op
+                return estimateCost(call->args[0]) + estimateCost(call->args[1]) +
+                       stackOperatorCost(call->fn == Intrinsic::Min ? Opcode::MIN : Opcode::MAX);
+            }
+            int total = estimateCost(call->args[0]) + 1;  // First operand, then the opcode
+            bool stacked = false;
+            for (size_t k = 1; k < call->args.size(); ++k) {
+                if (std::dynamic_pointer_cast<NumberExpr>(call->args[k])) {
+                    total += 1;  // MOV_BX/MOV_CX imm
+                } else {
+                    total += estimateCost(call->args[k]) + 2;  // PUSH, POP
+                    stacked = true;
+                }
+            }
+            return total + (stacked ? 2 : 0);  // PUSH/POP of the first operand
+        }
+
+        auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr);
+        if (!bin) return 1;  // MOV or LOAD
+
+        if (bin->op == BinaryOp::Shl || bin->op == BinaryOp::Shr)
+            return estimateCost(bin->left) + 1;  // SHL/SHR imm
+        if (bin->op == BinaryOp::And || bin->op == BinaryOp::Or)
+            return estimateCost(bin->left) + estimateCost(bin->right) + 5;  // JZ/JNZ, JZ, MOV 1, JMP, MOV 0
+        if (std::dynamic_pointer_cast<NumberExpr>(bin->right))
+            return estimateCost(bin->left) + 2;  // MOV_BX imm, op
+        return estimateCost(bin->left) + estimateCost(bin->right) + stackOperatorCost(opcodeOf(bin->op));
+    }
+
+    // ---------------------------------------------------------------------------------
+    // estimateBlockCost: statement templates from Codegen::genStatement
+    // ---------------------------------------------------------------------------------
+    int estimateBlockCost(const std::vector<StmtPtr>& stmts) {
+        int total = 0;
+        for (const auto& stmt : stmts) {
+            if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+                total += estimateCost(let->value) + 1;  // STORE
+            } else if (auto print = std::dynamic_pointer_cast<PrintStatement>(stmt)) {
+                total += estimateCost(print->expr) + 1;  // PRN
+            } else if (std::dynamic_pointer_cast<PrintStringStatement>(stmt)) {
+                total += 2;  // PRS (5 bytes); the text is data
+            } else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt)) {
+                total += estimateCost(store->index) + 3;  // CHK, MOV_BX imm / POP, STX
+                if (!std::dynamic_pointer_cast<NumberExpr>(store->value))
+                    total += estimateCost(store->value);  // ... and a PUSH
+            } else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+                total += estimateCost(ifs->condition) + 2;  // JZ, JMP
+                total += estimateBlockCost(ifs->thenBranch) + estimateBlockCost(ifs->elseBranch);
+            } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+                total += estimateCost(wh->condition) + 2;  // JZ, JMP
+                total += estimateBlockCost(wh->body);
+            }
+        }
+        return total;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // cloneExpr / cloneStmt / cloneBlock: deep copies of AST sub-trees
+    // ---------------------------------------------------------------------------------
+    ExprPtr cloneExpr(const ExprPtr& expr) {
+        if (auto num = std::dynamic_pointer_cast<NumberExpr>(expr))
+            return std::make_shared<NumberExpr>(num->value);
+        if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr))
+            return std::make_shared<VariableExpr>(var->name);
+        if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr))
+            return std::make_shared<BinaryExpr>(bin->op, cloneExpr(bin->left), cloneExpr(bin->right));
+        if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+            std::vector<ExprPtr> args;
+            for (const auto& arg : call->args) args.push_back(cloneExpr(arg));
+            return std::make_shared<CallExpr>(call->fn, args);
+        }
+        if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr))
+            return std::make_shared<IndexExpr>(idx->array, idx->size, cloneExpr(idx->index));
+        return expr;
+    }
+
+    StmtPtr cloneStmt(const StmtPtr& stmt) {
+        StmtPtr copy = stmt;
+        if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt))
+            copy = std::make_shared<LetStatement>(let->name, cloneExpr(let->value));
+        else if (auto print = std::dynamic_pointer_cast<PrintStatement>(stmt))
+            copy = std::make_shared<PrintStatement>(cloneExpr(print->expr));
+        else if (auto text = std::dynamic_pointer_cast<PrintStringStatement>(stmt))
+            copy = std::make_shared<PrintStringStatement>(text->text);
+        else if (auto decl = std::dynamic_pointer_cast<ArrayDeclStatement>(stmt))
+            copy = std::make_shared<ArrayDeclStatement>(decl->name, decl->size);
+        else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt))
+            copy = std::make_shared<ArrayStoreStatement>(store->array, store->size,
+                                                         cloneExpr(store->index),
+                                                         cloneExpr(store->value));
+        else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt))
+            copy = std::make_shared<IfStatement>(cloneExpr(ifs->condition),
+                                                 cloneBlock(ifs->thenBranch),
+                                                 cloneBlock(ifs->elseBranch));
+        else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt))
+            copy = std::make_shared<WhileStatement>(cloneExpr(wh->condition), cloneBlock(wh->body));
+
+        if (copy && copy != stmt) copy->id = stmt->id;  // Copies count toward the same source statement
+        return copy;
+    }
+
+    std::vector<StmtPtr> cloneBlock(const std::vector<StmtPtr>& stmts) {
+        std::vector<StmtPtr> out;
+        out.reserve(stmts.size());
+        for (const auto& stmt : stmts) out.push_back(cloneStmt(stmt));
+        return out;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // forEachExpr: visit every expression slot, recursing into nested blocks
+    // ---------------------------------------------------------------------------------
+    void forEachExpr(std::vector<StmtPtr>& stmts, const std::function<void(ExprPtr&)>& fn) {
+        for (auto& stmt : stmts) {
+            if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+                fn(let->value);
+            } else if (auto print = std::dynamic_pointer_cast<PrintStatement>(stmt)) {
+                fn(print->expr);
+            } else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt)) {
+                fn(store->value);
+                fn(store->index);
+            } else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+                fn(ifs->condition);
+                forEachExpr(ifs->thenBranch, fn);
+                forEachExpr(ifs->elseBranch, fn);
+            } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+                fn(wh->condition);
+                forEachExpr(wh->body, fn);
+            }
+        }
+    }
+
+} // namespace AstUtils
@@ -0,0 +1,78 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: astutils.h
+// Purpose:
+//   - Small helpers shared by the AST optimization passes (see optimizer.h).
+//   - Answers questions like "which variables does this block assign?" or
+//     "are these two expressions the same computation?" without every pass
+//     re-implementing its own tree walk.
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+
+namespace AstUtils {
+
+    // Adds every variable written by a `letbro` anywhere in `stmts` (including
+    // nested ifbro/whilebro blocks) to `out`.
+    void collectAssigned(const std::vector<StmtPtr>& stmts, std::set<std::string>& out);
+
+    // Counts how many letbro statements write each variable in `stmts`
+    // (nested blocks included) and adds the counts to `out`.
+    void countAssigned(const std::vector<StmtPtr>& stmts, std::map<std::string, int>& out);
+
+    // Walks `stmts` in source order, the way Codegen fills its symbol table,
+    // adding each letbro'd name to `declared`; true if a variable is read
+    // before its first `letbro` (Codegen would load 0 and warn there).
+    bool readsBeforeDeclared(const std::vector<StmtPtr>& stmts, std::set<std::string>& declared);
+
+    // Recognizes `letbro i = i + c;`, `letbro i = c + i;` and `letbro i = i - c;`
+    // with a constant c. On success stores i and the step (i - c gives a step
+    // of -c modulo 2^16).
+    bool matchIncrement(const StmtPtr& stmt, std::string& name, uint16_t& step);
+
+    // True if `expr` reads any variable contained in `names`, or any array
+    // element (array contents are not tracked, so a read may always differ).
+    bool usesAny(const ExprPtr& expr, const std::set<std::string>& names);
+
+    // True if evaluating `expr` can trap at runtime (division by a value that
+    // is not a known non-zero constant, or an array index out of bounds). Such expressions must not be moved to
+    // a point where they would run more often than in the source program.
+    bool mayTrap(const ExprPtr& expr);
+
+    // True if `expr` reads an array element anywhere inside it.
+    bool readsArray(const ExprPtr& expr);
+
+    // Structural key: two expressions with the same key compute the same value
+    // given the same variable contents. Example: "(+ a 1)".
+    std::string exprKey(const ExprPtr& expr);
+
+    // Number of instructions Codegen emits to evaluate `expr` (keep in sync with
+    // Codegen::genExpression). Used by passes to decide whether a rewrite pays.
+    int estimateCost(const ExprPtr& expr);
+
+    // Instructions Codegen emits for a whole block (statements and control flow)
+    int estimateBlockCost(const std::vector<StmtPtr>& stmts);
+
+    // Deep copies; passes that duplicate code (e.g. unrolling) must not share
+    // nodes between copies because later passes rewrite nodes in place.
+    // Statement copies keep the original's id.
+    ExprPtr cloneExpr(const ExprPtr& expr);
+    StmtPtr cloneStmt(const StmtPtr& stmt);
+    std::vector<StmtPtr> cloneBlock(const std::vector<StmtPtr>& stmts);
+
+    // Calls `fn` on every top-level expression slot of `stmts` (let values,
+    // print arguments, array store values and indexes, conditions), recursing
+    // into nested blocks. `fn` may
+    // replace the expression it is given.
+    void forEachExpr(std::vector<StmtPtr>& stmts, const std::function<void(ExprPtr&)>& fn);
+
+} // namespace AstUtils
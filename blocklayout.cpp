@@ -0,0 +1,185 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: blocklayout.cpp
+// Purpose:
+//   - Implements block reordering by greedy chain merging: edges are visited
+//     from heaviest to lightest, and an edge u → v glues the chain ending in u
+//     to the chain starting with v, making it a fallthrough.
+//   - The chains are then written out and every block's last jump is fixed up
+//     for its new neighbour (dropped, inverted, or completed with a JMP).
+// =====================================================================================
+
+#include "blocklayout.h"
+#include "cfg.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+    // Relative execution frequency per level of loop nesting
+    constexpr double LOOP_WEIGHT = 8.0;
+
+    // Probability that a conditional jump stays inside its loop
+    constexpr double STAY_IN_LOOP = 0.9;
+
+    struct Edge {
+        int from;
+        int to;
+        double weight;
+    };
+
+    bool isJump(Opcode op) {
+        return op == Opcode::JMP || op == Opcode::JZ || op == Opcode::JNZ;
+    }
+
+    // Estimated weight of every edge, from loop depth alone
+    std::vector<Edge> weighEdges(const ControlFlowGraph& cfg) {
+        const auto& blocks = cfg.blocks();
+        std::vector<Edge> edges;
+
+        for (size_t b = 0; b < blocks.size(); ++b) {
+            const BasicBlock& block = blocks[b];
+            if (!block.reachable) continue;
+
+            double frequency = std::pow(LOOP_WEIGHT, block.loopDepth);
+            int from = static_cast<int>(b);
+
+            if (block.succs.size() == 1) {
+                edges.push_back({from, block.succs[0], frequency});
+                continue;
+            }
+            if (block.succs.size() != 2) continue;
+
+            // An edge stays in the loop if it goes back to a header or does not
+            // leave to shallower code
+            bool stays[2];
+            for (int k = 0; k < 2; ++k) {
+                int to = block.succs[k];
+                stays[k] = cfg.isBackEdge(from, to) || blocks[to].loopDepth >= block.loopDepth;
+            }
+
+            double p0 = 0.5;
+            if (stays[0] && !stays[1]) p0 = STAY_IN_LOOP;
+            if (stays[1] && !stays[0]) p0 = 1.0 - STAY_IN_LOOP;
+
+            edges.push_back({from, block.succs[0], frequency * p0});
+            edges.push_back({from, block.succs[1], frequency * (1.0 - p0)});
+        }
+        return edges;
+    }
+
+    // Total weight of edges whose target is placed right after their source
+    double fallthroughWeight(const std::vector<Edge>& edges, const std::vector<int>& order) {
+        std::vector<int> next(order.size(), -1);
+        for (size_t k = 0; k + 1 < order.size(); ++k) next[order[k]] = order[k + 1];
+
+        double total = 0;
+        for (const auto& e : edges)
+            if (next[e.from] == e.to) total += e.weight;
+        return total;
+    }
+
+} // namespace
+
+// =====================================================================================
+// Function: run
+// Purpose: Builds the CFG, chooses a block order, and rewrites the code for it.
+// =====================================================================================
+void BlockLayout::run(std::vector<Instruction>& code, std::vector<int>& sourceMap) {
+    if (code.empty()) return;
+    for (const auto& instr : code)
+        if (isJump(instr.op) && instr.a1 >= code.size()) return;  // Not a CFG we can build
+    sourceMap.resize(code.size(), -1);
+
+    ControlFlowGraph cfg(code);
+    const auto& blocks = cfg.blocks();
+    const int count = static_cast<int>(blocks.size());
+
+    // ---------------- Merge chains along the heaviest edges ----------------
+    std::vector<Edge> edges = weighEdges(cfg);
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const Edge& a, const Edge& b) { return a.weight > b.weight; });
+
+    std::vector<std::vector<int>> chains(count);
+    std::vector<int> chainOf(count);
+    for (int b = 0; b < count; ++b) {
+        chains[b] = {b};
+        chainOf[b] = b;
+    }
+
+    for (const auto& e : edges) {
+        int a = chainOf[e.from], c = chainOf[e.to];
+        if (a == c || e.to == 0) continue;                  // Entry block stays first
+        if (chains[a].back() != e.from || chains[c].front() != e.to) continue;
+
+        for (int b : chains[c]) chainOf[b] = a;
+        chains[a].insert(chains[a].end(), chains[c].begin(), chains[c].end());
+        chains[c].clear();
+    }
+
+    // Entry chain first, the rest in their original order
+    std::vector<int> order = chains[chainOf[0]];
+    for (int b = 0; b < count; ++b)
+        if (chainOf[b] == b && b != chainOf[0])
+            order.insert(order.end(), chains[b].begin(), chains[b].end());
+
+    std::vector<int> original(count);
+    for (int b = 0; b < count; ++b) original[b] = b;
+    if (fallthroughWeight(edges, order) <= fallthroughWeight(edges, original)) return;
+
+    // ---------------- Write the blocks out in the new order ----------------
+    std::vector<Instruction> out;
+    std::vector<int> outMap;
+    std::vector<size_t> newStart(count);
+    std::vector<std::pair<size_t, int>> fixups;  // Jump index → target block
+
+    auto emitJump = [&](Opcode op, int target, int statement) {
+        fixups.push_back({out.size(), target});
+        out.push_back({op, 0});
+        outMap.push_back(statement);
+    };
+
+    for (size_t k = 0; k < order.size(); ++k) {
+        const BasicBlock& block = blocks[order[k]];
+        int next = (k + 1 < order.size()) ? order[k + 1] : -1;
+        newStart[order[k]] = out.size();
+
+        for (size_t i = block.start; i + 1 < block.end; ++i) {
+            out.push_back(code[i]);
+            outMap.push_back(sourceMap[i]);
+        }
+
+        const Instruction& last = code[block.end - 1];
+        int statement = sourceMap[block.end - 1];
+        int fall = (block.end < code.size()) ? cfg.blockOf(block.end) : -1;
+
+        if (last.op == Opcode::JMP) {
+            int target = cfg.blockOf(last.a1);
+            if (target != next) emitJump(Opcode::JMP, target, statement);
+        } else if (isJump(last.op)) {
+            int target = cfg.blockOf(last.a1);
+            Opcode inverted = (last.op == Opcode::JZ) ? Opcode::JNZ : Opcode::JZ;
+            if (fall == next) {
+                emitJump(last.op, target, statement);
+            } else if (target == next) {
+                emitJump(inverted, fall, statement);           // Flip so the taken side falls through
+            } else {
+                emitJump(last.op, target, statement);
+                emitJump(Opcode::JMP, fall, statement);
+            }
+        } else {
+            out.push_back(last);
+            outMap.push_back(statement);
+            if (last.op != Opcode::HLT && fall >= 0 && fall != next)
+                emitJump(Opcode::JMP, fall, statement);
+        }
+    }
+
+    for (const auto& [index, target] : fixups)
+        out[index].a1 = static_cast<uint16_t>(newStart[target]);
+
+    code = std::move(out);
+    sourceMap = std::move(outMap);
+}
@@ -0,0 +1,44 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: blocklayout.h
+// Purpose:
+//   - Declares the basic-block layout pass: reorders the blocks of the CFG
+//     (see cfg.h) so the edges most likely to run become fallthroughs instead
+//     of taken jumps.
+//
+// Static heuristics (no profile needed):
+//   → A block nested in N loops runs 8^N times as often as straight-line code.
+//   → A conditional jump that can stay in its loop does so 90% of the time.
+//
+// Example (whilebro): the body is placed before the condition, so every
+// iteration ends with one taken JNZ instead of a JMP back to a JZ:
+//   0: MOV 0                    0: MOV 0
+//   1: STORE i                  1: STORE i
+//   2: ...cond                  2: JMP 4
+//   4: JZ 7            ==>      3: ...body
+//   5: ...body                  4: ...cond
+//   6: JMP 2                    6: JNZ 3
+//   7: HLT                      7: HLT
+// =====================================================================================
+
+#pragma once
+
+#include "RohitVM.hpp"   // Instruction and Opcode definitions
+#include <vector>
+
+// =====================================================================================
+// Class: BlockLayout
+// Role:
+//   - Static utility class: rewrites an instruction list (jump operands are
+//     instruction indices) and its source map in place. The entry block stays
+//     first. The code is left as it was if the new order is not better.
+//
+// Usage:
+//   BlockLayout::run(bytecode, sourceMap);
+// =====================================================================================
+class BlockLayout {
+public:
+    static void run(std::vector<Instruction>& code, std::vector<int>& sourceMap);
+};
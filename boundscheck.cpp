@@ -0,0 +1,189 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: boundscheck.cpp
+// Purpose:
+//   - Implements the bounds-check hoisting pass declared in boundscheck.h.
+//
+// Why the copy is safe:
+//   - Both branches hold the same loop, so the program does exactly the same
+//     thing whichever one runs. Nothing here removes a check: range analysis
+//     still has to prove each access of the guarded copy in bounds, and an
+//     access it can not prove keeps its CHK.
+//   - Loops that read a variable before its letbro are left alone: Codegen
+//     reads such a variable as 0 only until it has seen the letbro, so a
+//     second copy of the loop would read it differently.
+// =====================================================================================
+
+#include "boundscheck.h"
+#include "astutils.h"
+#include <algorithm>
+#include <map>
+
+namespace {
+
+    // Same bound the unroller uses to turn instruction estimates into bytes
+    constexpr int BYTES_PER_INSTRUCTION = 3;
+
+    // Guard: MOV/LOAD n, MOV_BX, LT, JZ, plus the JMP over the second copy
+    constexpr int GUARD_COST = 5;
+
+    // ---------------------------------------------------------------------------------
+    // Limits: for each access indexed by `iv` or `iv + C`, the largest n for
+    // which i < n keeps the index below the array size (`shift` is added to i
+    // after the increment). `limit` only ever shrinks; `unproven` notes a
+    // match that range analysis could not already prove.
+    // ---------------------------------------------------------------------------------
+    struct Limits {
+        const std::string& iv;
+        long shift = 0;
+        long limit = 0x10000;
+        bool unproven = false;
+
+        void access(const ExprPtr& index, int size, bool inBounds) {
+            long offset = -1;
+            if (auto var = std::dynamic_pointer_cast<VariableExpr>(index)) {
+                if (var->name == iv) offset = 0;
+            } else if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(index); bin && bin->op == BinaryOp::Add) {
+                auto lvar = std::dynamic_pointer_cast<VariableExpr>(bin->left);
+                auto rvar = std::dynamic_pointer_cast<VariableExpr>(bin->right);
+                auto lnum = std::dynamic_pointer_cast<NumberExpr>(bin->left);
+                auto rnum = std::dynamic_pointer_cast<NumberExpr>(bin->right);
+                if (lvar && lvar->name == iv && rnum) offset = static_cast<uint16_t>(rnum->value);
+                else if (rvar && rvar->name == iv && lnum) offset = static_cast<uint16_t>(lnum->value);
+            }
+            if (offset < 0) return;
+
+            limit = std::min(limit, size - offset - shift);
+            unproven = unproven || !inBounds;
+        }
+
+        void expr(const ExprPtr& e) {
+            if (auto idx = std::dynamic_pointer_cast<IndexExpr>(e)) {
+                access(idx->index, idx->size, idx->inBounds);
+                expr(idx->index);
+            } else if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(e)) {
+                expr(bin->left);
+                expr(bin->right);
+            } else if (auto call = std::dynamic_pointer_cast<CallExpr>(e)) {
+                for (const auto& arg : call->args) expr(arg);
+            }
+        }
+
+        void stmt(const StmtPtr& s) {
+            if (auto let = std::dynamic_pointer_cast<LetStatement>(s)) {
+                expr(let->value);
+            } else if (auto print = std::dynamic_pointer_cast<PrintStatement>(s)) {
+                expr(print->expr);
+            } else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(s)) {
+                expr(store->value);
+                expr(store->index);
+                access(store->index, store->size, store->inBounds);
+            } else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(s)) {
+                expr(ifs->condition);
+                for (const auto& t : ifs->thenBranch) stmt(t);
+                for (const auto& t : ifs->elseBranch) stmt(t);
+            } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(s)) {
+                expr(wh->condition);
+                for (const auto& t : wh->body) stmt(t);
+            }
+        }
+    };
+
+} // namespace
+
+BoundsCheckHoisting::BoundsCheckHoisting(int codeBudget) : codeBudget(codeBudget) {}
+
+// =====================================================================================
+// Function: run
+// Purpose: Estimates the current program size, then guards what fits.
+// =====================================================================================
+bool BoundsCheckHoisting::run(Program& program) {
+    codeSize = (AstUtils::estimateBlockCost(program.statements) + 1) * BYTES_PER_INSTRUCTION;  // + HLT
+    changed = false;
+    std::set<std::string> declared;
+    processBlock(program.statements, declared);
+    return changed;
+}
+
+// =====================================================================================
+// Function: processBlock
+// Purpose:
+//   - Rebuilds `block`, replacing each matching whilebro with
+//         ifbro (guard) { loop } elsebro { copy of loop }
+//     as long as the copy fits in the code budget.
+// =====================================================================================
+void BoundsCheckHoisting::processBlock(std::vector<StmtPtr>& block, std::set<std::string>& declared) {
+    std::vector<StmtPtr> out;
+
+    for (auto& stmt : block) {
+        if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+            declared.insert(let->name);
+        } else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+            processBlock(ifs->thenBranch, declared);
+            processBlock(ifs->elseBranch, declared);
+        } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+            std::set<std::string> atEntry = declared;
+            processBlock(wh->body, declared);
+
+            std::set<std::string> seen = atEntry;
+            ExprPtr guard = AstUtils::readsBeforeDeclared({stmt}, seen) ? nullptr : guardFor(*wh, atEntry);
+            long growth = (AstUtils::estimateBlockCost({stmt}) + GUARD_COST) * BYTES_PER_INSTRUCTION;
+
+            if (guard && codeSize + growth <= codeBudget) {
+                auto guarded = std::make_shared<IfStatement>(guard, std::vector<StmtPtr>{stmt},
+                                                             std::vector<StmtPtr>{AstUtils::cloneStmt(stmt)});
+                out.push_back(guarded);
+                codeSize += growth;
+                changed = true;
+                continue;
+            }
+        }
+        out.push_back(stmt);
+    }
+
+    block = std::move(out);
+}
+
+// =====================================================================================
+// Function: guardFor
+// Purpose:
+//   - Matches the loop shape described in boundscheck.h and builds
+//     `n < L + 1`, or returns nullptr.
+// =====================================================================================
+ExprPtr BoundsCheckHoisting::guardFor(const WhileStatement& loop, const std::set<std::string>& declared) {
+    // Condition: i < n, or n > i
+    auto cond = std::dynamic_pointer_cast<BinaryExpr>(loop.condition);
+    if (!cond || (cond->op != BinaryOp::Less && cond->op != BinaryOp::Greater)) return nullptr;
+
+    bool less = cond->op == BinaryOp::Less;
+    auto counter = std::dynamic_pointer_cast<VariableExpr>(less ? cond->left : cond->right);
+    auto bound = std::dynamic_pointer_cast<VariableExpr>(less ? cond->right : cond->left);
+    if (!counter || !bound || counter->name == bound->name) return nullptr;
+    if (!declared.count(counter->name) || !declared.count(bound->name)) return nullptr;
+
+    // Body: n never written, i written once by a top-level increment
+    std::map<std::string, int> assignments;
+    AstUtils::countAssigned(loop.body, assignments);
+    if (assignments.count(bound->name) || assignments[counter->name] != 1) return nullptr;
+
+    Limits limits{counter->name};
+    bool incremented = false;
+    for (const auto& stmt : loop.body) {
+        std::string name;
+        uint16_t step;
+        if (AstUtils::matchIncrement(stmt, name, step) && name == counter->name) {
+            if (step == 0 || step >= 0x8000) return nullptr;  // Only counting up
+            limits.shift = step;
+            incremented = true;
+            continue;
+        }
+        limits.stmt(stmt);
+    }
+    if (!incremented || !limits.unproven || limits.limit < 1) return nullptr;
+
+    return std::make_shared<BinaryExpr>(BinaryOp::Less,
+                                        std::make_shared<VariableExpr>(bound->name),
+                                        std::make_shared<NumberExpr>(static_cast<int>(limits.limit + 1)));
+}
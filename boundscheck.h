@@ -0,0 +1,61 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: boundscheck.h
+// Purpose:
+//   - Declares the bounds-check hoisting pass for `whilebro` loops that walk an
+//     array up to a limit held in a variable.
+//   - Range analysis alone can not drop the CHK in such a loop: nothing bounds
+//     the limit. This pass tests the limit once, before the loop, and keeps a
+//     copy of the loop for when the test passes; inside that copy range
+//     analysis proves every `arr[i]` in bounds and Codegen emits no CHK.
+//
+// Example (arr has 10 elements):
+//   whilebro (i < n) {                  ifbro (n < 11) {
+//       letbro arr[i] = i * i;              whilebro (i < n) { ... }     (no CHK)
+//       letbro i = i + 1;       ==>     } elsebro {
+//   }                                       whilebro (i < n) { ... }     (checked)
+//                                       }
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include <set>
+#include <string>
+#include <vector>
+
+// =====================================================================================
+// Class: BoundsCheckHoisting
+// Purpose:
+//   - Recognizes loops of the form
+//         whilebro (i < n) { ... letbro i = i + S; ... }    (or n > i)
+//     where n is a variable the body never assigns, the body assigns i exactly
+//     once, by that top-level increment, and indexes arrays with i or i + C.
+//   - The guard `n < L + 1` uses the largest L that keeps every such index
+//     below its array's size (an access after the increment sees i + S).
+//   - Runs between two rounds of range analysis, and only when checks may be
+//     elided: loops whose accesses the first round already proved are left
+//     alone, and the guarded copy is only worth its size once the CHKs are gone.
+// =====================================================================================
+class BoundsCheckHoisting {
+public:
+    // codeBudget: maximum size of the generated code, in bytes
+    explicit BoundsCheckHoisting(int codeBudget);
+
+    // Rewrites `program` in place; true if it guarded any loop
+    bool run(Program& program);
+
+private:
+    // Processes one statement list, inner loops first. `declared` holds the
+    // variables whose letbro came earlier in the source, as in Codegen.
+    void processBlock(std::vector<StmtPtr>& block, std::set<std::string>& declared);
+
+    // The guard for `loop`, or nullptr if the loop does not match
+    ExprPtr guardFor(const WhileStatement& loop, const std::set<std::string>& declared);
+
+    int codeBudget;
+    long codeSize = 0;  // Running estimate of the program size in bytes
+    bool changed = false;
+};
@@ -0,0 +1,107 @@
+// ===================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: broar.cpp
+// Purpose:
+//   - Packs `.brobin` images into one `.broa` archive (broarchive.h) and lists
+//     what an archive holds. Each program is named after its file, without
+//     the directory and the `.brobin` extension, unless given as name=path.
+//
+// Usage:
+//   ./broar -c programs.broa hello.brobin greet=other/hello2.brobin
+//   ./broar -t programs.broa
+//
+// Build:
+//   g++ broar.cpp broarchive.cpp brobin.cpp -o broar
+// ===================================================================================
+
+#include "broarchive.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+
+// -----------------------------------------------------------------------------------
+// Function: showUsage
+// -----------------------------------------------------------------------------------
+void showUsage() {
+    std::cout << "Usage:\n";
+    std::cout << "  ./broar -c archive.broa prog.brobin [name=other.brobin ...]   Create\n";
+    std::cout << "  ./broar -t archive.broa                                       List\n";
+}
+
+// -----------------------------------------------------------------------------------
+// Function: memberName
+// Purpose: `name=path` gives the name; otherwise the file name minus `.brobin`
+// -----------------------------------------------------------------------------------
+std::string memberName(const std::string& arg, std::string& path) {
+    size_t equals = arg.find('=');
+    if (equals != std::string::npos) {
+        path = arg.substr(equals + 1);
+        return arg.substr(0, equals);
+    }
+    path = arg;
+    std::string name = arg.substr(arg.find_last_of('/') + 1);
+    if (name.size() > 7 && name.compare(name.size() - 7, 7, ".brobin") == 0) name.resize(name.size() - 7);
+    return name;
+}
+
+// -----------------------------------------------------------------------------------
+// Function: create
+// -----------------------------------------------------------------------------------
+int create(const std::string& archivePath, const std::vector<std::string>& args) {
+    std::vector<BroBin::ArchiveMember> members;
+    for (const std::string& arg : args) {
+        std::string path;
+        BroBin::ArchiveMember member;
+        member.name = memberName(arg, path);
+
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "Failed to open image: " << path << "\n";
+            return 1;
+        }
+        member.image.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        members.push_back(std::move(member));
+    }
+
+    std::vector<uint8_t> bytes;
+    std::string error;
+    if (!BroBin::buildArchive(members, bytes, error)) {
+        std::cerr << "Can not build " << archivePath << ": " << error << "\n";
+        return 1;
+    }
+
+    // Replaced, not rewritten: VMs may be running its programs from a mapping
+    if (!BroBin::replaceFile(archivePath, bytes)) return 1;
+    std::cout << "Wrote " << members.size() << " programs to " << archivePath << "\n";
+    return 0;
+}
+
+// -----------------------------------------------------------------------------------
+// Function: list
+// -----------------------------------------------------------------------------------
+int list(const std::string& archivePath) {
+    auto archive = BroBin::Archive::open(archivePath);
+    if (!archive) return 1;
+
+    for (size_t i = 0; i < archive->size(); ++i) {
+        BroBin::Archive::Entry entry = archive->entry(i);
+        std::cout << std::hex << std::setw(16) << std::setfill('0') << entry.contentHash << std::dec
+                  << std::setfill(' ') << std::setw(10) << entry.size << "  " << entry.name << "\n";
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------------
+// Function: main
+// -----------------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    std::string mode = argc > 1 ? argv[1] : "";
+    if (mode == "-c" && argc > 3) return create(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+    if (mode == "-t" && argc == 3) return list(argv[2]);
+    showUsage();
+    return 1;
+}
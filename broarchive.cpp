@@ -0,0 +1,264 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: broarchive.cpp
+// Purpose:
+//   - Implements the `.broa` archive described in broarchive.h.
+//
+// What open() checks:
+//   - The header, the index checksum, and that every name, image and slot the
+//     index points to lies inside the file: only the index is read, so opening
+//     costs the same however large the images are. Each image gets the full
+//     brobin.h parse() when a VM loads it.
+// =====================================================================================
+
+#include "broarchive.h"
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <map>
+
+namespace {
+
+    constexpr uint8_t MAGIC[4] = {'B', 'R', 'O', 'A'};
+    constexpr size_t HEADER_SIZE = 32;
+    constexpr size_t ENTRY_SIZE = 32;
+
+    void put16(std::vector<uint8_t>& out, uint16_t v) {
+        out.push_back(v & 0xFF);
+        out.push_back((v >> 8) & 0xFF);
+    }
+
+    void put32(std::vector<uint8_t>& out, uint32_t v) {
+        put16(out, v & 0xFFFF);
+        put16(out, (v >> 16) & 0xFFFF);
+    }
+
+    void put64(std::vector<uint8_t>& out, uint64_t v) {
+        put32(out, v & 0xFFFFFFFF);
+        put32(out, v >> 32);
+    }
+
+    void set32(uint8_t* p, uint32_t v) {
+        for (int i = 0; i < 4; ++i) p[i] = (v >> (8 * i)) & 0xFF;
+    }
+
+    uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+    uint32_t get32(const uint8_t* p) { return get16(p) | (static_cast<uint32_t>(get16(p + 2)) << 16); }
+    uint64_t get64(const uint8_t* p) { return get32(p) | (static_cast<uint64_t>(get32(p + 4)) << 32); }
+
+    uint32_t nameHash(std::string_view name) {
+        return BroBin::checksum(reinterpret_cast<const uint8_t*>(name.data()), name.size());
+    }
+
+    // First entry along the probe sequence of `hash` that `matches`, or -1
+    template <typename Match>
+    long probe(const uint8_t* slots, uint32_t slotCount, uint32_t hash, Match matches) {
+        for (uint32_t step = 0; step < slotCount; ++step) {
+            uint32_t value = get32(slots + 4 * ((hash + step) & (slotCount - 1)));
+            if (value == 0) return -1;                     // Empty slot: not present
+            if (matches(value - 1)) return static_cast<long>(value - 1);
+        }
+        return -1;
+    }
+
+    // Linear probing into a table of entry index + 1
+    void insert(uint8_t* slots, uint32_t slotCount, uint32_t hash, uint32_t index) {
+        uint32_t at = hash & (slotCount - 1);
+        while (get32(slots + 4 * at) != 0) at = (at + 1) & (slotCount - 1);
+        set32(slots + 4 * at, index + 1);
+    }
+
+} // namespace
+
+namespace BroBin {
+
+    uint64_t contentHash(const uint8_t* bytes, size_t size) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Archive: open and look up
+    // ---------------------------------------------------------------------------------
+    std::shared_ptr<const Archive> Archive::open(const std::string& path) {
+        std::string error;
+        auto file = MappedFile::open(path, error);
+        if (!file) {
+            std::cerr << "Invalid archive " << path << ": " << error << "\n";
+            return nullptr;
+        }
+
+        const uint8_t* bytes = file->data();
+        const size_t size = file->size();
+        auto fail = [&](const std::string& message) {
+            std::cerr << "Invalid archive " << path << ": " << message << "\n";
+            return nullptr;
+        };
+        if (size < HEADER_SIZE || !std::equal(std::begin(MAGIC), std::end(MAGIC), bytes))
+            return fail("not a .broa archive");
+        if (get16(bytes + 4) != ARCHIVE_VERSION)
+            return fail("unsupported version " + std::to_string(get16(bytes + 4)));
+
+        std::shared_ptr<Archive> archive(new Archive);
+        archive->count = get32(bytes + 8);
+        archive->slotCount = get32(bytes + 12);
+        uint32_t namesSize = get32(bytes + 16);
+        uint64_t indexEnd = HEADER_SIZE + uint64_t(ENTRY_SIZE) * archive->count +
+                            8ull * archive->slotCount + namesSize;
+        bool powerOfTwo = archive->slotCount != 0 && (archive->slotCount & (archive->slotCount - 1)) == 0;
+        if (!powerOfTwo || archive->slotCount < 2ull * archive->count || indexEnd > size)
+            return fail("malformed index");
+        if (checksum(bytes + HEADER_SIZE, indexEnd - HEADER_SIZE) != get32(bytes + 20))
+            return fail("checksum mismatch");
+
+        archive->entries = bytes + HEADER_SIZE;
+        archive->nameSlots = archive->entries + ENTRY_SIZE * archive->count;
+        archive->hashSlots = archive->nameSlots + 4 * archive->slotCount;
+        archive->names = archive->hashSlots + 4 * archive->slotCount;
+
+        for (uint32_t i = 0; i < archive->count; ++i) {
+            const uint8_t* e = archive->entries + ENTRY_SIZE * i;
+            if (uint64_t(get32(e)) + get32(e + 4) > namesSize ||
+                get64(e + 8) < indexEnd || get64(e + 8) + get32(e + 16) > size)
+                return fail("entry " + std::to_string(i) + " points outside the file");
+        }
+        for (uint32_t s = 0; s < 2 * archive->slotCount; ++s) {
+            if (get32(archive->nameSlots + 4 * s) > archive->count) return fail("malformed index");
+        }
+
+        archive->mapping = file;
+        return archive;
+    }
+
+    Archive::Entry Archive::entry(size_t index) const {
+        const uint8_t* e = entries + ENTRY_SIZE * index;
+        Entry out;
+        out.name = std::string_view(reinterpret_cast<const char*>(names + get32(e)), get32(e + 4));
+        out.image = mapping->data() + get64(e + 8);
+        out.size = get32(e + 16);
+        out.contentHash = get64(e + 24);
+        return out;
+    }
+
+    bool Archive::find(std::string_view name, Entry& out) const {
+        long index = probe(nameSlots, slotCount, nameHash(name),
+                           [&](uint32_t i) { return entry(i).name == name; });
+        if (index < 0) return false;
+        out = entry(index);
+        return true;
+    }
+
+    bool Archive::findByHash(uint64_t hash, Entry& out) const {
+        long index = probe(hashSlots, slotCount, static_cast<uint32_t>(hash),
+                           [&](uint32_t i) { return entry(i).contentHash == hash; });
+        if (index < 0) return false;
+        out = entry(index);
+        return true;
+    }
+
+    bool Archive::view(std::string_view name, View& out, std::string& error) const {
+        Entry found;
+        if (!find(name, found)) {
+            error = "no program named " + std::string(name);
+            return false;
+        }
+        return parse(found.image, found.size, out, error);
+    }
+
+    // ---------------------------------------------------------------------------------
+    // buildArchive
+    // ---------------------------------------------------------------------------------
+    bool buildArchive(const std::vector<ArchiveMember>& members, std::vector<uint8_t>& out, std::string& error) {
+        if (members.empty()) {
+            error = "no programs to pack";
+            return false;
+        }
+
+        uint32_t slotCount = 1;
+        while (slotCount < 2 * members.size()) slotCount *= 2;
+
+        // --- Names, and each distinct image once ---
+        std::string names;
+        std::map<std::string, size_t> seenNames;
+        std::map<uint64_t, std::vector<size_t>> imagesByHash;  // Hash → first member with that content
+        std::vector<size_t> imageOf(members.size());           // Member → member whose bytes it uses
+        std::vector<uint64_t> hashes(members.size());
+        for (size_t i = 0; i < members.size(); ++i) {
+            const ArchiveMember& member = members[i];
+            if (member.name.empty() || !seenNames.emplace(member.name, i).second) {
+                error = member.name.empty() ? "empty program name" : "program " + member.name + " listed twice";
+                return false;
+            }
+            View view;
+            if (!parse(member.image.data(), member.image.size(), view, error)) {
+                error = member.name + ": " + error;
+                return false;
+            }
+
+            hashes[i] = contentHash(member.image.data(), member.image.size());
+            imageOf[i] = i;
+            for (size_t other : imagesByHash[hashes[i]]) {
+                if (members[other].image == member.image) imageOf[i] = other;
+            }
+            if (imageOf[i] == i) imagesByHash[hashes[i]].push_back(i);
+        }
+
+        size_t indexEnd = HEADER_SIZE + ENTRY_SIZE * members.size() + 8ull * slotCount;
+        for (const auto& member : members) indexEnd += member.name.size();
+        uint64_t imageStart = (indexEnd + 7) & ~size_t(7);
+
+        std::vector<uint64_t> offsets(members.size());
+        uint64_t at = imageStart;
+        for (size_t i = 0; i < members.size(); ++i) {
+            if (imageOf[i] != i) continue;
+            offsets[i] = at;
+            at = (at + members[i].image.size() + 7) & ~uint64_t(7);
+        }
+
+        // --- Header and entries ---
+        out.assign(std::begin(MAGIC), std::end(MAGIC));
+        put16(out, ARCHIVE_VERSION);
+        put16(out, 0);
+        put32(out, static_cast<uint32_t>(members.size()));
+        put32(out, slotCount);
+        put32(out, static_cast<uint32_t>(indexEnd - HEADER_SIZE - ENTRY_SIZE * members.size() - 8ull * slotCount));
+        put32(out, 0);  // Checksum, filled in below
+        put64(out, 0);
+        for (size_t i = 0; i < members.size(); ++i) {
+            put32(out, static_cast<uint32_t>(names.size()));
+            put32(out, static_cast<uint32_t>(members[i].name.size()));
+            put64(out, offsets[imageOf[i]]);
+            put32(out, static_cast<uint32_t>(members[i].image.size()));
+            put32(out, 0);
+            put64(out, hashes[i]);
+            names += members[i].name;
+        }
+
+        // --- Slot tables (only the first member with each content is indexed by hash) ---
+        size_t slotsAt = out.size();
+        out.resize(out.size() + 8ull * slotCount, 0);
+        uint8_t* nameSlots = out.data() + slotsAt;
+        uint8_t* hashSlots = nameSlots + 4 * slotCount;
+        for (size_t i = 0; i < members.size(); ++i) {
+            insert(nameSlots, slotCount, nameHash(members[i].name), static_cast<uint32_t>(i));
+            if (imageOf[i] == i) insert(hashSlots, slotCount, static_cast<uint32_t>(hashes[i]), static_cast<uint32_t>(i));
+        }
+        out.insert(out.end(), names.begin(), names.end());
+        set32(out.data() + 20, checksum(out.data() + HEADER_SIZE, out.size() - HEADER_SIZE));
+
+        // --- Images ---
+        for (size_t i = 0; i < members.size(); ++i) {
+            if (imageOf[i] != i) continue;
+            out.resize(offsets[i], 0);
+            out.insert(out.end(), members[i].image.begin(), members[i].image.end());
+        }
+        return true;
+    }
+
+} // namespace BroBin
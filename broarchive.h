@@ -0,0 +1,108 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: broarchive.h
+// Purpose:
+//   - Declares the `.broa` archive: many `.brobin` images (brobin.h) in one
+//     file, with a hashed index by name and by content hash. A host serving
+//     thousands of small programs maps one archive once instead of opening a
+//     file per program, and finds each program without reading the others.
+//
+// Layout (integers little-endian):
+//   offset  size  field
+//   0       4     magic "BROA"
+//   4       2     version (ARCHIVE_VERSION)
+//   6       2     reserved (0)
+//   8       4     entry count
+//   12      4     slot count (a power of two, at least twice the entry count)
+//   16      4     names size in bytes
+//   20      4     checksum: FNV-1a over the entries, both slot tables and the names
+//   24      8     reserved (0)
+//   32      ...   entries, 32 bytes each:
+//                   name offset u32, name length u32, image offset u64,
+//                   image size u32, reserved u32, content hash u64
+//   ...     ...   name slots: u32 per slot, entry index + 1 (0 = empty),
+//                 open addressing on FNV-1a of the name
+//   ...     ...   hash slots: the same, on the content hash
+//   ...     ...   names, then the images (8-byte aligned)
+//
+// Looking a program up:
+//   - One hash, then a short probe over the slot table: O(1) however many
+//     programs the archive holds. An image is returned as a pointer into the
+//     mapping, never copied, and checked (brobin.h parse) only when loaded.
+//   - Identical images are stored once; their names share one entry's bytes.
+//
+// Workflow:
+//   ./broar -c programs.broa hello.brobin report.brobin
+//   ./brorun programs.broa --program=hello
+// =====================================================================================
+
+#pragma once
+
+#include "brobin.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BroBin {
+
+    constexpr uint16_t ARCHIVE_VERSION = 1;
+
+    // 64-bit FNV-1a of an image; names the content in the index
+    uint64_t contentHash(const uint8_t* bytes, size_t size);
+
+    // ---------------------------------------------------------------------------------
+    // Class: Archive
+    // Purpose: A `.broa` file mapped read-only, with lookups into its index
+    // ---------------------------------------------------------------------------------
+    class Archive {
+    public:
+        struct Entry {
+            std::string_view name;
+            uint64_t contentHash = 0;
+            const uint8_t* image = nullptr;    // Points into the mapping
+            size_t size = 0;
+        };
+
+        // Maps `path` and checks its index; prints an error and returns nullptr on failure
+        static std::shared_ptr<const Archive> open(const std::string& path);
+
+        size_t size() const { return count; }
+        Entry entry(size_t index) const;
+
+        // False if there is no such program
+        bool find(std::string_view name, Entry& out) const;
+        bool findByHash(uint64_t hash, Entry& out) const;
+
+        // find, then the image checked and split (brobin.h parse) for VM::loadImage;
+        // on failure `error` says why
+        bool view(std::string_view name, View& out, std::string& error) const;
+
+        // Keeps the mapping alive for as long as a VM runs code from it
+        const std::shared_ptr<const MappedFile>& file() const { return mapping; }
+
+    private:
+        Archive() = default;
+
+        std::shared_ptr<const MappedFile> mapping;
+        uint32_t count = 0;
+        uint32_t slotCount = 0;
+        const uint8_t* entries = nullptr;
+        const uint8_t* nameSlots = nullptr;
+        const uint8_t* hashSlots = nullptr;
+        const uint8_t* names = nullptr;
+    };
+
+    // One program to pack: its name and its whole `.brobin` file
+    struct ArchiveMember {
+        std::string name;
+        std::vector<uint8_t> image;
+    };
+
+    // The whole archive file; false (with `error` set) for an empty or repeated name
+    bool buildArchive(const std::vector<ArchiveMember>& members, std::vector<uint8_t>& out, std::string& error);
+
+} // namespace BroBin
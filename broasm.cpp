@@ -0,0 +1,73 @@
+// ===================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: broasm.cpp
+// Purpose:
+//   - Assembles hand-written RohitVM code (the text format in assembler.h) into
+//     a `.brobin` image for run_bro / brorun, or into a prog.cpp like broc's.
+//   - For hand-tuning a hot loop: `brodis` a compiled program, edit the text,
+//     assemble it again.
+//   - DIV_NC, PUSH_NC and POP_NC are assembled as DIV, PUSH and POP: only broc
+//     can prove them safe, and the VM trusts them not to fault. `--unchecked`
+//     keeps them and marks the image as if broc had written it (brobin.h).
+//
+// Build:
+//   g++ broasm.cpp assembler.cpp emitter.cpp brobin.cpp -o broasm
+// ===================================================================================
+
+#include "assembler.h"
+#include "emitter.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// -----------------------------------------------------------------------------------
+// Function: showUsage
+// -----------------------------------------------------------------------------------
+void showUsage() {
+    std::cout << "Usage:\n";
+    std::cout << "  ./broasm input.basm -o prog.brobin   Assemble into a binary image\n";
+    std::cout << "  ./broasm input.basm -o prog.cpp      Assemble into C++ for compiler_test.cpp\n";
+    std::cout << "Options:\n";
+    std::cout << "  --unchecked    Keep DIV_NC / PUSH_NC / POP_NC (the code must never need their checks)\n";
+}
+
+// -----------------------------------------------------------------------------------
+// Function: main
+// -----------------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    bool unchecked = argc == 5 && std::string(argv[4]) == "--unchecked";
+    if ((argc != 4 && !unchecked) || std::string(argv[2]) != "-o") {
+        showUsage();
+        return 1;
+    }
+    std::string inputFile = argv[1];
+    std::string outputFile = argv[3];
+
+    std::ifstream in(inputFile);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open input file: " << inputFile << "\n";
+        return 1;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+
+    Assembly assembly;
+    std::string error;
+    if (!Assembler::assemble(ss.str(), assembly, error)) {
+        std::cerr << inputFile << ": " << error << "\n";
+        return 1;
+    }
+
+    if (!unchecked) {
+        for (Instruction& instr : assembly.program) instr.op = checkedForm(instr.op);
+    }
+
+    bool image = outputFile.size() >= 7 && outputFile.compare(outputFile.size() - 7, 7, ".brobin") == 0;
+    bool written = image
+        ? Emitter::writeImage(outputFile, assembly.program, {}, assembly.dataAddress, assembly.data, unchecked)
+        : Emitter::writeToFile(outputFile, assembly.program, {}, assembly.dataAddress, assembly.data);
+    return written ? 0 : 1;
+}
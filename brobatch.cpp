@@ -0,0 +1,359 @@
+// ===================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brobatch.cpp
+// Purpose:
+//   - Compiles and runs many programs in one process on N worker threads,
+//     through libbrovm (brovm.h): no broc, g++ or runner per file.
+//   - Takes `.bro` sources and `.brobin` images, named one by one or as
+//     directories (searched recursively, in name order).
+//   - Each program's output is captured on its own and printed in input order
+//     (or written to DIR/<n>_<name>.out) as soon as it and every program before
+//     it are done, then dropped, followed by a summary: status, instruction
+//     count and times per program, then the totals and the throughput of the
+//     whole batch.
+//   - Like brod, each program is held to an instruction limit and an output
+//     size, so one endless or print-heavy program can neither hang the batch
+//     nor exhaust memory.
+//
+// Usage:
+//   ./brobatch tests/ -j8
+//   ./brobatch a.bro b.brobin --limit=1000000 --max-output=65536 --out-dir=results
+//
+// Build:
+//   g++ brobatch.cpp brovm.cpp lexer.cpp parser.cpp astutils.cpp licm.cpp strength.cpp cse.cpp unroll.cpp evaluator.cpp jumpthread.cpp cfg.cpp blocklayout.cpp range.cpp boundscheck.cpp optimizer.cpp profile.cpp codegen.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp -pthread -o brobatch
+// ===================================================================================
+
+#include "brovm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool endsWith(const std::string& text, const std::string& suffix) {
+        return text.size() >= suffix.size() &&
+               text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    bool isProgram(const std::string& path) {
+        return endsWith(path, ".bro") || endsWith(path, ".brobin");
+    }
+
+    // One input file and, once a worker is done with it, what happened
+    struct Job {
+        std::string path;
+        bool compiled = false;
+        bool done = false;
+        std::string diagnostics;        // Why it did not compile (or load)
+        std::string output;             // What it printed, until written out
+        BroVM::RunResult result;
+        double compileTime = 0;         // Milliseconds
+        double runTime = 0;
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Class: CappedOutput
+    // Purpose: VM output collected into a string; throws past `limit` bytes,
+    //          which stops the program with a fault (RunOptions::output)
+    // ---------------------------------------------------------------------------------
+    class CappedOutput : public std::streambuf {
+    public:
+        CappedOutput(std::string& text, uint64_t limit) : text(text), limit(limit) {}
+
+    protected:
+        int overflow(int c) override {
+            if (c == traits_type::eof()) return traits_type::not_eof(c);
+            if (text.size() >= limit) throw std::runtime_error("Output limit exceeded");
+            text += static_cast<char>(c);
+            return c;
+        }
+
+        std::streamsize xsputn(const char* data, std::streamsize size) override {
+            size_t room = static_cast<size_t>(limit - std::min<uint64_t>(limit, text.size()));
+            text.append(data, std::min(room, static_cast<size_t>(size)));
+            if (static_cast<size_t>(size) > room) throw std::runtime_error("Output limit exceeded");
+            return size;
+        }
+
+    private:
+        std::string& text;
+        uint64_t limit;
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Function: runJob
+    // Purpose: Compiles (or loads) and runs one program; called on a worker thread
+    // ---------------------------------------------------------------------------------
+    void runJob(Job& job, const BroVM::CompileOptions& compileOptions, BroVM::RunOptions runOptions,
+                uint64_t maxOutput) {
+        Clock::time_point start = Clock::now();
+        std::ifstream in(job.path, std::ios::binary);
+        if (!in.is_open()) {
+            job.diagnostics = "Failed to open input file\n";
+            return;
+        }
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        BroVM::CompileResult compiled = endsWith(job.path, ".brobin")
+            ? BroVM::loadImage(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size())
+            : BroVM::compile(bytes, compileOptions);
+        job.compileTime = millisecondsSince(start);
+        if (!compiled.program) {
+            job.diagnostics = compiled.diagnostics;
+            return;
+        }
+        job.compiled = true;
+
+        CappedOutput capture(job.output, maxOutput);
+        std::ostream output(&capture);
+        output.exceptions(std::ios::badbit);
+        runOptions.output = &output;
+
+        Clock::time_point runStart = Clock::now();
+        job.result = BroVM::Engine::run(compiled.program, runOptions);
+        job.runTime = millisecondsSince(runStart);
+    }
+
+    const char* statusOf(const Job& job) {
+        return job.compiled ? BroVM::statusName(job.result.status) : "compile error";
+    }
+
+} // namespace
+
+// -----------------------------------------------------------------------------------
+// Function: showUsage
+// -----------------------------------------------------------------------------------
+void showUsage() {
+    std::cout << "Usage:\n";
+    std::cout << "  ./brobatch path... [options]   Run every .bro / .brobin file (directories searched)\n";
+    std::cout << "Options:\n";
+    std::cout << "  -jN                 Worker threads (default: one per CPU)\n";
+    std::cout << "  -O0                 Compile without optimizations\n";
+    std::cout << "  --limit=N           Stop each program after N instructions (default 10000000, 0 = none)\n";
+    std::cout << "  --max-output=BYTES  Stop a program once it printed this much (default 1 MB)\n";
+    std::cout << "  --out-dir=DIR       Write each program's output to DIR/<n>_<name>.out instead of stdout\n";
+}
+
+// -----------------------------------------------------------------------------------
+// Function: collectInputs
+// Purpose: Files as given, then the programs found under each directory
+// -----------------------------------------------------------------------------------
+bool collectInputs(const std::vector<std::string>& paths, std::vector<Job>& jobs) {
+    namespace fs = std::filesystem;
+    for (const std::string& path : paths) {
+        std::error_code ec;
+        if (!fs::is_directory(path, ec)) {
+            Job job;
+            job.path = path;
+            jobs.push_back(job);
+            continue;
+        }
+
+        std::vector<std::string> found;
+        for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec) && isProgram(it->path().string())) found.push_back(it->path().string());
+        }
+        if (ec) {
+            std::cerr << "Failed to read directory " << path << ": " << ec.message() << "\n";
+            return false;
+        }
+        std::sort(found.begin(), found.end());
+        for (const std::string& file : found) {
+            Job job;
+            job.path = file;
+            jobs.push_back(job);
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------------
+// Class: OutputWriter
+// Purpose: Each program's captured output, to stdout or one file per program, in
+//          input order: written (and freed) as soon as the program and every
+//          one before it are done, so finished output is not held to the end
+// -----------------------------------------------------------------------------------
+class OutputWriter {
+public:
+    OutputWriter(std::vector<Job>& jobs, const std::string& outDir) : jobs(jobs), outDir(outDir) {}
+
+    // Creates the output directory, if any
+    bool prepare() {
+        if (outDir.empty()) return true;
+        std::error_code ec;
+        std::filesystem::create_directories(outDir, ec);
+        if (ec) {
+            std::cerr << "Failed to create " << outDir << ": " << ec.message() << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    // Called by a worker once jobs[index] is done
+    void finished(size_t index) {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs[index].done = true;
+        while (next < jobs.size() && jobs[next].done) {
+            if (!write(next)) failed = true;
+            std::string().swap(jobs[next].output);
+            ++next;
+        }
+    }
+
+    bool ok() const { return !failed; }
+
+private:
+    std::vector<Job>& jobs;
+    std::string outDir;
+    std::mutex mutex;
+    size_t next = 0;            // First job not written yet
+    bool failed = false;
+
+    bool write(size_t index) {
+        namespace fs = std::filesystem;
+        const Job& job = jobs[index];
+        std::string text = job.compiled ? job.output : job.diagnostics;
+        if (job.compiled && job.result.status != BroVM::Status::Halted) {
+            if (!text.empty() && text.back() != '\n') text += '\n';
+            text += "VM Error: " + job.result.error + "\n";
+        }
+
+        if (outDir.empty()) {
+            std::cout << "=== " << job.path << " ===\n" << text;
+            if (!text.empty() && text.back() != '\n') std::cout << "\n";
+            return true;
+        }
+        // Numbered, so a.bro in two directories gives two files
+        std::string name = std::to_string(index) + "_" + fs::path(job.path).stem().string() + ".out";
+        std::ofstream out(fs::path(outDir) / name, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Failed to open output file: " << (fs::path(outDir) / name).string() << "\n";
+            return false;
+        }
+        out << text;
+        return true;
+    }
+};
+
+// -----------------------------------------------------------------------------------
+// Function: printSummary
+// -----------------------------------------------------------------------------------
+void printSummary(const std::vector<Job>& jobs, double wallTime, unsigned threads) {
+    std::cout << "\n" << std::left << std::setw(15) << "status" << std::right << std::setw(14) << "instructions"
+              << std::setw(13) << "compile ms" << std::setw(11) << "run ms" << "  program\n";
+
+    size_t halted = 0, faults = 0, limits = 0, failed = 0;
+    uint64_t instructions = 0;
+    for (const Job& job : jobs) {
+        std::cout << std::left << std::setw(15) << statusOf(job) << std::right << std::setw(14)
+                  << job.result.instructions << std::setw(13) << job.compileTime << std::setw(11) << job.runTime
+                  << "  " << job.path << "\n";
+        instructions += job.result.instructions;
+        if (!job.compiled) ++failed;
+        else if (job.result.status == BroVM::Status::Halted) ++halted;
+        else if (job.result.status == BroVM::Status::Fault) ++faults;
+        else ++limits;
+    }
+
+    double seconds = wallTime / 1000;
+    std::cout << "\n" << jobs.size() << " programs on " << threads << " threads: " << halted << " halted, "
+              << faults << " faulted, " << limits << " hit the limit, " << failed << " failed to compile\n";
+    std::cout << "Wall time " << wallTime << " ms, " << std::setprecision(1)
+              << jobs.size() / seconds << " programs/s, " << instructions / seconds / 1e6
+              << " million instructions/s (" << instructions << " in total)\n";
+}
+
+// -----------------------------------------------------------------------------------
+// Function: main
+// -----------------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    std::vector<std::string> paths;
+    BroVM::CompileOptions compileOptions;
+    BroVM::RunOptions runOptions;
+    std::string outDir;
+    uint64_t maxOutput = 1 << 20;
+    runOptions.instructionLimit = 10000000;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.rfind("-j", 0) == 0) {
+                threads = static_cast<unsigned>(std::max(1, std::stoi(arg.substr(2))));
+            } else if (arg == "-O0") {
+                compileOptions.optimize = false;
+            } else if (arg.rfind("--limit=", 0) == 0) {
+                runOptions.instructionLimit = std::stoull(arg.substr(8));
+                if (runOptions.instructionLimit == 0) runOptions.instructionLimit = UINT64_MAX;
+            } else if (arg.rfind("--max-output=", 0) == 0) {
+                maxOutput = std::stoull(arg.substr(13));
+            } else if (arg.rfind("--out-dir=", 0) == 0) {
+                outDir = arg.substr(10);
+            } else if (arg.rfind("-", 0) == 0) {
+                std::cerr << "Unknown option: " << arg << "\n";
+                showUsage();
+                return 1;
+            } else {
+                paths.push_back(arg);
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value in option: " << arg << "\n";
+            return 1;
+        }
+    }
+    if (paths.empty()) {
+        showUsage();
+        return 1;
+    }
+
+    std::vector<Job> jobs;
+    if (!collectInputs(paths, jobs)) return 1;
+    if (jobs.empty()) {
+        std::cerr << "No .bro or .brobin files found\n";
+        return 1;
+    }
+    threads = std::min<unsigned>(threads, jobs.size());
+
+    OutputWriter writer(jobs, outDir);
+    if (!writer.prepare()) return 1;
+
+    // --- Workers take the next job until none are left ---
+    Clock::time_point start = Clock::now();
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (size_t i = next++; i < jobs.size(); i = next++) {
+                runJob(jobs[i], compileOptions, runOptions, maxOutput);
+                writer.finished(i);
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+    double wallTime = millisecondsSince(start);
+
+    if (!writer.ok()) return 1;
+    std::cout << std::fixed << std::setprecision(3);
+    printSummary(jobs, wallTime, threads);
+
+    bool allHalted = std::all_of(jobs.begin(), jobs.end(), [](const Job& job) {
+        return job.compiled && job.result.status == BroVM::Status::Halted;
+    });
+    return allHalted ? 0 : 1;
+}
@@ -0,0 +1,318 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brobin.cpp
+// Purpose:
+//   - Implements the `.brobin` image format described in brobin.h.
+//
+// What parse() guarantees:
+//   - Every header field agrees with the file size, the checksum matches, the
+//     code decodes into exactly `instruction count` instructions, and both
+//     sections fit in VM memory without overlapping. A damaged or truncated
+//     file is refused before anything reaches the VM.
+//   - DIV_NC, PUSH_NC and POP_NC appear only in images flagged as broc's
+//     output: in hand-made code they could divide by zero in the host.
+// =====================================================================================
+
+#include "brobin.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>       // rename
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap, munmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // close, write, unlink, getpid
+
+namespace {
+
+    constexpr uint8_t MAGIC[4] = {'B', 'R', 'O', 'B'};
+
+    void put16(std::vector<uint8_t>& out, uint16_t v) {
+        out.push_back(v & 0xFF);
+        out.push_back((v >> 8) & 0xFF);
+    }
+
+    void put32(std::vector<uint8_t>& out, uint32_t v) {
+        put16(out, v & 0xFFFF);
+        put16(out, (v >> 16) & 0xFFFF);
+    }
+
+    uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+    uint32_t get32(const uint8_t* p) { return get16(p) | (static_cast<uint32_t>(get16(p + 2)) << 16); }
+
+    bool isJump(Opcode op) {
+        return op == Opcode::JMP || op == Opcode::JZ || op == Opcode::JNZ;
+    }
+
+} // namespace
+
+namespace BroBin {
+
+    // ---------------------------------------------------------------------------------
+    // encode: the byte encoding shared by VM::loadProgram and the image's code section
+    // ---------------------------------------------------------------------------------
+    bool encode(const Instruction* program, size_t count, std::vector<uint8_t>& code) {
+        std::vector<uint32_t> address(count + 1, 0);
+        uint32_t offset = 0;
+        for (size_t i = 0; i < count; ++i) {
+            address[i] = offset;
+            offset += instructionSize(program[i].op);
+        }
+        address[count] = offset;
+        if (offset > Memory::SIZE) return false;
+
+        code.clear();
+        code.reserve(offset);
+        for (size_t i = 0; i < count; ++i) {
+            const Instruction& instr = program[i];
+            uint16_t a1 = instr.a1;
+            if (isJump(instr.op)) {
+                if (a1 > count) return false;
+                a1 = static_cast<uint16_t>(address[a1]);
+            }
+
+            uint8_t size = instructionSize(instr.op);
+            code.push_back(static_cast<uint8_t>(instr.op));
+            if (size >= 3) put16(code, a1);
+            if (size == 5) put16(code, instr.a2);
+        }
+        return true;
+    }
+
+    bool decode(const uint8_t* code, size_t size, std::vector<Instruction>& program) {
+        program.clear();
+        size_t at = 0;
+        while (at < size) {
+            Opcode op = static_cast<Opcode>(code[at]);
+            uint8_t length = instructionSize(op);
+            if (length == 0 || at + length > size) return false;
+
+            Instruction instr{op};
+            if (length >= 3) instr.a1 = get16(code + at + 1);
+            if (length == 5) instr.a2 = get16(code + at + 3);
+            program.push_back(instr);
+            at += length;
+        }
+        return true;
+    }
+
+    bool decodeProgram(const uint8_t* code, size_t size, std::vector<Instruction>& program) {
+        if (!decode(code, size, program)) return false;
+
+        std::vector<int> indexAt(size + 1, -1);
+        uint32_t address = 0;
+        for (size_t i = 0; i < program.size(); ++i) {
+            indexAt[address] = static_cast<int>(i);
+            address += instructionSize(program[i].op);
+        }
+        indexAt[size] = static_cast<int>(program.size());
+
+        for (auto& instr : program) {
+            if (!isJump(instr.op)) continue;
+            if (instr.a1 > size || indexAt[instr.a1] < 0) return false;
+            instr.a1 = static_cast<uint16_t>(indexAt[instr.a1]);
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // serialize / parse
+    // ---------------------------------------------------------------------------------
+    std::vector<uint8_t> serialize(const Image& image) {
+        std::vector<uint8_t> body(image.code);
+        body.insert(body.end(), image.data.begin(), image.data.end());
+        for (int statement : image.sourceMap) put32(body, static_cast<uint32_t>(statement));
+
+        std::vector<uint8_t> out;
+        out.reserve(HEADER_SIZE + body.size());
+        out.insert(out.end(), std::begin(MAGIC), std::end(MAGIC));
+        put16(out, VERSION);
+        put16(out, (image.sourceMap.empty() ? 0 : FLAG_SOURCE_MAP) | (image.unchecked ? FLAG_UNCHECKED : 0));
+        put32(out, static_cast<uint32_t>(image.code.size()));
+        put32(out, image.instructionCount);
+        put16(out, image.dataAddress);
+        put16(out, 0);
+        put32(out, static_cast<uint32_t>(image.data.size()));
+        put32(out, checksum(body.data(), body.size()));
+        put32(out, 0);
+        out.insert(out.end(), body.begin(), body.end());
+        return out;
+    }
+
+    bool parse(const uint8_t* bytes, size_t size, View& view, std::string& error) {
+        if (size < HEADER_SIZE || !std::equal(std::begin(MAGIC), std::end(MAGIC), bytes)) {
+            error = "not a .brobin image";
+            return false;
+        }
+        if (get16(bytes + 4) != VERSION) {
+            error = "unsupported version " + std::to_string(get16(bytes + 4));
+            return false;
+        }
+
+        uint16_t flags = get16(bytes + 6);
+        uint32_t codeSize = get32(bytes + 8);
+        uint32_t count = get32(bytes + 12);
+        uint16_t dataAddress = get16(bytes + 16);
+        uint32_t dataSize = get32(bytes + 20);
+        uint64_t mapSize = (flags & FLAG_SOURCE_MAP) ? 4ull * count : 0;
+
+        if (HEADER_SIZE + uint64_t(codeSize) + dataSize + mapSize != size) {
+            error = "section sizes do not match the file size";
+            return false;
+        }
+        const uint8_t* body = bytes + HEADER_SIZE;
+        if (checksum(body, size - HEADER_SIZE) != get32(bytes + 24)) {
+            error = "checksum mismatch";
+            return false;
+        }
+
+        std::vector<Instruction> program;
+        if (!decode(body, codeSize, program) || program.size() != count) {
+            error = "malformed code section";
+            return false;
+        }
+        bool unchecked = std::any_of(program.begin(), program.end(),
+                                     [](const Instruction& instr) { return isUnchecked(instr.op); });
+        if (unchecked && !(flags & FLAG_UNCHECKED)) {
+            error = "unchecked opcodes (DIV_NC, PUSH_NC, POP_NC) in an image broc did not produce";
+            return false;
+        }
+        if (dataAddress + uint64_t(dataSize) > Memory::SIZE || (dataSize > 0 && dataAddress < codeSize)) {
+            error = "data section does not fit in memory";
+            return false;
+        }
+
+        view.code = body;
+        view.codeSize = codeSize;
+        view.instructionCount = count;
+        view.dataAddress = dataAddress;
+        view.data = body + codeSize;
+        view.dataSize = dataSize;
+        view.sourceMap = mapSize ? body + codeSize + dataSize : nullptr;
+        view.unchecked = unchecked;
+        return true;
+    }
+
+    bool parse(const uint8_t* bytes, size_t size, Image& image, std::string& error) {
+        View view;
+        if (!parse(bytes, size, view, error)) return false;
+
+        image.code.assign(view.code, view.code + view.codeSize);
+        image.instructionCount = view.instructionCount;
+        image.dataAddress = view.dataAddress;
+        image.data.assign(view.data, view.data + view.dataSize);
+        image.sourceMap = view.decodeSourceMap();
+        image.unchecked = view.unchecked;
+        return true;
+    }
+
+    std::vector<int> View::decodeSourceMap() const {
+        std::vector<int> out;
+        if (!sourceMap) return out;
+        out.reserve(instructionCount);
+        for (uint32_t i = 0; i < instructionCount; ++i)
+            out.push_back(static_cast<int32_t>(get32(sourceMap + 4 * i)));
+        return out;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // MappedFile
+    // ---------------------------------------------------------------------------------
+    std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path, std::string& error) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error = "can not be opened";
+            return nullptr;
+        }
+
+        struct stat info;
+        std::shared_ptr<MappedFile> file(new MappedFile);
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            file->length = static_cast<size_t>(info.st_size);
+            file->base = mmap(nullptr, file->length, PROT_READ, MAP_SHARED, fd, 0);
+            if (file->base == MAP_FAILED) file->base = nullptr;
+        }
+        ::close(fd);  // The mapping stays valid without the descriptor
+
+        if (file->base) return file;
+        error = "can not be mapped";
+        return nullptr;
+    }
+
+    MappedFile::~MappedFile() {
+        if (base) munmap(base, length);
+    }
+
+    // ---------------------------------------------------------------------------------
+    // write / read
+    // ---------------------------------------------------------------------------------
+    bool write(const std::string& path, const Image& image) {
+        return replaceFile(path, serialize(image));
+    }
+
+    bool read(const std::string& path, Image& image) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "Failed to open image: " << path << "\n";
+            return false;
+        }
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        std::string error;
+        if (!parse(bytes.data(), bytes.size(), image, error)) {
+            std::cerr << "Invalid image " << path << ": " << error << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool replaceFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+        // Created with the usual mode (0666 less the umask) from the start; the
+        // name is new to this call, and O_EXCL skips one that exists anyway
+        std::random_device random;
+        std::string temporary;
+        int fd = -1;
+        for (int attempt = 0; fd < 0 && attempt < 16; ++attempt) {
+            temporary = path + "." + std::to_string(getpid()) + "." + std::to_string(random()) + ".tmp";
+            fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+            if (fd < 0 && errno != EEXIST) break;
+        }
+        if (fd < 0) {
+            std::cerr << "Failed to open output file: " << path << "\n";
+            return false;
+        }
+
+        const uint8_t* at = bytes.data();
+        size_t left = bytes.size();
+        while (left > 0) {
+            ssize_t written = ::write(fd, at, left);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) break;
+            at += written;
+            left -= static_cast<size_t>(written);
+        }
+        bool ok = left == 0;
+        if (::close(fd) != 0) ok = false;
+        if (ok && std::rename(temporary.c_str(), path.c_str()) != 0) ok = false;
+        if (!ok) {
+            std::cerr << "Failed to write output file: " << path << "\n";
+            ::unlink(temporary.c_str());
+        }
+        return ok;
+    }
+
+    uint32_t checksum(const uint8_t* bytes, size_t size) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+} // namespace BroBin
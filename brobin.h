@@ -0,0 +1,146 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brobin.h
+// Purpose:
+//   - Declares the `.brobin` bytecode image: a compiled program as one binary
+//     file that VM::loadImage runs directly, so changing a program no longer
+//     means rebuilding the runner around a new prog.cpp.
+//
+// Layout (integers little-endian):
+//   offset  size  field
+//   0       4     magic "BROB"
+//   4       2     version (VERSION)
+//   6       2     flags (bit 0: source map present, bit 1: written by the compiler,
+//                 which may use the unchecked opcodes)
+//   8       4     code size in bytes
+//   12      4     instruction count
+//   16      2     data address (where the data section is loaded)
+//   18      2     reserved (0)
+//   20      4     data size in bytes
+//   24      4     checksum: FNV-1a over every byte after the header
+//   28      4     reserved (0)
+//   32      ...   code: the exact bytes VM::loadProgram writes to memory
+//                 (jump operands already byte addresses)
+//   ...     ...   data: string literals (Codegen::getData)
+//   ...     ...   source map: 4 bytes (int32) per instruction, if flagged
+//
+// Workflow:
+//   ./broc prog.bro -o prog.brobin
+//   ./run_bro prog.brobin
+//
+// Running in place:
+//   - MappedFile maps a file read-only (MAP_SHARED) and the VM fetches
+//     instructions straight from the mapping: the code is read once to be
+//     checked but never copied, and every process running the same image
+//     shares one physical copy of it through the page cache. Images packed
+//     into an archive (broarchive.h) run the same way.
+// =====================================================================================
+
+#pragma once
+
+#include "RohitVM.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace BroBin {
+
+    constexpr uint16_t VERSION = 1;
+    constexpr size_t HEADER_SIZE = 32;
+    constexpr uint16_t FLAG_SOURCE_MAP = 0x0001;
+    constexpr uint16_t FLAG_UNCHECKED = 0x0002;     // DIV_NC / PUSH_NC / POP_NC allowed
+
+    // ---------------------------------------------------------------------------------
+    // Struct: Image
+    // Purpose: The sections of a `.brobin` file, in memory
+    // ---------------------------------------------------------------------------------
+    struct Image {
+        std::vector<uint8_t> code;                   // Loaded at address 0
+        uint32_t instructionCount = 0;
+        uint16_t dataAddress = Memory::DATA_BASE;
+        std::vector<uint8_t> data;
+        std::vector<int> sourceMap;                  // Empty, or a statement id per instruction
+        bool unchecked = false;                      // Set by broc: may use the _NC opcodes
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Struct: View
+    // Purpose: The same sections, pointing into a file held elsewhere (no copies)
+    // ---------------------------------------------------------------------------------
+    struct View {
+        const uint8_t* code = nullptr;
+        uint32_t codeSize = 0;
+        uint32_t instructionCount = 0;
+        uint16_t dataAddress = Memory::DATA_BASE;
+        const uint8_t* data = nullptr;
+        uint32_t dataSize = 0;
+        const uint8_t* sourceMap = nullptr;          // instructionCount int32s, or nullptr
+        bool unchecked = false;                      // Code uses DIV_NC / PUSH_NC / POP_NC
+
+        std::vector<int> decodeSourceMap() const;
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Class: MappedFile
+    // Purpose: A file mapped read-only, unmapped with the last reference
+    // ---------------------------------------------------------------------------------
+    class MappedFile {
+    public:
+        // nullptr, with `error` set, if the file can not be opened or is empty
+        static std::shared_ptr<const MappedFile> open(const std::string& path, std::string& error);
+
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const uint8_t* data() const { return static_cast<const uint8_t*>(base); }
+        size_t size() const { return length; }
+
+    private:
+        MappedFile() = default;
+
+        void* base = nullptr;
+        size_t length = 0;
+    };
+
+    // Lays `program` out the way VM::loadProgram does, turning jump targets
+    // (instruction indexes) into byte addresses; false if a target or the
+    // total size is out of range
+    bool encode(const Instruction* program, size_t count, std::vector<uint8_t>& code);
+    inline bool encode(const std::vector<Instruction>& program, std::vector<uint8_t>& code) {
+        return encode(program.data(), program.size(), code);
+    }
+
+    // Decodes the instructions of an encoded code section; false at a byte
+    // that is not an opcode or an instruction cut off by the end
+    bool decode(const uint8_t* code, size_t size, std::vector<Instruction>& program);
+
+    // The inverse of encode: decodes, then turns jump operands back into
+    // instruction indexes; also false for a jump into the middle of an instruction
+    bool decodeProgram(const uint8_t* code, size_t size, std::vector<Instruction>& program);
+
+    // The whole file, header included
+    std::vector<uint8_t> serialize(const Image& image);
+
+    // Checks and splits a file held in memory; on failure `error` says why.
+    // Unchecked opcodes are refused unless the image carries FLAG_UNCHECKED.
+    bool parse(const uint8_t* bytes, size_t size, View& view, std::string& error);
+    bool parse(const uint8_t* bytes, size_t size, Image& image, std::string& error);
+
+    // Write / read a file; both print an error and return false on failure
+    bool write(const std::string& path, const Image& image);
+    bool read(const std::string& path, Image& image);
+
+    // Writes `bytes` to a new file beside `path`, then renames it over `path`:
+    // a VM still running the old file from its mapping keeps its old bytes,
+    // instead of seeing them rewritten (or cut off) under it. Prints an error
+    // and returns false on failure.
+    bool replaceFile(const std::string& path, const std::vector<uint8_t>& bytes);
+
+    // 32-bit FNV-1a
+    uint32_t checksum(const uint8_t* bytes, size_t size);
+
+} // namespace BroBin
@@ -7,19 +7,27 @@
 //   - This is the main driver for the **Brolang compiler**.
 //   - It reads a `.bro` source file, tokenizes it, parses it into an AST,
 //     generates bytecode, and finally emits that bytecode as a C++ file
-//     runnable on the RohitVM.
+//     runnable on the RohitVM (or, for an output ending in .brobin, as a
+//     binary image that run_bro loads directly, see brobin.h; for one ending
+//     in .broo, as an object file for brolink, see broobj.h).
+//   - With --target=x86_64 it writes x86-64 assembly instead (x86backend.h)
+//     and links it into a native executable with the system C compiler.
 // Phases:
 //   1. Read source code
 //   2. Lexical analysis (tokenization)
 //   3. Parsing (build AST)
-//   4. Code Generation (convert AST → VM instructions)
-//   5. Emission (write the instructions to a .cpp file)
+//   4. Optimization (AST passes, see optimizer.h)
+//   5. Code Generation (convert AST → VM instructions, then jump threading)
+//   6. Emission (write the instructions to a .cpp file, a .brobin image or a .broo object)
 // ===================================================================================
 
 #include "lexer.h"     // Lexical analysis (tokens)
 #include "parser.h"    // Parsing to AST
+#include "optimizer.h" // AST optimization passes
 #include "codegen.h"   // AST to VM instruction generation
 #include "emitter.h"   // Writes VM instructions to C++ output
+#include "broobj.h"    // Object files for separate compilation
+#include "x86backend.h" // Native code for --target=x86_64
 
 #include <iostream>
 #include <fstream>
@@ -31,7 +39,18 @@
 // -----------------------------------------------------------------------------------
 void showUsage() {
     std::cout << "Usage:\n";
-    std::cout << "  ./broc input.bro -o output/prog.cpp\n";
+    std::cout << "  ./broc input.bro -o output/prog.cpp [options]\n";
+    std::cout << "  ./broc input.bro -o output/prog.brobin [options]   (binary image for run_bro)\n";
+    std::cout << "  ./broc input.bro -o output/part.broo [options]     (object file for brolink)\n";
+    std::cout << "Options:\n";
+    std::cout << "  -O0                Disable all optimization passes\n";
+    std::cout << "  --unroll=N         Body copies per partially unrolled loop (1 = off, default 4)\n";
+    std::cout << "  --code-budget=N    Stop unrolling before the code reaches N bytes\n";
+    std::cout << "  --partial-eval     Run the program at compile time and emit its output\n";
+    std::cout << "  --fuel=N           VM instructions --partial-eval may simulate (default 1000000)\n";
+    std::cout << "  --profile-use=F    Lay out code for the branch counts in profile F (see profile.h)\n";
+    std::cout << "  --target=T         vm (default: C++ bytecode for RohitVM) or x86_64 (native executable;\n";
+    std::cout << "                     an output ending in .s gets the assembly only)\n";
 }
 
 // -----------------------------------------------------------------------------------
@@ -56,11 +75,11 @@ std::string readFile(const std::string& path) {
 // Steps:
 //   1. Validate command-line args
 //   2. Read the source file
-//   3. Lexing → Parsing → Codegen → Emission
+//   3. Lexing → Parsing → Optimization → Codegen → Emission
 // -----------------------------------------------------------------------------------
 int main(int argc, char* argv[]) {
     // ------------------ Step 0: Validate command-line args ------------------
-    if (argc != 4 || std::string(argv[2]) != "-o") {
+    if (argc < 4 || std::string(argv[2]) != "-o") {
         showUsage();
         return 1;
     }
@@ -68,6 +87,52 @@ int main(int argc, char* argv[]) {
     std::string inputFile = argv[1];
     std::string outputFile = argv[3];
 
+    OptimizerOptions options;
+    std::string profilePath;
+    bool native = false;
+    for (int i = 4; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "-O0") {
+                options = OptimizerOptions::none();
+            } else if (arg.rfind("--unroll=", 0) == 0) {
+                options.unrollFactor = std::stoi(arg.substr(9));
+            } else if (arg.rfind("--code-budget=", 0) == 0) {
+                options.codeBudget = std::stoi(arg.substr(14));
+            } else if (arg == "--partial-eval") {
+                options.partialEval = true;
+            } else if (arg.rfind("--fuel=", 0) == 0) {
+                options.fuel = std::stol(arg.substr(7));
+            } else if (arg.rfind("--profile-use=", 0) == 0) {
+                profilePath = arg.substr(14);
+            } else if (arg == "--target=x86_64") {
+                native = true;
+            } else if (arg == "--target=vm") {
+                native = false;
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                showUsage();
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value in option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    bool object = outputFile.size() > 5 && outputFile.compare(outputFile.size() - 5, 5, ".broo") == 0;
+    if (object && (native || options.partialEval)) {
+        // Partial evaluation assumes zeroed arrays, which another module may have filled
+        std::cerr << "A .broo object can not be built with --target=x86_64 or --partial-eval\n";
+        return 1;
+    }
+
+    Profile profile;
+    if (!profilePath.empty()) {
+        if (!profile.load(profilePath)) return 1;
+        options.profile = &profile;
+    }
+
     try {
         // ------------------ Step 1: Read Source Code ------------------
         std::string source = readFile(inputFile);
@@ -84,13 +149,51 @@ int main(int argc, char* argv[]) {
         // ------------------ Step 3: Parse Tokens into AST ------------------
         Parser parser(tokens);
         Program program = parser.parseProgram();
+        if (parser.getErrorCount() > 0) {
+            std::cerr << "Compilation failed: " << parser.getErrorCount() << " error(s)\n";
+            return 1;
+        }
+
+        // ------------------ Step 4: Optimize the AST ------------------
+        Optimizer::run(program, options);
+
+        if (native) {
+            X86Backend backend(options.elideChecks);
+            if (!X86Backend::writeExecutable(backend.generate(program), outputFile)) return 1;
+            std::cout << "✅ Compilation complete.\n";
+            return 0;
+        }
 
-        // ------------------ Step 4: Generate VM Instructions ------------------
-        Codegen codegen;
+        // ------------------ Step 5: Generate VM Instructions ------------------
+        Codegen codegen(options.profile, options.elideChecks);
         std::vector<Instruction> bytecode = codegen.generate(program);
+        if (codegen.getErrorCount() > 0) {
+            std::cerr << "Compilation failed: " << codegen.getErrorCount() << " error(s)\n";
+            return 1;
+        }
+        std::vector<int> sourceMap = codegen.getSourceMap();
+        Optimizer::run(bytecode, sourceMap, options);
+
+        // ------------------ Step 6: Emit to C++ Source File (or image, or object) ------------------
+        if (object) {
+            BroObj::Module module;
+            std::string error;
+            if (!BroObj::fromCodegen(bytecode, sourceMap, codegen, module, error)) {
+                std::cerr << "Compiler error: " << error << "\n";
+                return 1;
+            }
+            if (!BroObj::write(outputFile, module)) return 1;
+            std::cout << "Wrote object file to " << outputFile << "\n";
+            std::cout << "✅ Compilation complete.\n";
+            return 0;
+        }
 
-        // ------------------ Step 5: Emit to C++ Source File ------------------
-        if (!Emitter::writeToFile(outputFile, bytecode)) {
+        bool image = outputFile.size() > 7 && outputFile.compare(outputFile.size() - 7, 7, ".brobin") == 0;
+        bool written = image
+            ? Emitter::writeImage(outputFile, bytecode, sourceMap, codegen.getDataAddress(), codegen.getData(),
+                                  options.elideChecks)
+            : Emitter::writeToFile(outputFile, bytecode, sourceMap, codegen.getDataAddress(), codegen.getData());
+        if (!written) {
             return 1; // Failed to write
         }
 
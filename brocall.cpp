@@ -0,0 +1,214 @@
+// ===================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brocall.cpp
+// Purpose:
+//   - Client for brod (broservice.h): sends a `.bro` source or `.brobin` image,
+//     prints the output as it streams back, and exits 0 only if the program
+//     halted. `--stats` prints the daemon's counters and latencies instead.
+//   - `--repeat=N --clients=C` turns it into a load generator: C threads send
+//     the program N times in total and the client-side requests per second
+//     and p50/p99 latency are printed.
+//
+// Usage:
+//   ./brocall test.bro [--socket=/tmp/brod.sock] [--limit=N] [--max-output=BYTES]
+//   ./brocall test.bro --repeat=10000 --clients=64
+//   ./brocall --stats
+//
+// Build:
+//   g++ brocall.cpp broservice.cpp -pthread -o brocall
+// ===================================================================================
+
+#include "broservice.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct Reply {
+        std::string status;         // As sent by brod, or "error" if the exchange failed
+        uint64_t instructions = 0;
+        std::string message;
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Function: call
+    // Purpose: One request; output frames go to `output` (nullptr: dropped)
+    // ---------------------------------------------------------------------------------
+    Reply call(const std::string& socketPath, const BroService::Request& request, std::ostream* output) {
+        Reply reply;
+        reply.status = "error";
+        int fd = BroService::connectTo(socketPath, reply.message);
+        if (fd < 0) return reply;
+        if (!BroService::writeRequest(fd, request)) {
+            reply.message = "failed to send the request";
+            ::close(fd);
+            return reply;
+        }
+
+        BroService::Reader in(fd);
+        std::string header, body;
+        reply.message = "connection closed before the end of the reply";
+        while (in.line(header)) {
+            std::istringstream fields(header);
+            std::string kind;
+            size_t size = 0;
+            fields >> kind;
+            if (kind == "out" && fields >> size && in.exact(body, size)) {
+                if (output) output->write(body.data(), body.size()).flush();
+            } else if (kind == "end" && fields >> reply.status >> reply.instructions >> size &&
+                       in.exact(reply.message, size)) {
+                break;
+            } else {
+                reply.status = "error";
+                reply.message = "malformed reply: " + header;
+                break;
+            }
+        }
+        ::close(fd);
+        return reply;
+    }
+
+    double percentile(std::vector<double> values, double rank) {
+        if (values.empty()) return 0;
+        size_t at = std::min(values.size() - 1, static_cast<size_t>(rank * values.size()));
+        std::nth_element(values.begin(), values.begin() + at, values.end());
+        return values[at];
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Function: loadTest
+    // ---------------------------------------------------------------------------------
+    int loadTest(const std::string& socketPath, const BroService::Request& request, size_t repeat, unsigned clients) {
+        std::atomic<size_t> next{0};
+        std::mutex mutex;
+        std::vector<double> latencies;
+        std::map<std::string, size_t> statuses;
+
+        Clock::time_point start = Clock::now();
+        std::vector<std::thread> threads;
+        for (unsigned c = 0; c < clients; ++c) {
+            threads.emplace_back([&] {
+                std::vector<double> mine;
+                std::map<std::string, size_t> seen;
+                while (next++ < repeat) {
+                    Clock::time_point sent = Clock::now();
+                    Reply reply = call(socketPath, request, nullptr);
+                    mine.push_back(millisecondsSince(sent));
+                    ++seen[reply.status];
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                latencies.insert(latencies.end(), mine.begin(), mine.end());
+                for (const auto& [status, count] : seen) statuses[status] += count;
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+        double seconds = millisecondsSince(start) / 1000;
+
+        std::cout << std::fixed << std::setprecision(1) << repeat << " requests from " << clients << " clients in "
+                  << seconds << " s: " << repeat / seconds << " req/s" << std::setprecision(3) << ", p50 "
+                  << percentile(latencies, 0.50) << " ms, p99 " << percentile(latencies, 0.99) << " ms\n";
+        for (const auto& [status, count] : statuses) std::cout << "  " << count << " " << status << "\n";
+        return statuses.size() == 1 && statuses.count("halted") ? 0 : 1;
+    }
+
+} // namespace
+
+// -----------------------------------------------------------------------------------
+// Function: showUsage
+// -----------------------------------------------------------------------------------
+void showUsage() {
+    std::cout << "Usage:\n";
+    std::cout << "  ./brocall prog.bro|prog.brobin [options]   Run on brod, streaming the output\n";
+    std::cout << "  ./brocall --stats [--socket=PATH]          Print brod's request counts and latencies\n";
+    std::cout << "Options:\n";
+    std::cout << "  --socket=PATH         brod's socket (default " << BroService::DEFAULT_SOCKET << ")\n";
+    std::cout << "  --limit=N             Instruction quota for this request (default: brod's)\n";
+    std::cout << "  --max-output=BYTES    Output quota for this request (default: brod's)\n";
+    std::cout << "  --repeat=N            Send the program N times, print throughput and latency\n";
+    std::cout << "  --clients=C           Concurrent connections while repeating (default 1)\n";
+}
+
+// -----------------------------------------------------------------------------------
+// Function: main
+// -----------------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    std::string socketPath = BroService::DEFAULT_SOCKET;
+    std::string inputFile;
+    BroService::Request request;
+    size_t repeat = 0;
+    unsigned clients = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.rfind("--socket=", 0) == 0) {
+                socketPath = arg.substr(9);
+            } else if (arg == "--stats") {
+                request.kind = "stats";
+            } else if (arg.rfind("--limit=", 0) == 0) {
+                request.instructionLimit = std::stoull(arg.substr(8));
+            } else if (arg.rfind("--max-output=", 0) == 0) {
+                request.outputLimit = std::stoull(arg.substr(13));
+            } else if (arg.rfind("--repeat=", 0) == 0) {
+                repeat = std::stoull(arg.substr(9));
+            } else if (arg.rfind("--clients=", 0) == 0) {
+                clients = static_cast<unsigned>(std::max(1, std::stoi(arg.substr(10))));
+            } else if (arg.rfind("-", 0) == 0) {
+                std::cerr << "Unknown option: " << arg << "\n";
+                showUsage();
+                return 1;
+            } else {
+                inputFile = arg;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value in option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if (request.kind != "stats") {
+        if (inputFile.empty()) {
+            showUsage();
+            return 1;
+        }
+        std::ifstream in(inputFile, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "Failed to open input file: " << inputFile << "\n";
+            return 1;
+        }
+        request.payload.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        bool image = inputFile.size() > 7 && inputFile.compare(inputFile.size() - 7, 7, ".brobin") == 0;
+        request.kind = image ? "image" : "source";
+        if (repeat > 0) return loadTest(socketPath, request, repeat, clients);
+    }
+
+    Reply reply = call(socketPath, request, &std::cout);
+    if (request.kind == "stats") std::cout << reply.message;
+    if (reply.status == "halted") return 0;
+    std::cerr << "brocall: " << reply.status;
+    if (reply.status != "error" && reply.status != "rejected" && reply.status != "compile-error")
+        std::cerr << " after " << reply.instructions << " instructions";
+    if (!reply.message.empty()) std::cerr << ": " << reply.message;
+    if (reply.message.empty() || reply.message.back() != '\n') std::cerr << "\n";
+    return 1;
+}
@@ -0,0 +1,558 @@
+// ===================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brod.cpp
+// Purpose:
+//   - Runs BroLang for other local processes without a process spawn per
+//     request: a daemon that takes source or `.brobin` images on a Unix
+//     socket (protocol in broservice.h) and runs them on a pool of worker
+//     threads, each compiling and running through libbrovm (brovm.h).
+//   - Output is streamed back in frames while the program runs.
+//   - Images may come from anyone: BroVM::loadImage runs their DIV_NC, PUSH_NC
+//     and POP_NC as the checked DIV, PUSH and POP.
+//
+// Quotas (per request; a client may ask for less, never more):
+//   - --max-instructions: the VM stops the program with status `limit`.
+//   - --max-request: bytes of source or image the daemon will take in, checked
+//     before the payload is read. With output streamed rather than collected,
+//     this is what bounds the memory a request holds: every VM has the same
+//     fixed 64 KB address space (RohitVM.hpp), and compiled code must fit it.
+//   - --max-output: bytes streamed back before the program is stopped (fault).
+//   - --request-timeout: seconds from accept for the whole request to arrive;
+//     a slower client is answered `rejected`.
+//
+// Serving many small requests:
+//   - Requests are read on the accepting thread, polling every connection,
+//     and only complete ones are queued for the workers: an idle or slow
+//     client holds a socket, never a worker. Past --max-queue connections
+//     (being read or waiting for a worker) a new one is answered `rejected`.
+//   - Compiled programs are cached by a keyed hash of their source, so a
+//     program sent again is not compiled again: handles are immutable and
+//     shared between workers, and the cache holds no payloads.
+//   - Latency (accept to last frame) is sampled for p50/p99 and printed with
+//     requests per second every --report seconds, on exit, and to `stats`.
+//
+// Usage:
+//   ./brod [--socket=/tmp/brod.sock] [-jN] [--max-instructions=N] [--max-request=BYTES]
+//          [--max-output=BYTES] [--max-queue=N] [--request-timeout=SEC] [--report=SECONDS]
+//
+// Build:
+//   g++ brod.cpp broservice.cpp brovm.cpp lexer.cpp parser.cpp astutils.cpp licm.cpp strength.cpp cse.cpp unroll.cpp evaluator.cpp jumpthread.cpp cfg.cpp blocklayout.cpp range.cpp boundscheck.cpp optimizer.cpp profile.cpp codegen.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp -pthread -o brod
+// ===================================================================================
+
+#include "broservice.h"
+#include "brovm.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void onStopSignal(int) { stopRequested = 1; }
+
+    struct Settings {
+        std::string socketPath = BroService::DEFAULT_SOCKET;
+        unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+        uint64_t maxInstructions = 10000000;
+        size_t maxRequest = 1 << 20;
+        uint64_t maxOutput = 1 << 20;
+        size_t maxQueue = 4096;
+        int requestSeconds = 5;
+        int reportSeconds = 10;
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Class: Stats
+    // Purpose: Request counts, and recent latencies for the percentiles
+    // ---------------------------------------------------------------------------------
+    class Stats {
+    public:
+        static constexpr size_t SAMPLES = 65536;   // Latencies kept (the most recent)
+
+        void record(const std::string& status, double milliseconds) {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++total;
+            ++byStatus[status];
+            if (latencies.size() < SAMPLES) latencies.push_back(milliseconds);
+            else latencies[total % SAMPLES] = milliseconds;
+            ++windowCount;
+            if (windowLatencies.size() < SAMPLES) windowLatencies.push_back(milliseconds);
+        }
+
+        // Totals since start plus p50/p99 over the recent samples
+        std::string summary() {
+            std::lock_guard<std::mutex> lock(mutex);
+            double seconds = millisecondsSince(started) / 1000;
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(3);
+            out << total << " requests in " << seconds << " s (" << std::setprecision(1) << total / seconds
+                << " req/s)";
+            for (const auto& [status, count] : byStatus) out << ", " << count << " " << status;
+            out << std::setprecision(3) << "; latency p50 " << percentile(latencies, 0.50) << " ms, p99 "
+                << percentile(latencies, 0.99) << " ms\n";
+            return out.str();
+        }
+
+        // Requests since the last report, for the periodic line on stderr
+        std::string report() {
+            std::lock_guard<std::mutex> lock(mutex);
+            double seconds = millisecondsSince(windowStart) / 1000;
+            std::ostringstream out;
+            out << std::fixed << std::setprecision(1) << "brod: " << windowCount << " requests, "
+                << windowCount / seconds << " req/s" << std::setprecision(3) << ", p50 "
+                << percentile(windowLatencies, 0.50) << " ms, p99 " << percentile(windowLatencies, 0.99) << " ms\n";
+            windowLatencies.clear();
+            windowCount = 0;
+            windowStart = Clock::now();
+            return out.str();
+        }
+
+    private:
+        std::mutex mutex;
+        Clock::time_point started = Clock::now();
+        Clock::time_point windowStart = started;
+        uint64_t total = 0;
+        uint64_t windowCount = 0;
+        std::map<std::string, uint64_t> byStatus;
+        std::vector<double> latencies;
+        std::vector<double> windowLatencies;
+
+        static double percentile(std::vector<double> values, double rank) {
+            if (values.empty()) return 0;
+            size_t at = std::min(values.size() - 1, static_cast<size_t>(rank * values.size()));
+            std::nth_element(values.begin(), values.begin() + at, values.end());
+            return values[at];
+        }
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Function: sipHash
+    // Purpose: SipHash-2-4 of `bytes` under a 128-bit key. Clients choose the
+    //          payloads, so the cache key must be a hash they can not aim
+    //          collisions at without knowing the key.
+    // ---------------------------------------------------------------------------------
+    uint64_t sipHash(const uint64_t key[2], const std::string& bytes) {
+        uint64_t v0 = key[0] ^ 0x736f6d6570736575ULL;
+        uint64_t v1 = key[1] ^ 0x646f72616e646f6dULL;
+        uint64_t v2 = key[0] ^ 0x6c7967656e657261ULL;
+        uint64_t v3 = key[1] ^ 0x7465646279746573ULL;
+        auto rotl = [](uint64_t x, int b) { return (x << b) | (x >> (64 - b)); };
+        auto round = [&] {
+            v0 += v1; v1 = rotl(v1, 13); v1 ^= v0; v0 = rotl(v0, 32);
+            v2 += v3; v3 = rotl(v3, 16); v3 ^= v2;
+            v0 += v3; v3 = rotl(v3, 21); v3 ^= v0;
+            v2 += v1; v1 = rotl(v1, 17); v1 ^= v2; v2 = rotl(v2, 32);
+        };
+        auto mix = [&](uint64_t m) {
+            v3 ^= m;
+            round();
+            round();
+            v0 ^= m;
+        };
+
+        // Little-endian 8-byte words, then the tail with the length in the top byte
+        size_t size = bytes.size();
+        size_t whole = size - size % 8;
+        for (size_t at = 0; at < whole; at += 8) {
+            uint64_t m = 0;
+            for (int i = 7; i >= 0; --i) m = (m << 8) | static_cast<uint8_t>(bytes[at + i]);
+            mix(m);
+        }
+        uint64_t last = static_cast<uint64_t>(size) << 56;
+        for (size_t i = whole; i < size; ++i)
+            last |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[i])) << (8 * (i - whole));
+        mix(last);
+
+        v2 ^= 0xff;
+        for (int i = 0; i < 4; ++i) round();
+        return v0 ^ v1 ^ v2 ^ v3;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Class: ProgramCache
+    // Purpose: Compiled programs by request kind and a keyed hash of the payload;
+    //          emptied when full. Only the hash and size are kept, never the payload.
+    // ---------------------------------------------------------------------------------
+    class ProgramCache {
+    public:
+        static constexpr size_t CAPACITY = 1024;
+
+        struct Key {
+            bool image = false;
+            uint64_t size = 0;
+            uint64_t hash = 0;
+
+            bool operator==(const Key& other) const {
+                return image == other.image && size == other.size && hash == other.hash;
+            }
+        };
+
+        ProgramCache() {
+            std::random_device random;
+            for (uint64_t& word : secret) word = (static_cast<uint64_t>(random()) << 32) ^ random();
+        }
+
+        Key keyFor(const BroService::Request& request) const {
+            return {request.kind == "image", request.payload.size(), sipHash(secret, request.payload)};
+        }
+
+        BroVM::ProgramHandle find(const Key& key) {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = programs.find(key);
+            return it == programs.end() ? nullptr : it->second;
+        }
+
+        void add(const Key& key, const BroVM::ProgramHandle& program) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (programs.size() >= CAPACITY) programs.clear();
+            programs.emplace(key, program);
+        }
+
+    private:
+        struct KeyHash {
+            size_t operator()(const Key& key) const { return static_cast<size_t>(key.hash); }
+        };
+
+        uint64_t secret[2];         // Random per daemon, so the hashes can not be predicted
+        std::mutex mutex;
+        std::unordered_map<Key, BroVM::ProgramHandle, KeyHash> programs;
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Class: FrameStream
+    // Purpose: VM output, sent as `out` frames whenever 4 KB are buffered (and at
+    //          the end); throws past the output quota or once the client is gone,
+    //          which stops the program (RunOptions::output)
+    // ---------------------------------------------------------------------------------
+    class FrameStream : public std::streambuf {
+    public:
+        FrameStream(int fd, uint64_t limit) : fd(fd), limit(limit) { setp(buffer, buffer + sizeof(buffer)); }
+
+        bool flush() { return send(); }
+
+    protected:
+        int overflow(int c) override {
+            if (!send()) throw std::runtime_error("Client went away");
+            if (c != traits_type::eof()) {
+                *pptr() = static_cast<char>(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override { return send() ? 0 : -1; }
+
+    private:
+        int fd;
+        uint64_t limit;
+        uint64_t sent = 0;
+        char buffer[4096];
+
+        // The bytes up to the quota still go out before the exception
+        bool send() {
+            size_t size = pptr() - pbase();
+            setp(buffer, buffer + sizeof(buffer));
+            bool over = sent + size > limit;
+            if (over) size = static_cast<size_t>(limit - sent);
+            sent += size;
+            bool delivered = size == 0 || BroService::writeFrame(fd, "out", buffer, size);
+            if (over) throw std::runtime_error("Output limit exceeded");
+            return delivered;
+        }
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Class: Server
+    // ---------------------------------------------------------------------------------
+    class Server {
+    public:
+        explicit Server(const Settings& settings) : settings(settings) {}
+
+        int run();
+
+    private:
+        struct Connection {
+            int fd;
+            Clock::time_point accepted;
+            BroService::Request request;
+        };
+
+        // A connection whose request is still arriving
+        struct Pending {
+            int fd;
+            Clock::time_point accepted;
+            BroService::RequestBuffer buffer;
+        };
+
+        Settings settings;
+        Stats stats;
+        ProgramCache cache;
+        std::mutex queueMutex;
+        std::condition_variable queueReady;
+        std::deque<Connection> queue;
+        bool stopping = false;
+
+        void work();
+        std::string serve(int fd, const BroService::Request& request);
+        void readPending(std::vector<Pending>& pending, const std::vector<pollfd>& ready);
+        void reject(int fd, const std::string& message, Clock::time_point accepted);
+        void finish(int fd, const std::string& status, uint64_t instructions, const std::string& message);
+    };
+
+    void Server::finish(int fd, const std::string& status, uint64_t instructions, const std::string& message) {
+        BroService::writeFrame(fd, "end " + status + " " + std::to_string(instructions), message.data(),
+                               message.size());
+    }
+
+    // Answers a connection the workers never see, and closes it
+    void Server::reject(int fd, const std::string& message, Clock::time_point accepted) {
+        finish(fd, "rejected", 0, message);
+        ::close(fd);
+        stats.record("rejected", millisecondsSince(accepted));
+    }
+
+    // One complete request on `fd`; returns the status it ended with
+    std::string Server::serve(int fd, const BroService::Request& request) {
+        if (request.kind == "stats") {
+            finish(fd, "halted", 0, stats.summary());
+            return "stats";
+        }
+
+        // --- Compile, or reuse the program compiled for the same payload ---
+        ProgramCache::Key key = cache.keyFor(request);
+        BroVM::ProgramHandle program = cache.find(key);
+        if (!program) {
+            BroVM::CompileResult compiled = request.kind == "image"
+                ? BroVM::loadImage(reinterpret_cast<const uint8_t*>(request.payload.data()), request.payload.size())
+                : BroVM::compile(request.payload);
+            if (!compiled.program) {
+                finish(fd, "compile-error", 0, compiled.diagnostics);
+                return "compile-error";
+            }
+            program = compiled.program;
+            cache.add(key, program);
+        }
+
+        // --- Run, streaming the output ---
+        auto clamp = [](uint64_t asked, uint64_t most) { return asked == 0 ? most : std::min(asked, most); };
+        FrameStream frames(fd, clamp(request.outputLimit, settings.maxOutput));
+        std::ostream output(&frames);
+        output.exceptions(std::ios::badbit);
+
+        BroVM::RunOptions options;
+        options.instructionLimit = clamp(request.instructionLimit, settings.maxInstructions);
+        options.output = &output;
+        BroVM::RunResult result = BroVM::Engine::run(program, options);
+
+        std::string status = result.status == BroVM::Status::Halted ? "halted"
+                           : result.status == BroVM::Status::LimitExceeded ? "limit" : "fault";
+        try {
+            frames.flush();
+        } catch (const std::exception& ex) {
+            status = "fault";
+            result.error = ex.what();
+        }
+        finish(fd, status, result.instructions, result.error);
+        return status;
+    }
+
+    void Server::work() {
+        while (true) {
+            Connection connection;
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueReady.wait(lock, [&] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;
+                connection = std::move(queue.front());
+                queue.pop_front();
+            }
+            // A request that fails in a way serve() does not expect (out of
+            // memory, say) ends that request, not the daemon
+            std::string status;
+            try {
+                status = serve(connection.fd, connection.request);
+            } catch (const std::exception& ex) {
+                finish(connection.fd, "fault", 0, ex.what());
+                status = "fault";
+            }
+            ::close(connection.fd);
+            if (status != "stats") stats.record(status, millisecondsSince(connection.accepted));
+        }
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Server::readPending: reads every connection `ready` flags (entry i + 1 is
+    // pending[i]); complete requests go to the workers, bad or late ones are
+    // answered here
+    // ---------------------------------------------------------------------------------
+    void Server::readPending(std::vector<Pending>& pending, const std::vector<pollfd>& ready) {
+        timeval timeout = {5, 0};   // A client that stops reading its output frees its worker
+        std::vector<Pending> waiting;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            Pending& connection = pending[i];
+            BroService::RequestBuffer::State state = BroService::RequestBuffer::State::Incomplete;
+            if (ready[i + 1].revents != 0) state = connection.buffer.readFrom(connection.fd);
+
+            if (state == BroService::RequestBuffer::State::Complete) {
+                // Workers write with blocking sends, bounded by the send timeout
+                ::fcntl(connection.fd, F_SETFL, ::fcntl(connection.fd, F_GETFL) & ~O_NONBLOCK);
+                ::setsockopt(connection.fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+                std::lock_guard<std::mutex> lock(queueMutex);
+                queue.push_back({connection.fd, connection.accepted, std::move(connection.buffer.request())});
+                queueReady.notify_one();
+            } else if (state == BroService::RequestBuffer::State::Invalid) {
+                reject(connection.fd, connection.buffer.error(), connection.accepted);
+            } else if (millisecondsSince(connection.accepted) >= settings.requestSeconds * 1000.0) {
+                reject(connection.fd, "request not received within " + std::to_string(settings.requestSeconds) + " s",
+                       connection.accepted);
+            } else {
+                waiting.push_back(std::move(connection));
+            }
+        }
+        pending = std::move(waiting);
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Server::run: accept and read requests until SIGINT / SIGTERM, then drain
+    // the queue
+    // ---------------------------------------------------------------------------------
+    int Server::run() {
+        std::string error;
+        int listener = BroService::listenOn(settings.socketPath, error);
+        if (listener < 0) {
+            std::cerr << "brod: " << error << "\n";
+            return 1;
+        }
+
+        std::vector<std::thread> workers;
+        for (unsigned i = 0; i < settings.workers; ++i) workers.emplace_back([this] { work(); });
+        std::cerr << "brod: listening on " << settings.socketPath << " with " << settings.workers << " workers\n";
+
+        ::fcntl(listener, F_SETFL, ::fcntl(listener, F_GETFL) | O_NONBLOCK);
+        std::vector<Pending> pending;
+        std::vector<pollfd> ready;
+        Clock::time_point lastReport = Clock::now();
+        while (!stopRequested) {
+            ready.assign(1, {listener, POLLIN, 0});
+            for (const Pending& connection : pending) ready.push_back({connection.fd, POLLIN, 0});
+            if (::poll(ready.data(), ready.size(), 200) > 0 && (ready[0].revents & POLLIN)) {
+                int fd;
+                while ((fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0) {
+                    size_t waiting;
+                    {
+                        std::lock_guard<std::mutex> lock(queueMutex);
+                        waiting = queue.size();
+                    }
+                    if (pending.size() + waiting >= settings.maxQueue) reject(fd, "daemon busy", Clock::now());
+                    else pending.push_back({fd, Clock::now(), BroService::RequestBuffer(settings.maxRequest)});
+                }
+            }
+            // Connections accepted just now are read at once: a client usually
+            // sends its whole request right after connecting
+            ready.resize(pending.size() + 1, {-1, POLLIN, POLLIN});
+            readPending(pending, ready);
+
+            if (settings.reportSeconds > 0 && millisecondsSince(lastReport) >= settings.reportSeconds * 1000.0) {
+                std::cerr << stats.report();
+                lastReport = Clock::now();
+            }
+        }
+
+        ::close(listener);
+        ::unlink(settings.socketPath.c_str());
+        for (const Pending& connection : pending) ::close(connection.fd);
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueReady.notify_all();
+        for (std::thread& worker : workers) worker.join();
+        std::cerr << "brod: " << stats.summary();
+        return 0;
+    }
+
+} // namespace
+
+// -----------------------------------------------------------------------------------
+// Function: showUsage
+// -----------------------------------------------------------------------------------
+void showUsage() {
+    std::cout << "Usage:\n";
+    std::cout << "  ./brod [options]\n";
+    std::cout << "Options:\n";
+    std::cout << "  --socket=PATH           Unix socket to listen on (default " << BroService::DEFAULT_SOCKET << ")\n";
+    std::cout << "  -jN                     Worker threads (default: one per CPU)\n";
+    std::cout << "  --max-instructions=N    Most instructions a request may run (default 10000000)\n";
+    std::cout << "  --max-request=BYTES     Largest source or image accepted (default 1 MB)\n";
+    std::cout << "  --max-output=BYTES      Most output a request may stream back (default 1 MB)\n";
+    std::cout << "  --max-queue=N           Connections being read or queued before new ones are rejected\n";
+    std::cout << "  --request-timeout=SEC   Seconds a client has to send its whole request (default 5)\n";
+    std::cout << "  --report=SECONDS        Print req/s and p50/p99 latency this often (0 = never)\n";
+}
+
+// -----------------------------------------------------------------------------------
+// Function: main
+// -----------------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    Settings settings;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg.rfind("--socket=", 0) == 0) {
+                settings.socketPath = arg.substr(9);
+            } else if (arg.rfind("-j", 0) == 0) {
+                settings.workers = static_cast<unsigned>(std::max(1, std::stoi(arg.substr(2))));
+            } else if (arg.rfind("--max-instructions=", 0) == 0) {
+                settings.maxInstructions = std::stoull(arg.substr(19));
+            } else if (arg.rfind("--max-request=", 0) == 0) {
+                settings.maxRequest = std::stoull(arg.substr(14));
+            } else if (arg.rfind("--max-output=", 0) == 0) {
+                settings.maxOutput = std::stoull(arg.substr(13));
+            } else if (arg.rfind("--max-queue=", 0) == 0) {
+                settings.maxQueue = std::stoull(arg.substr(12));
+            } else if (arg.rfind("--request-timeout=", 0) == 0) {
+                settings.requestSeconds = std::max(1, std::stoi(arg.substr(18)));
+            } else if (arg.rfind("--report=", 0) == 0) {
+                settings.reportSeconds = std::stoi(arg.substr(9));
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                showUsage();
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value in option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+    Server server(settings);
+    return server.run();
+}
@@ -0,0 +1,60 @@
+// ===================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brodis.cpp
+// Purpose:
+//   - Prints the code of a `.brobin` image in the text format of assembler.h:
+//     jump targets as labels, strings by name, and a comment where each source
+//     statement starts (from the image's source map), to audit what codegen
+//     produced. The output assembles back with broasm.
+//
+// Usage:
+//   ./broc test.bro -o prog.brobin
+//   ./brodis prog.brobin [-o prog.basm]
+//
+// Build:
+//   g++ brodis.cpp assembler.cpp brobin.cpp -o brodis
+// ===================================================================================
+
+#include "assembler.h"
+#include "brobin.h"
+
+#include <fstream>
+#include <iostream>
+
+// -----------------------------------------------------------------------------------
+// Function: main
+// -----------------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    if (argc != 2 && !(argc == 4 && std::string(argv[2]) == "-o")) {
+        std::cout << "Usage:\n";
+        std::cout << "  ./brodis prog.brobin [-o prog.basm]\n";
+        return 1;
+    }
+
+    BroBin::Image image;
+    if (!BroBin::read(argv[1], image)) return 1;
+
+    Assembly assembly;
+    if (!BroBin::decodeProgram(image.code.data(), image.code.size(), assembly.program)) {
+        std::cerr << "Invalid image " << argv[1] << ": jump into the middle of an instruction\n";
+        return 1;
+    }
+    assembly.dataAddress = image.dataAddress;
+    assembly.data = image.data;
+    assembly.sourceMap = image.sourceMap;
+    std::string text = Assembler::disassemble(assembly);
+
+    if (argc == 2) {
+        std::cout << text;
+        return 0;
+    }
+    std::ofstream out(argv[3]);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open output file: " << argv[3] << "\n";
+        return 1;
+    }
+    out << text;
+    return 0;
+}
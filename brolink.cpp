@@ -0,0 +1,60 @@
+// ===================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brolink.cpp
+// Purpose:
+//   - Links `.broo` object files (broc ... -o part.broo) into one program:
+//     a `.brobin` image, or a prog.cpp like broc's. The modules run in the
+//     order given; see broobj.h for what they share.
+//
+// Usage:
+//   ./brolink main.broo report.broo -o prog.brobin
+//
+// Build:
+//   g++ brolink.cpp broobj.cpp emitter.cpp brobin.cpp -o brolink
+// ===================================================================================
+
+#include "broobj.h"
+#include "emitter.h"
+
+#include <iostream>
+
+// -----------------------------------------------------------------------------------
+// Function: showUsage
+// -----------------------------------------------------------------------------------
+void showUsage() {
+    std::cout << "Usage:\n";
+    std::cout << "  ./brolink a.broo [b.broo ...] -o prog.brobin   Link into a binary image\n";
+    std::cout << "  ./brolink a.broo [b.broo ...] -o prog.cpp      Link into C++ for compiler_test.cpp\n";
+}
+
+// -----------------------------------------------------------------------------------
+// Function: main
+// -----------------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    if (argc < 4 || std::string(argv[argc - 2]) != "-o") {
+        showUsage();
+        return 1;
+    }
+    std::string outputFile = argv[argc - 1];
+
+    std::vector<BroObj::Module> modules(argc - 3);
+    for (int i = 1; i < argc - 2; ++i) {
+        if (!BroObj::read(argv[i], modules[i - 1])) return 1;
+    }
+
+    BroObj::Linked program;
+    std::string error;
+    if (!BroObj::link(modules, program, error)) {
+        std::cerr << "Link error: " << error << "\n";
+        return 1;
+    }
+
+    bool image = outputFile.size() > 7 && outputFile.compare(outputFile.size() - 7, 7, ".brobin") == 0;
+    // Modules are broc's output, so their unchecked opcodes keep the compiler's mark
+    bool written = image
+        ? Emitter::writeImage(outputFile, program.code, program.sourceMap, program.dataAddress, program.data, true)
+        : Emitter::writeToFile(outputFile, program.code, program.sourceMap, program.dataAddress, program.data);
+    return written ? 0 : 1;
+}
@@ -0,0 +1,348 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: broobj.cpp
+// Purpose:
+//   - Implements the `.broo` object format and the linker described in broobj.h.
+//
+// Where relocations come from:
+//   - Each operand's meaning follows from its opcode: a jump's a1 is an
+//     instruction index, LOAD/STORE address a variable, LDX/STX the first
+//     element of an array and PRS a string literal. fromCodegen() reads the
+//     code after the instruction passes have moved it around, so the records
+//     always describe the instructions that are actually written.
+// =====================================================================================
+
+#include "broobj.h"
+#include "brobin.h"     // BroBin::checksum
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+
+namespace {
+
+    constexpr uint8_t MAGIC[4] = {'B', 'R', 'O', 'O'};
+    constexpr size_t INSTRUCTION_BYTES = 5;
+    constexpr size_t RELOCATION_BYTES = 8;
+
+    void put16(std::vector<uint8_t>& out, uint16_t v) {
+        out.push_back(v & 0xFF);
+        out.push_back((v >> 8) & 0xFF);
+    }
+
+    void put32(std::vector<uint8_t>& out, uint32_t v) {
+        put16(out, v & 0xFFFF);
+        put16(out, (v >> 16) & 0xFFFF);
+    }
+
+    uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+    uint32_t get32(const uint8_t* p) { return get16(p) | (static_cast<uint32_t>(get16(p + 2)) << 16); }
+
+    bool isJump(Opcode op) {
+        return op == Opcode::JMP || op == Opcode::JZ || op == Opcode::JNZ;
+    }
+
+} // namespace
+
+namespace BroObj {
+
+    // ---------------------------------------------------------------------------------
+    // fromCodegen
+    // ---------------------------------------------------------------------------------
+    bool fromCodegen(const std::vector<Instruction>& code, const std::vector<int>& sourceMap,
+                     const Codegen& codegen, Module& out, std::string& error) {
+        out = Module();
+
+        // Variables get consecutive private slots, in the order Codegen placed them
+        std::map<uint16_t, uint16_t> variableOffset;
+        for (const auto& [name, address] : codegen.getVariables()) variableOffset[address] = 0;
+        for (auto& [address, offset] : variableOffset) {
+            offset = out.variableBytes;
+            out.variableBytes += 2;
+        }
+
+        std::map<uint16_t, uint16_t> arrayIndex;
+        for (const auto& [name, address] : codegen.getArrays()) {
+            arrayIndex[address] = static_cast<uint16_t>(out.arrays.size());
+            out.arrays.push_back({name, static_cast<uint16_t>(codegen.getArraySizes().at(name))});
+        }
+
+        const uint16_t dataAddress = codegen.getDataAddress();
+        out.data = codegen.getData();
+        out.code = code;
+        for (size_t i = 0; i < code.size(); ++i) {
+            Instruction& instr = out.code[i];
+            uint32_t at = static_cast<uint32_t>(i);
+
+            if (isJump(instr.op)) {
+                out.relocations.push_back({at, RelocationKind::Jump});
+            } else if (instr.op == Opcode::LOAD || instr.op == Opcode::STORE) {
+                auto it = variableOffset.find(instr.a1);
+                if (it == variableOffset.end()) {
+                    error = "instruction " + std::to_string(i) + " uses an address that is not a variable";
+                    return false;
+                }
+                instr.a1 = it->second;
+                out.relocations.push_back({at, RelocationKind::Variable});
+            } else if (instr.op == Opcode::LDX || instr.op == Opcode::STX) {
+                auto it = arrayIndex.find(instr.a1);
+                if (it == arrayIndex.end()) {
+                    error = "instruction " + std::to_string(i) + " uses an address that is not an array";
+                    return false;
+                }
+                instr.a1 = 0;
+                out.relocations.push_back({at, RelocationKind::Array, it->second});
+            } else if (instr.op == Opcode::PRS) {
+                if (instr.a1 < dataAddress || instr.a1 + size_t(instr.a2) > dataAddress + out.data.size()) {
+                    error = "instruction " + std::to_string(i) + " prints outside the data section";
+                    return false;
+                }
+                instr.a1 -= dataAddress;
+                out.relocations.push_back({at, RelocationKind::Data});
+            }
+        }
+
+        if (sourceMap.size() == code.size()) out.sourceMap = sourceMap;
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // link
+    // ---------------------------------------------------------------------------------
+    bool link(const std::vector<Module>& modules, Linked& out, std::string& error) {
+        out = Linked();
+
+        // --- Memory: each module's variables, then arrays as first declared ---
+        uint32_t next = Memory::DATA_BASE;
+        std::vector<uint32_t> variableBase;
+        std::map<std::string, std::pair<uint16_t, uint16_t>> arrays;  // Name → address, size
+        for (const Module& module : modules) {
+            variableBase.push_back(next);
+            next += module.variableBytes;
+            for (const ArraySymbol& array : module.arrays) {
+                auto it = arrays.find(array.name);
+                if (it == arrays.end()) {
+                    arrays[array.name] = {static_cast<uint16_t>(next), array.size};
+                    next += 2u * array.size;
+                } else if (it->second.second != array.size) {
+                    error = "array " + array.name + " is declared with " + std::to_string(it->second.second) +
+                            " and " + std::to_string(array.size) + " elements";
+                    return false;
+                }
+            }
+        }
+        if (next > Memory::DATA_END) {
+            error = "not enough memory for the variables and arrays of all modules";
+            return false;
+        }
+
+        // --- Data: every module's literals, together right below DATA_BASE ---
+        std::vector<uint32_t> dataOffset;
+        for (const Module& module : modules) {
+            dataOffset.push_back(static_cast<uint32_t>(out.data.size()));
+            out.data.insert(out.data.end(), module.data.begin(), module.data.end());
+        }
+        if (out.data.size() > Memory::DATA_BASE) {
+            error = "string literals larger than memory";
+            return false;
+        }
+        out.dataAddress = static_cast<uint16_t>(Memory::DATA_BASE - out.data.size());
+
+        // --- Code: relocate, chain each HLT to the next module ---
+        int statementBase = 0;
+        for (size_t m = 0; m < modules.size(); ++m) {
+            const Module& module = modules[m];
+            const size_t first = out.code.size();
+            const size_t following = first + module.code.size();  // Next module's start
+            std::vector<Instruction> code = module.code;
+
+            for (const Relocation& reloc : module.relocations) {
+                Instruction& instr = code[reloc.instruction];
+                uint32_t value = instr.a1;
+                switch (reloc.kind) {
+                    case RelocationKind::Jump:
+                        if (value > module.code.size()) {
+                            error = "module " + std::to_string(m + 1) + ": jump target out of range";
+                            return false;
+                        }
+                        value += first;
+                        break;
+                    case RelocationKind::Data:     value += out.dataAddress + dataOffset[m]; break;
+                    case RelocationKind::Variable: value += variableBase[m]; break;
+                    case RelocationKind::Array:    value += arrays[module.arrays[reloc.array].name].first; break;
+                }
+                if (value > 0xFFFF) {
+                    error = "module " + std::to_string(m + 1) + ": relocated operand out of range";
+                    return false;
+                }
+                instr.a1 = static_cast<uint16_t>(value);
+            }
+
+            if (m + 1 < modules.size()) {
+                for (Instruction& instr : code)
+                    if (instr.op == Opcode::HLT) instr = {Opcode::JMP, static_cast<uint16_t>(following)};
+            }
+            out.code.insert(out.code.end(), code.begin(), code.end());
+
+            int highest = -1;
+            for (size_t i = 0; i < code.size(); ++i) {
+                int statement = module.sourceMap.empty() ? -1 : module.sourceMap[i];
+                out.sourceMap.push_back(statement < 0 ? -1 : statement + statementBase);
+                highest = std::max(highest, statement);
+            }
+            statementBase += highest + 1;
+        }
+
+        size_t codeBytes = 0;
+        for (const Instruction& instr : out.code) codeBytes += instructionSize(instr.op);
+        if (out.code.size() > 0xFFFF || codeBytes > out.dataAddress) {
+            error = "program too large: the code would overlap the data";
+            return false;
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // serialize / parse
+    // ---------------------------------------------------------------------------------
+    std::vector<uint8_t> serialize(const Module& module) {
+        std::vector<uint8_t> body;
+        for (const Instruction& instr : module.code) {
+            body.push_back(static_cast<uint8_t>(instr.op));
+            put16(body, instr.a1);
+            put16(body, instr.a2);
+        }
+        for (const Relocation& reloc : module.relocations) {
+            put32(body, reloc.instruction);
+            put16(body, static_cast<uint16_t>(reloc.kind));
+            put16(body, reloc.array);
+        }
+        size_t arraysStart = body.size();
+        for (const ArraySymbol& array : module.arrays) {
+            put16(body, array.size);
+            put16(body, static_cast<uint16_t>(array.name.size()));
+            body.insert(body.end(), array.name.begin(), array.name.end());
+        }
+        size_t arraysSize = body.size() - arraysStart;
+        body.insert(body.end(), module.data.begin(), module.data.end());
+        for (int statement : module.sourceMap) put32(body, static_cast<uint32_t>(statement));
+
+        std::vector<uint8_t> out(std::begin(MAGIC), std::end(MAGIC));
+        out.reserve(HEADER_SIZE + body.size());
+        put16(out, VERSION);
+        put16(out, module.sourceMap.empty() ? 0 : FLAG_SOURCE_MAP);
+        put32(out, static_cast<uint32_t>(module.code.size()));
+        put32(out, static_cast<uint32_t>(module.relocations.size()));
+        put16(out, static_cast<uint16_t>(module.arrays.size()));
+        put16(out, module.variableBytes);
+        put32(out, static_cast<uint32_t>(module.data.size()));
+        put32(out, BroBin::checksum(body.data(), body.size()));
+        put32(out, static_cast<uint32_t>(arraysSize));
+        out.insert(out.end(), body.begin(), body.end());
+        return out;
+    }
+
+    bool parse(const uint8_t* bytes, size_t size, Module& module, std::string& error) {
+        if (size < HEADER_SIZE || !std::equal(std::begin(MAGIC), std::end(MAGIC), bytes)) {
+            error = "not a .broo object file";
+            return false;
+        }
+        if (get16(bytes + 4) != VERSION) {
+            error = "unsupported version " + std::to_string(get16(bytes + 4));
+            return false;
+        }
+
+        uint16_t flags = get16(bytes + 6);
+        uint32_t count = get32(bytes + 8);
+        uint32_t relocationCount = get32(bytes + 12);
+        uint16_t arrayCount = get16(bytes + 16);
+        uint32_t dataSize = get32(bytes + 20);
+        uint32_t arraysSize = get32(bytes + 28);
+        uint64_t mapSize = (flags & FLAG_SOURCE_MAP) ? 4ull * count : 0;
+
+        if (HEADER_SIZE + INSTRUCTION_BYTES * uint64_t(count) + RELOCATION_BYTES * uint64_t(relocationCount) +
+            arraysSize + dataSize + mapSize != size) {
+            error = "section sizes do not match the file size";
+            return false;
+        }
+        const uint8_t* p = bytes + HEADER_SIZE;
+        if (BroBin::checksum(p, size - HEADER_SIZE) != get32(bytes + 24)) {
+            error = "checksum mismatch";
+            return false;
+        }
+
+        module = Module();
+        module.variableBytes = get16(bytes + 18);
+        for (uint32_t i = 0; i < count; ++i, p += INSTRUCTION_BYTES) {
+            Opcode op = static_cast<Opcode>(p[0]);
+            if (!opcodeName(op)) {
+                error = "unknown opcode in instruction " + std::to_string(i);
+                return false;
+            }
+            module.code.push_back({op, get16(p + 1), get16(p + 3)});
+        }
+        for (uint32_t i = 0; i < relocationCount; ++i, p += RELOCATION_BYTES) {
+            Relocation reloc{get32(p), static_cast<RelocationKind>(get16(p + 4)), get16(p + 6)};
+            uint16_t kind = static_cast<uint16_t>(reloc.kind);
+            if (reloc.instruction >= count || kind < 1 || kind > 4 ||
+                (reloc.kind == RelocationKind::Array && reloc.array >= arrayCount)) {
+                error = "malformed relocation " + std::to_string(i);
+                return false;
+            }
+            module.relocations.push_back(reloc);
+        }
+        const uint8_t* arraysEnd = p + arraysSize;
+        for (uint16_t i = 0; i < arrayCount; ++i) {
+            if (arraysEnd - p < 4 || arraysEnd - p - 4 < get16(p + 2)) {
+                error = "malformed array table";
+                return false;
+            }
+            uint16_t length = get16(p + 2);
+            module.arrays.push_back({std::string(p + 4, p + 4 + length), get16(p)});
+            p += 4 + length;
+        }
+        if (p != arraysEnd) {
+            error = "malformed array table";
+            return false;
+        }
+        module.data.assign(p, p + dataSize);
+        p += dataSize;
+        for (uint64_t i = 0; i < mapSize / 4; ++i, p += 4)
+            module.sourceMap.push_back(static_cast<int32_t>(get32(p)));
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // write / read
+    // ---------------------------------------------------------------------------------
+    bool write(const std::string& path, const Module& module) {
+        std::ofstream out(path, std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Failed to open output file: " << path << "\n";
+            return false;
+        }
+        std::vector<uint8_t> bytes = serialize(module);
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return static_cast<bool>(out);
+    }
+
+    bool read(const std::string& path, Module& module) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.is_open()) {
+            std::cerr << "Failed to open object file: " << path << "\n";
+            return false;
+        }
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        std::string error;
+        if (!parse(bytes.data(), bytes.size(), module, error)) {
+            std::cerr << "Invalid object file " << path << ": " << error << "\n";
+            return false;
+        }
+        return true;
+    }
+
+} // namespace BroObj
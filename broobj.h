@@ -0,0 +1,124 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: broobj.h
+// Purpose:
+//   - Declares the `.broo` object file: one separately compiled BroLang source
+//     whose addresses are not fixed yet, and the linker (brolink.cpp) that
+//     joins object files into one program, so a change to one source file
+//     only recompiles that file.
+//
+// What linking means for BroLang:
+//   - Modules run one after another, in link order: the HLT ending each module
+//     but the last becomes a jump to the start of the next.
+//   - Variables are private to their module (each module gets its own slots).
+//     Arrays are shared by name: every module declaring `p[24]` uses the same
+//     24 words, so one module can fill an array another one reads. Declaring
+//     the same array with two different sizes is a link error.
+//   - Jumps, variables, arrays and string literals are all relocated, so
+//     nothing in a module depends on where the others are placed.
+//
+// Layout (integers little-endian):
+//   offset  size  field
+//   0       4     magic "BROO"
+//   4       2     version (VERSION)
+//   6       2     flags (bit 0: source map present)
+//   8       4     instruction count
+//   12      4     relocation count
+//   16      2     array count
+//   18      2     bytes of private variables
+//   20      4     data size in bytes
+//   24      4     checksum: FNV-1a over every byte after the header
+//   28      4     array table size in bytes
+//   32      ...   code: 5 bytes per instruction (opcode, a1, a2), unencoded
+//   ...     ...   relocations: 8 bytes each (instruction u32, kind u16, array u16)
+//   ...     ...   arrays: size u16, name length u16, name, per array
+//   ...     ...   data: string literals, relative to the module
+//   ...     ...   source map: 4 bytes (int32) per instruction, if flagged
+//
+// Workflow:
+//   ./broc main.bro -o main.broo
+//   ./broc report.bro -o report.broo
+//   ./brolink main.broo report.broo -o prog.brobin
+// =====================================================================================
+
+#pragma once
+
+#include "RohitVM.hpp"
+#include "codegen.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BroObj {
+
+    constexpr uint16_t VERSION = 1;
+    constexpr size_t HEADER_SIZE = 32;
+    constexpr uint16_t FLAG_SOURCE_MAP = 0x0001;
+
+    // ---------------------------------------------------------------------------------
+    // Relocation: what the linker adds to a1 of the instruction
+    // ---------------------------------------------------------------------------------
+    enum class RelocationKind : uint16_t {
+        Jump = 1,       // Index of the module's first instruction (a1: local index)
+        Data = 2,       // Address of the module's data (a1: offset in it)
+        Variable = 3,   // Address of the module's variables (a1: offset in them)
+        Array = 4       // Address of the array named by `array` (a1: 0)
+    };
+
+    struct Relocation {
+        uint32_t instruction;
+        RelocationKind kind;
+        uint16_t array = 0;     // Index into Module::arrays, for RelocationKind::Array
+    };
+
+    struct ArraySymbol {
+        std::string name;
+        uint16_t size;          // Elements (words)
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Struct: Module
+    // Purpose: The sections of a `.broo` file, in memory
+    // ---------------------------------------------------------------------------------
+    struct Module {
+        std::vector<Instruction> code;      // Jumps by local index; relocated operands are offsets
+        std::vector<Relocation> relocations;
+        uint16_t variableBytes = 0;
+        std::vector<ArraySymbol> arrays;
+        std::vector<uint8_t> data;
+        std::vector<int> sourceMap;         // Empty, or a statement id per instruction
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Struct: Linked
+    // Purpose: A whole program, as Emitter::writeImage / writeToFile take it
+    // ---------------------------------------------------------------------------------
+    struct Linked {
+        std::vector<Instruction> code;
+        std::vector<int> sourceMap;         // Statement ids renumbered to stay unique
+        uint16_t dataAddress = Memory::DATA_BASE;
+        std::vector<uint8_t> data;
+    };
+
+    // Turns the final code of one source file (after the instruction passes)
+    // into a module: every address Codegen assigned becomes an offset plus a
+    // relocation. False, with `error` set, for an operand it can not place.
+    bool fromCodegen(const std::vector<Instruction>& code, const std::vector<int>& sourceMap,
+                     const Codegen& codegen, Module& out, std::string& error);
+
+    // Places the modules in order and applies their relocations
+    bool link(const std::vector<Module>& modules, Linked& out, std::string& error);
+
+    // The whole file, header included
+    std::vector<uint8_t> serialize(const Module& module);
+
+    // Checks and splits a file held in memory; on failure `error` says why
+    bool parse(const uint8_t* bytes, size_t size, Module& module, std::string& error);
+
+    // Write / read a file; both print an error and return false on failure
+    bool write(const std::string& path, const Module& module);
+    bool read(const std::string& path, Module& module);
+
+} // namespace BroObj
@@ -0,0 +1,262 @@
+// ===================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brorun.cpp
+// Purpose:
+//   - Runs a BroLang program in one step: `./brorun test.bro`.
+//   - The whole pipeline (Lexer → Parser → Optimizer → Codegen) runs in memory
+//     and the bytecode goes straight into the VM, so no prog.cpp is written and
+//     no C++ compiler is involved. A `.brobin` image (brobin.h) runs as well,
+//     and so does one program of a `.broa` archive (broarchive.h, --program=NAME).
+//   - `--engine=x86_64` compiles through the native backend instead and runs
+//     the executable (this one engine needs `cc`).
+//
+// Build:
+//   g++ brorun.cpp lexer.cpp parser.cpp astutils.cpp licm.cpp strength.cpp cse.cpp unroll.cpp evaluator.cpp jumpthread.cpp cfg.cpp blocklayout.cpp range.cpp boundscheck.cpp optimizer.cpp profile.cpp codegen.cpp x86backend.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp broarchive.cpp -o brorun
+// ===================================================================================
+
+#include "lexer.h"
+#include "parser.h"
+#include "optimizer.h"
+#include "codegen.h"
+#include "x86backend.h"
+#include "RohitVM.hpp"
+#include "broarchive.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <spawn.h>      // posix_spawn
+#include <sys/wait.h>   // waitpid, WIFEXITED, WIFSIGNALED
+#include <unistd.h>     // rmdir, environ
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    bool endsWith(const std::string& text, const std::string& suffix) {
+        return text.size() >= suffix.size() &&
+               text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+} // namespace
+
+// -----------------------------------------------------------------------------------
+// Function: showUsage
+// -----------------------------------------------------------------------------------
+void showUsage() {
+    std::cout << "Usage:\n";
+    std::cout << "  ./brorun input.bro [options]      Compile in memory and run\n";
+    std::cout << "  ./brorun prog.brobin [options]    Run a compiled image\n";
+    std::cout << "  ./brorun programs.broa --program=NAME [options]   Run one program of an archive\n";
+    std::cout << "Options:\n";
+    std::cout << "  -O0, --unroll=N, --code-budget=N, --partial-eval, --fuel=N   As for broc\n";
+    std::cout << "  --engine=E         vm (default) or x86_64 (native executable, needs cc)\n";
+    std::cout << "  --time             Print compile and run times on stderr\n";
+    std::cout << "  --profile=F        Write the VM's execution profile to F (see profile.h)\n";
+}
+
+// -----------------------------------------------------------------------------------
+// Function: parseSource
+// Purpose: Reads `path` and runs the front end and the AST passes on it.
+// -----------------------------------------------------------------------------------
+bool parseSource(const std::string& path, const OptimizerOptions& options, Program& program) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open input file: " << path << "\n";
+        return false;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+
+    Lexer lexer(ss.str());
+    std::vector<Token> tokens;
+    while (true) {
+        Token t = lexer.nextToken();
+        if (t.type == TokenType::EndOfFile) break;
+        tokens.push_back(t);
+    }
+
+    Parser parser(tokens);
+    program = parser.parseProgram();
+    if (parser.getErrorCount() > 0) {
+        std::cerr << path << ": " << parser.getErrorCount() << " error(s), not run\n";
+        return false;
+    }
+    Optimizer::run(program, options);
+    return true;
+}
+
+// -----------------------------------------------------------------------------------
+// Function: runNative
+// Purpose: Builds the program with the x86-64 backend in a temporary directory,
+//          runs it and returns its exit status (128 + the signal, as a shell
+//          would, if a signal killed it).
+// -----------------------------------------------------------------------------------
+int runNative(const Program& program, const OptimizerOptions& options, Clock::time_point start, bool timing) {
+    char directory[] = "/tmp/brorunXXXXXX";
+    if (!mkdtemp(directory)) {
+        std::cerr << "Failed to create a temporary directory\n";
+        return 1;
+    }
+    std::string executable = std::string(directory) + "/prog";
+
+    X86Backend backend(options.elideChecks);
+    bool built = X86Backend::writeExecutable(backend.generate(program), executable);
+    double compileTime = millisecondsSince(start);
+
+    int status = 1;
+    Clock::time_point runStart = Clock::now();
+    if (built) {
+        std::cout.flush();
+        std::fflush(stdout);
+        const char* argv[] = {executable.c_str(), nullptr};
+        pid_t pid;
+        int result = 0;
+        int failed = posix_spawn(&pid, executable.c_str(), nullptr, nullptr, const_cast<char* const*>(argv), environ);
+        if (failed == 0) {
+            while (waitpid(pid, &result, 0) < 0 && errno == EINTR) {}
+        }
+        if (failed != 0) {
+            std::cerr << "brorun: can not run " << executable << ": " << std::strerror(failed) << "\n";
+        } else if (WIFEXITED(result)) {
+            status = WEXITSTATUS(result);
+        } else if (WIFSIGNALED(result)) {
+            std::cerr << "brorun: native program killed by signal " << WTERMSIG(result) << " ("
+                      << strsignal(WTERMSIG(result)) << ")\n";
+            status = 128 + WTERMSIG(result);
+        }
+    }
+    if (timing)
+        std::cerr << "brorun: compile " << compileTime << " ms, run " << millisecondsSince(runStart)
+                  << " ms (x86_64)\n";
+
+    std::remove(executable.c_str());
+    std::remove((executable + ".s").c_str());
+    rmdir(directory);
+    return status;
+}
+
+// -----------------------------------------------------------------------------------
+// Function: main
+// -----------------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        showUsage();
+        return 1;
+    }
+
+    std::string inputFile = argv[1];
+    OptimizerOptions options;
+    std::string profilePath, programName;
+    bool native = false;
+    bool timing = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "-O0") {
+                options = OptimizerOptions::none();
+            } else if (arg.rfind("--unroll=", 0) == 0) {
+                options.unrollFactor = std::stoi(arg.substr(9));
+            } else if (arg.rfind("--code-budget=", 0) == 0) {
+                options.codeBudget = std::stoi(arg.substr(14));
+            } else if (arg == "--partial-eval") {
+                options.partialEval = true;
+            } else if (arg.rfind("--fuel=", 0) == 0) {
+                options.fuel = std::stol(arg.substr(7));
+            } else if (arg.rfind("--profile=", 0) == 0) {
+                profilePath = arg.substr(10);
+            } else if (arg == "--engine=x86_64") {
+                native = true;
+            } else if (arg == "--engine=vm") {
+                native = false;
+            } else if (arg.rfind("--program=", 0) == 0) {
+                programName = arg.substr(10);
+            } else if (arg == "--time") {
+                timing = true;
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                showUsage();
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value in option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    bool archive = endsWith(inputFile, ".broa");
+    bool image = archive || endsWith(inputFile, ".brobin");
+    if (archive && programName.empty()) {
+        std::cerr << "Name the program to run from " << inputFile << " with --program=NAME\n";
+        return 1;
+    }
+    if (image && native) {
+        std::cerr << "--engine=x86_64 needs BroLang source, not an image\n";
+        return 1;
+    }
+
+    std::cerr << std::fixed << std::setprecision(3);
+    Clock::time_point start = Clock::now();
+    VM vm;
+    vm.profiling = !profilePath.empty();
+    std::vector<int> sourceMap;
+
+    if (archive) {
+        auto programs = BroBin::Archive::open(inputFile);
+        if (!programs) return 1;
+        BroBin::View view;
+        std::string error;
+        if (!programs->view(programName, view, error)) {
+            std::cerr << inputFile << ": " << error << "\n";
+            return 1;
+        }
+        if (!vm.loadImage(view, programs->file())) {
+            std::cerr << inputFile << ": " << vm.getError() << "\n";
+            return 1;
+        }
+        sourceMap = vm.getSourceMap();
+    } else if (image) {
+        if (!vm.loadImage(inputFile)) return 1;
+        sourceMap = vm.getSourceMap();
+    } else {
+        Program program;
+        if (!parseSource(inputFile, options, program)) return 1;
+        if (native) return runNative(program, options, start, timing);
+
+        Codegen codegen(options.profile, options.elideChecks);
+        std::vector<Instruction> bytecode = codegen.generate(program);
+        if (codegen.getErrorCount() > 0) {
+            std::cerr << inputFile << ": " << codegen.getErrorCount() << " error(s), not run\n";
+            return 1;
+        }
+        sourceMap = codegen.getSourceMap();
+        Optimizer::run(bytecode, sourceMap, options);
+
+        vm.loadProgram(bytecode);
+        vm.loadData(codegen.getDataAddress(), codegen.getData());
+    }
+    double compileTime = millisecondsSince(start);
+
+    Clock::time_point runStart = Clock::now();
+    vm.execute();
+    double runTime = millisecondsSince(runStart);
+
+    if (vm.profiling && vm.writeProfile(profilePath, sourceMap))
+        std::cout << "Profile written to " << profilePath << "\n";
+    if (timing)
+        std::cerr << "brorun: " << (image ? "load " : "compile ") << compileTime << " ms, run " << runTime
+                  << " ms (vm, " << vm.instructionCount << " instructions)\n";
+    return 0;
+}
@@ -0,0 +1,248 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: broservice.cpp
+// Purpose:
+//   - Implements the brod protocol helpers declared in broservice.h.
+// =====================================================================================
+
+#include "broservice.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace BroService {
+
+    // ---------------------------------------------------------------------------------
+    // Reader
+    // ---------------------------------------------------------------------------------
+    bool Reader::fill() {
+        while (true) {
+            ssize_t got = ::read(fd, buffer, sizeof(buffer));
+            if (got > 0) {
+                at = 0;
+                length = static_cast<size_t>(got);
+                return true;
+            }
+            if (got < 0 && errno == EINTR) continue;
+            return false;                     // End of file, or a timeout / error
+        }
+    }
+
+    bool Reader::line(std::string& out, size_t max) {
+        out.clear();
+        while (true) {
+            if (at == length && !fill()) return false;
+            char c = buffer[at++];
+            if (c == '\n') return true;
+            if (out.size() == max) return false;
+            out += c;
+        }
+    }
+
+    bool Reader::exact(std::string& out, size_t size) {
+        out.clear();
+        out.reserve(size);
+        while (out.size() < size) {
+            if (at == length && !fill()) return false;
+            size_t take = std::min(size - out.size(), length - at);
+            out.append(buffer + at, take);
+            at += take;
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Writing
+    // ---------------------------------------------------------------------------------
+    bool writeAll(int fd, const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent <= 0) return false;
+            data += sent;
+            size -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    bool writeFrame(int fd, const std::string& head, const char* data, size_t size) {
+        std::string frame = head + " " + std::to_string(size) + "\n";
+        frame.append(data, size);
+        return writeAll(fd, frame.data(), frame.size());
+    }
+
+    bool writeRequest(int fd, const Request& request) {
+        if (request.kind == "stats") return writeAll(fd, "stats\n", 6);
+        std::string head = "run " + request.kind + " " + std::to_string(request.instructionLimit) + " " +
+                           std::to_string(request.outputLimit);
+        return writeFrame(fd, head, request.payload.data(), request.payload.size());
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Reading requests
+    // ---------------------------------------------------------------------------------
+    namespace {
+
+        // Fills `request` (all but the payload) and `size` from a header line
+        bool parseHeader(const std::string& header, Request& request, uint64_t& size, size_t maxPayload,
+                         std::string& error) {
+            std::istringstream fields(header);
+            std::string verb, end;
+            fields >> verb;
+            size = 0;
+            if (verb == "stats" && !(fields >> end)) {
+                request.kind = "stats";
+                return true;
+            }
+
+            if (verb != "run" || !(fields >> request.kind >> request.instructionLimit >> request.outputLimit >> size) ||
+                (fields >> end) || (request.kind != "source" && request.kind != "image")) {
+                error = "malformed request header";
+                return false;
+            }
+            if (size > maxPayload) {
+                error = "request of " + std::to_string(size) + " bytes is over the " + std::to_string(maxPayload) +
+                        " byte quota";
+                return false;
+            }
+            return true;
+        }
+
+    } // namespace
+
+    bool readRequest(Reader& in, Request& request, size_t maxPayload, std::string& error) {
+        std::string header;
+        if (!in.line(header)) {
+            error = "no request header";
+            return false;
+        }
+        uint64_t size = 0;
+        if (!parseHeader(header, request, size, maxPayload, error)) return false;
+        if (request.kind == "stats") return true;
+        if (!in.exact(request.payload, size)) {
+            error = "request cut off";
+            return false;
+        }
+        return true;
+    }
+
+    RequestBuffer::State RequestBuffer::readFrom(int fd) {
+        char buffer[4096];
+        while (true) {
+            ssize_t got = ::read(fd, buffer, sizeof(buffer));
+            if (got > 0) {
+                State state = take(buffer, static_cast<size_t>(got));
+                if (state != State::Incomplete) return state;
+                continue;
+            }
+            if (got < 0 && errno == EINTR) continue;
+            if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return State::Incomplete;
+            reason = haveHeader ? "request cut off" : "no request header";
+            return State::Invalid;
+        }
+    }
+
+    // Bytes past the end of the request are ignored, as readRequest never reads them
+    RequestBuffer::State RequestBuffer::take(const char* data, size_t length) {
+        size_t at = 0;
+        while (!haveHeader) {
+            if (at == length) return State::Incomplete;
+            char c = data[at++];
+            if (c != '\n') {
+                if (header.size() == MAX_HEADER) {
+                    reason = "no request header";
+                    return State::Invalid;
+                }
+                header += c;
+                continue;
+            }
+            if (!parseHeader(header, parsed, size, maxPayload, reason)) return State::Invalid;
+            haveHeader = true;
+            parsed.payload.reserve(size);
+        }
+        size_t take = std::min(static_cast<size_t>(size - parsed.payload.size()), length - at);
+        parsed.payload.append(data + at, take);
+        return parsed.payload.size() == size ? State::Complete : State::Incomplete;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Sockets
+    // ---------------------------------------------------------------------------------
+    namespace {
+
+        bool makeAddress(const std::string& path, sockaddr_un& address, std::string& error) {
+            std::memset(&address, 0, sizeof(address));
+            address.sun_family = AF_UNIX;
+            if (path.size() >= sizeof(address.sun_path)) {
+                error = "socket path too long: " + path;
+                return false;
+            }
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            return true;
+        }
+
+    } // namespace
+
+    int listenOn(const std::string& path, std::string& error) {
+        sockaddr_un address;
+        if (!makeAddress(path, address, error)) return -1;
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            error = std::string("socket: ") + std::strerror(errno);
+            return -1;
+        }
+
+        // Only a socket left by a daemon that is gone may be replaced
+        struct stat info;
+        if (::lstat(path.c_str(), &info) == 0) {
+            if (!S_ISSOCK(info.st_mode)) {
+                error = path + " exists and is not a socket";
+                ::close(fd);
+                return -1;
+            }
+            std::string ignored;
+            int probe = connectTo(path, ignored);
+            if (probe >= 0) {
+                ::close(probe);
+                error = "another daemon is listening on " + path;
+                ::close(fd);
+                return -1;
+            }
+            ::unlink(path.c_str());
+        }
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            ::listen(fd, SOMAXCONN) < 0) {
+            error = "can not listen on " + path + ": " + std::strerror(errno);
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    int connectTo(const std::string& path, std::string& error) {
+        sockaddr_un address;
+        if (!makeAddress(path, address, error)) return -1;
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            error = std::string("socket: ") + std::strerror(errno);
+            return -1;
+        }
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            error = "can not connect to " + path + ": " + std::strerror(errno);
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+} // namespace BroService
@@ -0,0 +1,113 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: broservice.h
+// Purpose:
+//   - Declares the wire protocol between brod (the execution daemon) and its
+//     clients (brocall): one request per connection on a Unix stream socket,
+//     answered by the program's output as it is printed, then its status.
+//
+// Request (text header line, then the payload):
+//   run source <instructionLimit> <outputLimit> <size>\n<size bytes of BroLang>
+//   run image  <instructionLimit> <outputLimit> <size>\n<size bytes of .brobin>
+//   stats\n
+//   A limit of 0 asks for the daemon's maximum; larger ones are cut down to it.
+//
+// Response (frames until the connection closes):
+//   out <size>\n<size bytes>                 Output, streamed while the VM runs
+//   end <status> <instructions> <size>\n<size bytes of message>
+//   <status> is halted, fault, limit, compile-error or rejected (bad request,
+//   over quota, daemon busy); the message says why, or holds the stats text.
+//
+// Workflow:
+//   ./brod --socket=/tmp/brod.sock -j8 &
+//   ./brocall test.bro --socket=/tmp/brod.sock
+// =====================================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace BroService {
+
+    constexpr const char* DEFAULT_SOCKET = "/tmp/brod.sock";
+    constexpr size_t MAX_HEADER = 256;        // Longest header line accepted
+
+    struct Request {
+        std::string kind;                     // "source", "image" or "stats"
+        uint64_t instructionLimit = 0;        // 0 = the daemon's maximum
+        uint64_t outputLimit = 0;
+        std::string payload;
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Class: Reader
+    // Purpose: Buffered reads of header lines and exact byte counts from a socket
+    // ---------------------------------------------------------------------------------
+    class Reader {
+    public:
+        explicit Reader(int fd) : fd(fd) {}
+
+        // False at end of file, on an error, or for a line longer than `max`
+        bool line(std::string& out, size_t max = MAX_HEADER);
+        bool exact(std::string& out, size_t size);
+
+    private:
+        int fd;
+        char buffer[4096];
+        size_t at = 0;
+        size_t length = 0;
+
+        bool fill();
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Class: RequestBuffer
+    // Purpose: Assembles one request from a non-blocking socket as its bytes
+    //          arrive, so one thread can read many connections at once
+    // ---------------------------------------------------------------------------------
+    class RequestBuffer {
+    public:
+        enum class State { Incomplete, Complete, Invalid };
+
+        explicit RequestBuffer(size_t maxPayload) : maxPayload(maxPayload) {}
+
+        // Reads whatever `fd` has now; Invalid (with error() saying why) for a bad
+        // header, a payload over the quota, or a peer that closed mid-request
+        State readFrom(int fd);
+
+        Request& request() { return parsed; }
+        const std::string& error() const { return reason; }
+
+    private:
+        size_t maxPayload;
+        std::string header;
+        bool haveHeader = false;
+        uint64_t size = 0;              // Payload bytes the header announced
+        Request parsed;
+        std::string reason;
+
+        State take(const char* data, size_t length);
+    };
+
+    // Whole buffer, retrying short writes; false once the peer is gone
+    bool writeAll(int fd, const char* data, size_t size);
+
+    // "<head> <size>\n" followed by the bytes
+    bool writeFrame(int fd, const std::string& head, const char* data, size_t size);
+
+    // Request framing; readRequest rejects a payload over `maxPayload` bytes
+    // before reading it, with `error` saying why
+    bool writeRequest(int fd, const Request& request);
+    bool readRequest(Reader& in, Request& request, size_t maxPayload, std::string& error);
+
+    // Socket set-up; -1 with `error` set on failure. listenOn replaces a
+    // stale socket file left at `path` (one nothing accepts on); any other
+    // file there, or a socket a daemon is serving, is an error.
+    int listenOn(const std::string& path, std::string& error);
+    int connectTo(const std::string& path, std::string& error);
+
+} // namespace BroService
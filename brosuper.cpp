@@ -0,0 +1,353 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brosuper.cpp
+// Purpose:
+//   - Offline superoptimizer for the instruction sequences Codegen emits around
+//     each operator. For every hand-written lowering it tries all shorter
+//     sequences of RohitVM instructions, keeps the first one that behaves the
+//     same on every test vector, and writes the winners to codegen_templates.h.
+//
+// Templates searched (`op` is ADD, SUB, MUL, DIV, DIV_NC, EQ, GT, LT, MIN or MAX):
+//   → stack:    left operand pushed, right operand in AX     PUSH 0; POP 1; POP 0; op
+//   → constant: left operand in AX, right operand constant K MOV_BX K; op
+//   BX, CX and DX hold garbage on entry and may hold anything on exit.
+//
+// How a candidate is checked:
+//   1. A model of VM::executeInstruction runs it on every test vector (edge
+//      values and random ones); AX, traps (division by zero) and the final
+//      stack depth must match the hand-written sequence.
+//   2. Winners are then run on the real VM (RohitVM.cpp) next to the
+//      hand-written sequence, so a mistake in the model can not reach Codegen.
+//
+// Usage:
+//   g++ brosuper.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp -o brosuper
+//   ./brosuper -o codegen_templates.h
+// =====================================================================================
+
+#include "RohitVM.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+namespace {
+
+    struct Step {
+        Opcode op;
+        uint16_t a1 = 0;
+        bool constant = false;  // a1 is the template's constant operand
+    };
+
+    using Sequence = std::vector<Step>;
+
+    enum class Family { Stack, Constant };
+
+    struct Vector {
+        uint16_t left, right;      // right is K in the constant family
+        uint16_t bx, cx, dx;       // Garbage the sequence must not depend on
+    };
+
+    enum class Outcome { Value, Trap, Undefined };
+
+    struct Result {
+        Outcome outcome;
+        uint16_t ax;
+        bool operator==(const Result& o) const {
+            return outcome == o.outcome && (outcome != Outcome::Value || ax == o.ax);
+        }
+    };
+
+    bool hasOperand(Opcode op) {
+        return op == Opcode::MOV || op == Opcode::MOV_BX || op == Opcode::MOV_CX ||
+               op == Opcode::MOV_DX || op == Opcode::PUSH || op == Opcode::POP;
+    }
+
+    // ================= Model of VM::executeInstruction =================
+    // Registers only (no memory, no jumps); the stack is the template's own.
+
+    Result simulate(const Sequence& code, Family family, const Vector& v) {
+        uint16_t r[4] = {v.right, v.bx, v.cx, v.dx};
+        std::vector<uint16_t> stack;
+        if (family == Family::Stack) stack.push_back(v.left);
+        else r[0] = v.left;
+
+        for (const Step& s : code) {
+            uint16_t a1 = s.constant ? v.right : s.a1;
+            uint16_t& ax = r[0];
+            const uint16_t bx = r[1], cx = r[2];
+            switch (s.op) {
+                case Opcode::MOV:    r[0] = a1; break;
+                case Opcode::MOV_BX: r[1] = a1; break;
+                case Opcode::MOV_CX: r[2] = a1; break;
+                case Opcode::MOV_DX: r[3] = a1; break;
+                case Opcode::PUSH:   stack.push_back(r[a1]); break;
+                case Opcode::POP:
+                    if (stack.empty()) return {Outcome::Undefined, 0};  // Would eat the caller's stack
+                    r[a1] = stack.back();
+                    stack.pop_back();
+                    break;
+                case Opcode::ADD: ax += bx; break;
+                case Opcode::SUB: ax -= bx; break;
+                case Opcode::MUL: ax *= bx; break;
+                case Opcode::DIV:
+                    if (bx == 0) return {Outcome::Trap, 0};
+                    ax /= bx;
+                    break;
+                case Opcode::DIV_NC:
+                    if (bx == 0) return {Outcome::Undefined, 0};
+                    ax /= bx;
+                    break;
+                case Opcode::EQ:  ax = ax == bx; break;
+                case Opcode::GT:  ax = ax >  bx; break;
+                case Opcode::LT:  ax = ax <  bx; break;
+                case Opcode::MIN: ax = std::min(ax, bx); break;
+                case Opcode::MAX: ax = std::max(ax, bx); break;
+                case Opcode::CLAMP: ax = std::min(std::max(ax, bx), cx); break;
+                case Opcode::ABS: ax = (ax & 0x8000) ? static_cast<uint16_t>(-ax) : ax; break;
+                case Opcode::SGN: ax = (ax & 0x8000) ? 0xFFFF : (ax != 0); break;
+                default: return {Outcome::Undefined, 0};
+            }
+        }
+        if (!stack.empty()) return {Outcome::Undefined, 0};
+        return {Outcome::Value, r[0]};
+    }
+
+    // Instructions a candidate may use
+    std::vector<Step> alphabet(Family family) {
+        std::vector<Step> steps;
+        for (uint16_t reg = 0; reg < 4; ++reg) steps.push_back({Opcode::POP, reg});
+        for (uint16_t reg = 0; reg < 4; ++reg) steps.push_back({Opcode::PUSH, reg});
+        for (Opcode op : {Opcode::ADD, Opcode::SUB, Opcode::MUL, Opcode::DIV, Opcode::DIV_NC,
+                          Opcode::EQ, Opcode::GT, Opcode::LT, Opcode::MIN, Opcode::MAX,
+                          Opcode::CLAMP, Opcode::ABS, Opcode::SGN})
+            steps.push_back({op});
+        for (Opcode mov : {Opcode::MOV, Opcode::MOV_BX, Opcode::MOV_CX, Opcode::MOV_DX}) {
+            for (uint16_t value : {0, 1, 0xFFFF}) steps.push_back({mov, value});
+            if (family == Family::Constant) steps.push_back({mov, 0, true});
+        }
+        return steps;
+    }
+
+    std::vector<Vector> testVectors() {
+        const uint16_t edges[] = {0, 1, 2, 3, 7, 0x7FFF, 0x8000, 0x8001, 0xFFFE, 0xFFFF};
+        std::mt19937 rng(2024);  // Fixed seed: the generated file must not change between runs
+        auto word = [&] { return static_cast<uint16_t>(rng()); };
+
+        std::vector<Vector> vectors;
+        for (uint16_t left : edges)
+            for (uint16_t right : edges) vectors.push_back({left, right, word(), word(), word()});
+        for (int k = 0; k < 400; ++k) {
+            uint16_t left = word();
+            uint16_t right = (k % 4 == 0) ? left : word();   // Equal pairs for EQ
+            vectors.push_back({left, right, word(), word(), word()});
+        }
+        return vectors;
+    }
+
+    bool equivalent(const Sequence& candidate, const std::vector<Result>& expected,
+                    Family family, const std::vector<Vector>& vectors) {
+        for (size_t k = 0; k < vectors.size(); ++k) {
+            if (expected[k].outcome == Outcome::Undefined) continue;  // DIV_NC by zero: anything goes
+            if (!(simulate(candidate, family, vectors[k]) == expected[k])) return false;
+        }
+        return true;
+    }
+
+    // Depth-first search over all sequences of exactly `length` steps
+    bool search(Sequence& prefix, size_t length, const std::vector<Step>& steps,
+                const std::vector<Result>& expected, Family family,
+                const std::vector<Vector>& vectors) {
+        if (prefix.size() == length) return equivalent(prefix, expected, family, vectors);
+        for (const Step& s : steps) {
+            prefix.push_back(s);
+            if (search(prefix, length, steps, expected, family, vectors)) return true;
+            prefix.pop_back();
+        }
+        return false;
+    }
+
+    // ================= Check on the real VM =================
+
+    // Runs `code` once per vector in a single VM program, storing each AX in
+    // the data area. Returns the stored words, or nothing if SP ends off.
+    std::vector<uint16_t> runOnVM(const Sequence& code, Family family,
+                                  const std::vector<Vector>& vectors) {
+        std::vector<Instruction> program;
+        for (size_t k = 0; k < vectors.size(); ++k) {
+            const Vector& v = vectors[k];
+            program.push_back({Opcode::MOV, v.left});
+            if (family == Family::Stack) program.push_back({Opcode::PUSH, 0});
+            program.push_back({Opcode::MOV_BX, v.bx});
+            program.push_back({Opcode::MOV_CX, v.cx});
+            program.push_back({Opcode::MOV_DX, v.dx});
+            if (family == Family::Stack) program.push_back({Opcode::MOV, v.right});
+            for (const Step& s : code) program.push_back({s.op, s.constant ? v.right : s.a1});
+            program.push_back({Opcode::STORE, static_cast<uint16_t>(Memory::DATA_BASE + 2 * k)});
+        }
+        program.push_back({Opcode::HLT});
+
+        VM vm;
+        vm.banners = false;  // No register and stack dump at HLT
+        vm.loadProgram(program);
+        vm.execute();
+        if (vm.cpu.r.sp != 0xFFFF) return {};
+
+        std::vector<uint16_t> results;
+        for (size_t k = 0; k < vectors.size(); ++k) {
+            uint16_t addr = static_cast<uint16_t>(Memory::DATA_BASE + 2 * k);
+            results.push_back(vm.memory[addr] | (vm.memory[addr + 1] << 8));
+        }
+        return results;
+    }
+
+    // ================= Output =================
+
+    std::string formatSequence(const Sequence& code) {
+        std::string text;
+        for (const Step& s : code) {
+            if (!text.empty()) text += "; ";
+            text += opcodeName(s.op);
+            if (s.constant) text += " K";
+            else if (hasOperand(s.op)) text += " " + std::to_string(s.a1);
+        }
+        return text;
+    }
+
+    std::string formatTemplate(Opcode op, const Sequence& code) {
+        std::string text = "{Opcode::" + std::string(opcodeName(op)) + ", " +
+                           std::to_string(code.size()) + ", {";
+        for (size_t k = 0; k < code.size(); ++k) {
+            if (k) text += ", ";
+            text += "{Opcode::" + std::string(opcodeName(code[k].op)) + ", " +
+                    std::to_string(code[k].a1) + (code[k].constant ? ", true}" : ", false}");
+        }
+        return text + "}}";
+    }
+
+    struct Winner {
+        Opcode op;
+        Sequence code;
+        size_t handLength;
+    };
+
+    void writeTable(std::ostream& out, const char* name, const char* comment,
+                    const std::vector<Winner>& winners) {
+        out << "// " << comment << "\n";
+        out << "inline constexpr LoweringTemplate " << name << "[] = {\n";
+        for (const auto& w : winners) {
+            out << "    // " << formatSequence(w.code);
+            if (w.code.size() < w.handLength) out << " (hand-written: " << w.handLength << " instructions)";
+            out << "\n    " << formatTemplate(w.op, w.code) << ",\n";
+        }
+        out << "};\n";
+    }
+
+} // namespace
+
+// =====================================================================================
+// Function: main
+// Purpose: Searches every template and writes the table (stdout by default).
+// =====================================================================================
+int main(int argc, char* argv[]) {
+    std::string outputFile;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else {
+            std::cerr << "Usage: ./brosuper [-o codegen_templates.h]\n";
+            return 1;
+        }
+    }
+
+    const std::vector<Vector> vectors = testVectors();
+    const Opcode operators[] = {Opcode::ADD, Opcode::SUB, Opcode::MUL, Opcode::DIV, Opcode::DIV_NC,
+                                Opcode::EQ, Opcode::GT, Opcode::LT, Opcode::MIN, Opcode::MAX};
+
+    std::vector<Winner> tables[2];
+    for (Family family : {Family::Stack, Family::Constant}) {
+        const std::vector<Step> steps = alphabet(family);
+
+        for (Opcode op : operators) {
+            Sequence hand = (family == Family::Stack)
+                ? Sequence{{Opcode::PUSH, 0}, {Opcode::POP, 1}, {Opcode::POP, 0}, {op}}
+                : Sequence{{Opcode::MOV_BX, 0, true}, {op}};
+
+            std::vector<Result> expected;
+            for (const auto& v : vectors) expected.push_back(simulate(hand, family, v));
+
+            // Shortest first, so the first hit is a shortest equivalent
+            Sequence best = hand;
+            for (size_t length = 1; length < hand.size(); ++length) {
+                Sequence candidate;
+                if (search(candidate, length, steps, expected, family, vectors)) {
+                    best = candidate;
+                    break;
+                }
+            }
+
+            // Confirm on the real VM, on the vectors where both sides are defined
+            if (best.size() < hand.size()) {
+                std::vector<Vector> defined;
+                for (size_t k = 0; k < vectors.size() && defined.size() < 150; ++k)
+                    if (expected[k].outcome == Outcome::Value) defined.push_back(vectors[k]);
+
+                std::vector<uint16_t> want = runOnVM(hand, family, defined);
+                std::vector<uint16_t> got = runOnVM(best, family, defined);
+                if (want.empty() || want != got) {
+                    std::cerr << opcodeName(op) << ": " << formatSequence(best)
+                              << " differs on the VM; keeping " << formatSequence(hand) << "\n";
+                    best = hand;
+                }
+            }
+
+            std::cerr << (family == Family::Stack ? "stack    " : "constant ") << opcodeName(op)
+                      << ": " << formatSequence(best) << "\n";
+            tables[family == Family::Stack ? 0 : 1].push_back({op, best, hand.size()});
+        }
+    }
+
+    std::ofstream file;
+    if (!outputFile.empty()) {
+        file.open(outputFile);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open output file: " << outputFile << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = outputFile.empty() ? std::cout : file;
+
+    out << "// =====================================================================================\n";
+    out << "// Generated by brosuper (brosuper.cpp) - do not edit by hand.\n";
+    out << "//   g++ brosuper.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp -o brosuper\n";
+    out << "//   ./brosuper -o codegen_templates.h\n";
+    out << "//\n";
+    out << "// File: codegen_templates.h\n";
+    out << "// Purpose:\n";
+    out << "//   - Shortest instruction sequences found for each operator lowering in\n";
+    out << "//     Codegen. A step with `constant` set takes the constant operand as a1;\n";
+    out << "//     Codegen turns PUSH/POP steps into its own (depth-tracked) stack code.\n";
+    out << "// =====================================================================================\n\n";
+    out << "#pragma once\n\n";
+    out << "#include \"RohitVM.hpp\"\n";
+    out << "#include <cstdint>\n\n";
+    out << "struct TemplateStep {\n";
+    out << "    Opcode op;\n";
+    out << "    uint16_t a1;\n";
+    out << "    bool constant;\n";
+    out << "};\n\n";
+    out << "struct LoweringTemplate {\n";
+    out << "    Opcode op;             // Operator this sequence computes\n";
+    out << "    uint8_t length;\n";
+    out << "    TemplateStep steps[4];\n";
+    out << "};\n\n";
+    writeTable(out, "STACK_TEMPLATES",
+               "Left operand on the stack, right operand in AX: AX = left op right", tables[0]);
+    out << "\n";
+    writeTable(out, "CONSTANT_TEMPLATES",
+               "Left operand in AX, right operand the constant K: AX = left op K", tables[1]);
+    return 0;
+}
@@ -0,0 +1,169 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brovm.cpp
+// Purpose:
+//   - Implements libbrovm (brovm.h) on top of the same pipeline broc runs:
+//     Lexer → Parser → Optimizer → Codegen → Optimizer, then RohitVM.
+//   - Every object used here is created per call; diagnostics and program
+//     output go to per-call string streams rather than std::cerr / std::cout.
+// =====================================================================================
+
+#include "brovm.h"
+#include "lexer.h"
+#include "parser.h"
+#include "optimizer.h"
+#include "codegen.h"
+#include "brobin.h"
+#include "RohitVM.hpp"
+
+#include <sstream>
+
+namespace BroVM {
+
+    // ---------------------------------------------------------------------------------
+    // compile
+    // ---------------------------------------------------------------------------------
+    CompileResult compile(std::string_view source, const CompileOptions& options) {
+        OptimizerOptions passes = options.optimize ? OptimizerOptions() : OptimizerOptions::none();
+        passes.partialEval = options.partialEval;
+        passes.unrollFactor = options.unrollFactor;
+        passes.fuel = options.fuel;
+
+        CompileResult result;
+        std::ostringstream diagnostics;
+
+        Lexer lexer{std::string(source)};
+        std::vector<Token> tokens;
+        while (true) {
+            Token t = lexer.nextToken();
+            if (t.type == TokenType::EndOfFile) break;
+            tokens.push_back(t);
+        }
+
+        Parser parser(tokens);
+        parser.setDiagnostics(diagnostics);
+        ::Program ast = parser.parseProgram();
+        if (parser.getErrorCount() > 0) {
+            result.diagnostics = diagnostics.str();
+            return result;
+        }
+        Optimizer::run(ast, passes);
+
+        Codegen codegen(passes.profile, passes.elideChecks);
+        codegen.setDiagnostics(diagnostics);
+        std::vector<Instruction> bytecode = codegen.generate(ast);
+        std::vector<int> sourceMap = codegen.getSourceMap();
+        if (codegen.getErrorCount() > 0) {
+            result.diagnostics = diagnostics.str();
+            return result;
+        }
+        Optimizer::run(bytecode, sourceMap, passes);
+
+        auto program = std::make_shared<BroVM::Program>();
+        if (!BroBin::encode(bytecode, program->code) ||
+            program->code.size() > codegen.getDataAddress()) {
+            result.diagnostics = "Program too large: its code would overlap the data section\n";
+            return result;
+        }
+        program->instructions = bytecode.size();
+        program->dataAddress = codegen.getDataAddress();
+        program->data = codegen.getData();
+        program->statements = std::move(sourceMap);
+        result.program = std::move(program);
+        return result;
+    }
+
+    CompileResult loadImage(const uint8_t* bytes, size_t size) {
+        CompileResult result;
+        BroBin::Image image;
+        std::string error;
+        if (!BroBin::parse(bytes, size, image, error)) {
+            result.diagnostics = "Invalid image: " + error + "\n";
+            return result;
+        }
+
+        // Only broc's analyses make the unchecked opcodes safe, and the image's
+        // header flag is just a claim; the checked forms have the same sizes,
+        // so every jump target stays where it was
+        for (size_t at = 0; at < image.code.size(); at += instructionSize(static_cast<Opcode>(image.code[at])))
+            image.code[at] = static_cast<uint8_t>(checkedForm(static_cast<Opcode>(image.code[at])));
+
+        auto program = std::make_shared<BroVM::Program>();
+        program->code = std::move(image.code);
+        program->instructions = image.instructionCount;
+        program->dataAddress = image.dataAddress;
+        program->data = std::move(image.data);
+        program->statements = std::move(image.sourceMap);
+        result.program = std::move(program);
+        return result;
+    }
+
+    std::vector<uint8_t> Program::image() const {
+        BroBin::Image out;
+        out.code = code;
+        out.instructionCount = static_cast<uint32_t>(instructions);
+        out.dataAddress = dataAddress;
+        out.data = data;
+        if (statements.size() == instructions) out.sourceMap = statements;
+        out.unchecked = true;       // Any _NC opcode in `code` was placed by compile()
+        return BroBin::serialize(out);
+    }
+
+    // ---------------------------------------------------------------------------------
+    // Engine
+    // ---------------------------------------------------------------------------------
+    const char* statusName(Status status) {
+        switch (status) {
+            case Status::Halted:        return "halted";
+            case Status::Fault:         return "fault";
+            case Status::LimitExceeded: return "limit exceeded";
+        }
+        return "unknown";
+    }
+
+    RunResult Engine::run(const ProgramHandle& program, const RunOptions& options) {
+        RunResult result;
+        if (!program) {
+            result.status = Status::Fault;
+            result.error = "No program to run";
+            return result;
+        }
+        std::ostringstream output;
+
+        VM vm;
+        vm.output = options.output ? options.output : &output;
+        vm.banners = options.banners;
+        vm.instructionLimit = options.instructionLimit;
+        vm.exitOnError = false;
+
+        // The VM fetches straight from the program's code, which `program`
+        // (passed as the owner) keeps alive and which no run ever writes to
+        BroBin::View view;
+        view.code = program->code.data();
+        view.codeSize = static_cast<uint32_t>(program->code.size());
+        view.instructionCount = static_cast<uint32_t>(program->instructions);
+        view.dataAddress = program->dataAddress;
+        view.data = program->data.data();
+        view.dataSize = static_cast<uint32_t>(program->data.size());
+
+        try {
+            if (vm.loadImage(view, program)) vm.execute();
+            result.error = vm.getError();
+        } catch (const std::exception& ex) {
+            result.error = ex.what();
+        }
+
+        // The VM records why it stopped; an image that did not load never ran
+        switch (vm.getStop()) {
+            case VM::Stop::Halted: result.status = Status::Halted; break;
+            case VM::Stop::Limit:  result.status = Status::LimitExceeded; break;
+            default:               result.status = Status::Fault; break;
+        }
+        result.output = output.str();
+        result.instructions = vm.instructionCount;
+        return result;
+    }
+
+} // namespace BroVM
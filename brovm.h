@@ -0,0 +1,141 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: brovm.h
+// Purpose:
+//   - libbrovm: BroLang as a library, for services that compile and run
+//     programs themselves instead of calling broc and run_bro.
+//   - compile() turns source into an immutable Program (loadImage() reads one
+//     from a `.brobin` file's bytes); Engine::run() executes one on a fresh VM
+//     and hands back a status with everything it printed.
+//
+// Threads:
+//   - Nothing here, nor in the compiler and VM underneath, keeps global or
+//     static mutable state: any number of threads may compile and run at once.
+//   - A Program never changes after compile(), so one handle can be shared and
+//     run by many threads together. Its code is executed in place, not copied.
+//   - Errors never print or exit: they come back in CompileResult::diagnostics
+//     and RunResult::error.
+//
+// Usage:
+//   BroVM::CompileResult compiled = BroVM::compile("printbro(6 * 7);");
+//   if (!compiled.program) { report(compiled.diagnostics); return; }
+//   BroVM::RunResult result = BroVM::Engine::run(compiled.program);
+//   // result.status == BroVM::Status::Halted, result.output == "Output: 42\n..."
+//
+// Build (static library):
+//   g++ -c brovm.cpp lexer.cpp parser.cpp astutils.cpp licm.cpp strength.cpp cse.cpp unroll.cpp evaluator.cpp jumpthread.cpp cfg.cpp blocklayout.cpp range.cpp boundscheck.cpp optimizer.cpp profile.cpp codegen.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp
+//   ar rcs libbrovm.a brovm.o lexer.o parser.o astutils.o licm.o strength.o cse.o unroll.o evaluator.o jumpthread.o cfg.o blocklayout.o range.o boundscheck.o optimizer.o profile.o codegen.o RohitVM.o RohitUtils.o brobin.o
+//   g++ service.cpp libbrovm.a -pthread -o service
+// =====================================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BroVM {
+
+    // ---------------------------------------------------------------------------------
+    // Struct: CompileOptions
+    // Purpose: The optimizer switches broc and brorun take on the command line
+    // ---------------------------------------------------------------------------------
+    struct CompileOptions {
+        bool optimize = true;       // false: every pass off (broc -O0)
+        bool partialEval = false;   // Run the program at compile time (--partial-eval)
+        int unrollFactor = 4;       // Body copies per partially unrolled loop (--unroll=N)
+        long fuel = 1000000;        // VM instructions partial evaluation may simulate (--fuel=N)
+    };
+
+    struct CompileResult;
+    class Engine;
+
+    // ---------------------------------------------------------------------------------
+    // Class: Program
+    // Purpose: A compiled program, read-only once compile() returns it
+    // ---------------------------------------------------------------------------------
+    class Program {
+    public:
+        size_t instructionCount() const { return instructions; }
+
+        // Statement id (source order) each instruction came from, -1 for none
+        const std::vector<int>& sourceMap() const { return statements; }
+
+        // The same program as a `.brobin` file (brobin.h), e.g. to cache it
+        std::vector<uint8_t> image() const;
+
+    private:
+        friend CompileResult compile(std::string_view source, const CompileOptions& options);
+        friend CompileResult loadImage(const uint8_t* bytes, size_t size);
+        friend class Engine;
+
+        std::vector<uint8_t> code;     // Encoded as in a .brobin image
+        size_t instructions = 0;
+        uint16_t dataAddress = 0;
+        std::vector<uint8_t> data;
+        std::vector<int> statements;
+    };
+
+    using ProgramHandle = std::shared_ptr<const Program>;
+
+    struct CompileResult {
+        ProgramHandle program;      // nullptr if the source has errors
+        std::string diagnostics;    // Every error message, one per line
+    };
+
+    // Lexes, parses, optimizes and generates code for `source`
+    CompileResult compile(std::string_view source, const CompileOptions& options = CompileOptions());
+
+    // A program compiled earlier (Program::image(), broc -o x.brobin); checked
+    // the way run_bro checks an image, the reason in diagnostics if it is invalid.
+    // The bytes may come from anyone, so DIV_NC, PUSH_NC and POP_NC are turned
+    // into DIV, PUSH and POP: a crafted image faults instead of taking the host
+    // process down with it.
+    CompileResult loadImage(const uint8_t* bytes, size_t size);
+
+    // ---------------------------------------------------------------------------------
+    // Running
+    // ---------------------------------------------------------------------------------
+    enum class Status {
+        Halted,         // Reached HLT
+        Fault,          // Division by zero, bad array index, stack overflow, ...
+        LimitExceeded   // Ran RunOptions::instructionLimit instructions without halting
+    };
+
+    // "halted", "fault" or "limit exceeded"
+    const char* statusName(Status status);
+
+    struct RunOptions {
+        uint64_t instructionLimit = UINT64_MAX;
+        bool banners = false;       // Also capture "Starting VM Execution..." and the HLT
+                                    // register dump, exactly as run_bro prints them
+        std::ostream* output = nullptr;  // Set: output is written here while the program
+                                         // runs (RunResult::output stays empty), e.g. to
+                                         // stream it; an exception the stream throws
+                                         // stops the program with a fault
+    };
+
+    struct RunResult {
+        Status status = Status::Halted;
+        std::string output;         // Everything the program printed, up to where it stopped
+                                    // (unless RunOptions::output took it)
+        std::string error;          // Why it stopped, unless Halted
+        uint64_t instructions = 0;  // Instructions executed
+    };
+
+    // ---------------------------------------------------------------------------------
+    // Class: Engine
+    // Purpose: Runs programs, each on its own VM (static utility class, like Optimizer)
+    // ---------------------------------------------------------------------------------
+    class Engine {
+    public:
+        // A null handle comes back as a Fault, with the reason in `error`
+        static RunResult run(const ProgramHandle& program, const RunOptions& options = RunOptions());
+    };
+
+} // namespace BroVM
@@ -0,0 +1,177 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: cfg.cpp
+// Purpose:
+//   - Builds basic blocks and edges from VM code, then computes dominators
+//     with the iterative algorithm of Cooper, Harvey and Kennedy and marks
+//     natural loops.
+// =====================================================================================
+
+#include "cfg.h"
+
+namespace {
+
+    bool isJump(Opcode op) {
+        return op == Opcode::JMP || op == Opcode::JZ || op == Opcode::JNZ;
+    }
+
+} // namespace
+
+ControlFlowGraph::ControlFlowGraph(const std::vector<Instruction>& code) {
+    buildBlocks(code);
+    computeDominators();
+    findLoops();
+}
+
+// =====================================================================================
+// Function: buildBlocks
+// Purpose:
+//   - Leaders (first instructions of blocks) are: instruction 0, every jump
+//     target, and every instruction after a jump or HLT.
+// =====================================================================================
+void ControlFlowGraph::buildBlocks(const std::vector<Instruction>& code) {
+    std::vector<bool> leader(code.size() + 1, false);
+    leader[0] = true;
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (isJump(code[i].op)) {
+            if (code[i].a1 <= code.size()) leader[code[i].a1] = true;
+            leader[i + 1] = true;
+        } else if (code[i].op == Opcode::HLT) {
+            leader[i + 1] = true;
+        }
+    }
+
+    blockIndex.assign(code.size(), -1);
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (leader[i]) {
+            BasicBlock block;
+            block.start = i;
+            blockList.push_back(block);
+        }
+        blockList.back().end = i + 1;
+        blockIndex[i] = static_cast<int>(blockList.size()) - 1;
+    }
+
+    // ---------------- Edges ----------------
+    for (size_t b = 0; b < blockList.size(); ++b) {
+        BasicBlock& block = blockList[b];
+        const Instruction& last = code[block.end - 1];
+
+        if (isJump(last.op) && last.a1 < code.size())
+            block.succs.push_back(blockIndex[last.a1]);
+        if (last.op != Opcode::JMP && last.op != Opcode::HLT && block.end < code.size())
+            block.succs.push_back(blockIndex[block.end]);
+
+        // JZ/JNZ to the next instruction: one edge is enough
+        if (block.succs.size() == 2 && block.succs[0] == block.succs[1])
+            block.succs.pop_back();
+
+        for (int s : block.succs)
+            blockList[s].preds.push_back(static_cast<int>(b));
+    }
+}
+
+// =====================================================================================
+// Function: computeDominators
+// Purpose:
+//   - Numbers reachable blocks in reverse postorder, then repeatedly sets each
+//     block's idom to the common dominator of its processed predecessors until
+//     nothing changes.
+// =====================================================================================
+void ControlFlowGraph::computeDominators() {
+    rpoNumber.assign(blockList.size(), -1);
+    reversePostorder.clear();
+    if (blockList.empty()) return;
+
+    // Depth-first postorder without recursion (programs can be long)
+    std::vector<int> postorder;
+    std::vector<std::pair<int, size_t>> stack = {{0, 0}};
+    blockList[0].reachable = true;
+    while (!stack.empty()) {
+        auto& [b, next] = stack.back();
+        if (next < blockList[b].succs.size()) {
+            int s = blockList[b].succs[next++];
+            if (!blockList[s].reachable) {
+                blockList[s].reachable = true;
+                stack.push_back({s, 0});
+            }
+        } else {
+            postorder.push_back(b);
+            stack.pop_back();
+        }
+    }
+    reversePostorder.assign(postorder.rbegin(), postorder.rend());
+    for (size_t i = 0; i < reversePostorder.size(); ++i)
+        rpoNumber[reversePostorder[i]] = static_cast<int>(i);
+
+    // Walk both fingers up the dominator tree until they meet
+    auto intersect = [&](int a, int b) {
+        while (a != b) {
+            while (rpoNumber[a] > rpoNumber[b]) a = blockList[a].idom;
+            while (rpoNumber[b] > rpoNumber[a]) b = blockList[b].idom;
+        }
+        return a;
+    };
+
+    blockList[0].idom = 0;  // Temporarily its own dominator, so intersect() stops there
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 1; i < reversePostorder.size(); ++i) {
+            int b = reversePostorder[i];
+            int newIdom = -1;
+            for (int p : blockList[b].preds) {
+                if (blockList[p].idom < 0) continue;  // Not processed yet (or unreachable)
+                newIdom = (newIdom < 0) ? p : intersect(p, newIdom);
+            }
+            if (newIdom != blockList[b].idom) {
+                blockList[b].idom = newIdom;
+                changed = true;
+            }
+        }
+    }
+    blockList[0].idom = -1;
+}
+
+bool ControlFlowGraph::dominates(int a, int b) const {
+    if (!blockList[a].reachable || !blockList[b].reachable) return false;
+    while (b != a && b != 0) b = blockList[b].idom;
+    return b == a;
+}
+
+// =====================================================================================
+// Function: findLoops
+// Purpose:
+//   - Each header of back edges (latch → header) defines a natural loop: the
+//     header plus every block that reaches a latch without passing through
+//     the header. Every block in it gets one more level of loop depth.
+// =====================================================================================
+void ControlFlowGraph::findLoops() {
+    // Back edges sharing a header (e.g. both ifbro branches jumping back to a
+    // whilebro condition) belong to the same loop
+    std::vector<std::vector<int>> latches(blockList.size());
+    for (size_t b = 0; b < blockList.size(); ++b)
+        for (int s : blockList[b].succs)
+            if (isBackEdge(static_cast<int>(b), s)) latches[s].push_back(static_cast<int>(b));
+
+    for (size_t header = 0; header < blockList.size(); ++header) {
+        if (latches[header].empty()) continue;
+
+        std::vector<bool> inLoop(blockList.size(), false);
+        inLoop[header] = true;
+        std::vector<int> work = latches[header];
+        while (!work.empty()) {
+            int b = work.back();
+            work.pop_back();
+            if (inLoop[b]) continue;
+            inLoop[b] = true;
+            for (int p : blockList[b].preds)
+                if (blockList[p].reachable) work.push_back(p);
+        }
+
+        for (size_t b = 0; b < blockList.size(); ++b)
+            if (inLoop[b]) ++blockList[b].loopDepth;
+    }
+}
@@ -0,0 +1,77 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: cfg.h
+// Purpose:
+//   - Declares the control-flow graph (CFG) built over generated VM code.
+//   - A basic block is a run of instructions that is entered only at the top
+//     and left only at the bottom. Edges follow jumps and fallthroughs.
+//   - Also computes dominators (block A dominates B if every path from the
+//     entry to B passes through A) and natural loops, which instruction-level
+//     passes use to tell hot code from cold.
+//
+// Example:
+//   0: LOAD i           B0 = [0,4)  → B2 (JZ taken), B1 (fallthrough)
+//   1: MOV_BX 10
+//   2: LT
+//   3: JZ 6
+//   4: ...body          B1 = [4,6)  → B0 (back edge: B0 dominates B1)
+//   5: JMP 0
+//   6: HLT              B2 = [6,7)
+// =====================================================================================
+
+#pragma once
+
+#include "RohitVM.hpp"   // Instruction and Opcode definitions
+#include <cstddef>
+#include <vector>
+
+// -------------------------------------------------------------------------------------
+// Struct: BasicBlock
+// -------------------------------------------------------------------------------------
+struct BasicBlock {
+    size_t start = 0;           // First instruction index
+    size_t end = 0;             // One past the last instruction index
+    std::vector<int> succs;     // Successor blocks (taken target first for JZ/JNZ)
+    std::vector<int> preds;     // Predecessor blocks
+    int idom = -1;              // Immediate dominator (-1 for the entry and unreachable blocks)
+    int loopDepth = 0;          // Number of natural loops containing this block
+    bool reachable = false;     // Reachable from the entry block
+};
+
+// =====================================================================================
+// Class: ControlFlowGraph
+// Purpose:
+//   - Built from an instruction list whose jump operands are instruction
+//     indices (Codegen output after patchJumps). Block 0 is the entry.
+//
+// Usage:
+//   ControlFlowGraph cfg(code);
+//   if (cfg.dominates(a, b)) ...
+// =====================================================================================
+class ControlFlowGraph {
+public:
+    explicit ControlFlowGraph(const std::vector<Instruction>& code);
+
+    const std::vector<BasicBlock>& blocks() const { return blockList; }
+
+    // Block containing instruction `index`
+    int blockOf(size_t index) const { return blockIndex[index]; }
+
+    // True if every path from the entry to `b` passes through `a`
+    bool dominates(int a, int b) const;
+
+    // True if `from → to` is a loop back edge (`to` dominates `from`)
+    bool isBackEdge(int from, int to) const { return dominates(to, from); }
+
+private:
+    void buildBlocks(const std::vector<Instruction>& code);
+    void computeDominators();
+    void findLoops();
+
+    std::vector<BasicBlock> blockList;
+    std::vector<int> blockIndex;      // Instruction index → block
+    std::vector<int> reversePostorder;
+    std::vector<int> rpoNumber;       // Block → position in reversePostorder
+};
@@ -13,8 +13,36 @@
 // =====================================================================================
 
 #include "codegen.h"
+#include "astutils.h"
+#include "codegen_templates.h"
 #include <iostream>
 
+namespace {
+
+    // PUSHes from an empty stack (SP = 0xFFFF) before VM::push reports overflow
+    constexpr int STACK_WORDS = (Memory::SIZE - 1) / 2;
+
+    // String literals end at DATA_BASE and may take up to 16 KB below it
+    constexpr size_t MAX_STRING_DATA = 0x4000;
+
+    template <size_t N>
+    const LoweringTemplate* findTemplate(const LoweringTemplate (&table)[N], Opcode op) {
+        for (const auto& entry : table)
+            if (entry.op == op) return &entry;
+        return nullptr;
+    }
+
+} // namespace
+
+Codegen::Codegen(const Profile* profile, bool uncheckedOps)
+    : profile(profile), uncheckedOps(uncheckedOps) {}
+
+// Counts an error; the caller writes the message
+std::ostream& Codegen::error() {
+    ++errorCount;
+    return *diagnostics;
+}
+
 // =====================================================================================
 // Function: generate
 // Purpose:
@@ -22,19 +50,44 @@
 //   - Walks through the program's statements and emits VM instructions.
 // =====================================================================================
 std::vector<Instruction> Codegen::generate(const Program& program) {
+    errorCount = 0;
     instructions.clear();
+    sourceMap.clear();
     symbolTable.clear();
+    arrayTable.clear();
+    arraySizes.clear();
+    declared.clear();
     labelPlaceholders.clear();
     labelTargets.clear();
-    nextRegister = 1;
+    coldBlocks.clear();
+    stringData.clear();
+    stringOffsets.clear();
+    stringPlaceholders.clear();
+    nextAddress = Memory::DATA_BASE;
     labelCounter = 0;
+    currentStatement = -1;
+    stackDepth = 0;
 
     for (const auto& stmt : program.statements) {
         genStatement(stmt);  // Compile each statement into bytecode
     }
 
     emit({Opcode::HLT});  // Add HALT at end
+
+    // Cold branches live after HLT, off the hot path (they may add more)
+    for (size_t i = 0; i < coldBlocks.size(); ++i) {
+        ColdBlock block = coldBlocks[i];
+        declared = block.declared;
+        markLabel(block.label);
+        for (const auto& s : *block.stmts)
+            genStatement(s);
+        currentStatement = block.statementId;
+        emitJumpPlaceholder(Opcode::JMP, block.returnLabel);
+        currentStatement = -1;
+    }
+
     patchJumps();         // Resolve all jump labels
+    patchStrings();       // And string addresses
     return instructions;
 }
 
@@ -44,6 +97,32 @@ std::vector<Instruction> Codegen::generate(const Program& program) {
 // =====================================================================================
 void Codegen::emit(const Instruction& instr) {
     instructions.push_back(instr);
+    sourceMap.push_back(currentStatement);
+}
+
+// =====================================================================================
+// String Data
+// =====================================================================================
+
+// The same literal printed twice is stored once
+uint16_t Codegen::internString(const std::string& text) {
+    auto it = stringOffsets.find(text);
+    if (it != stringOffsets.end()) return it->second;
+
+    if (stringData.size() + text.size() > MAX_STRING_DATA) {
+        error() << "Error: String literals need more than " << MAX_STRING_DATA << " bytes\n";
+        return 0;
+    }
+    uint16_t offset = static_cast<uint16_t>(stringData.size());
+    stringData.insert(stringData.end(), text.begin(), text.end());
+    stringOffsets[text] = offset;
+    return offset;
+}
+
+// The section is only placed (right below DATA_BASE) once its size is known
+void Codegen::patchStrings() {
+    for (const auto& [index, offset] : stringPlaceholders)
+        instructions[index].a1 = getDataAddress() + offset;
 }
 
 // =====================================================================================
@@ -72,32 +151,98 @@ void Codegen::patchJumps() {
         if (labelTargets.count(labelId)) {
             instructions[index].a1 = labelTargets[labelId];
         } else {
-            std::cerr << "Error: Unknown label ID " << labelId << "\n";
+            error() << "Error: Unknown label ID " << labelId << "\n";
         }
     }
 }
 
+// Returns the variable's memory slot, giving it the next free one on first use
+uint16_t Codegen::addressOf(const std::string& name) {
+    auto it = symbolTable.find(name);
+    if (it != symbolTable.end()) return it->second;
+
+    uint16_t addr = nextAddress;
+    nextAddress += 2;  // One 16-bit word per variable
+    symbolTable[name] = addr;
+    return addr;
+}
+
+// Returns the array's first element, giving it `size` words on first use
+uint16_t Codegen::arrayAddress(const std::string& name, int size) {
+    auto it = arrayTable.find(name);
+    if (it != arrayTable.end()) return it->second;
+
+    if (nextAddress + 2u * size > Memory::DATA_END)
+        error() << "Error: Not enough memory for array " << name << "\n";
+
+    uint16_t addr = nextAddress;
+    nextAddress += 2 * size;
+    arrayTable[name] = addr;
+    arraySizes[name] = size;
+    return addr;
+}
+
+void Codegen::emitBoundsCheck(int size, bool inBounds) {
+    if (!(uncheckedOps && inBounds))
+        emit({Opcode::CHK, static_cast<uint16_t>(size)});
+}
+
+// =====================================================================================
+// Stack Utilities
+// Every expression pops what it pushes, and the only jumps inside an
+// expression (&& and ||) land at the depth they left from, so the depth at
+// each PUSH/POP is known exactly: a PUSH below STACK_WORDS can not overflow
+// and a POP above zero can not underflow.
+// =====================================================================================
+void Codegen::emitPush(uint16_t reg) {
+    bool safe = uncheckedOps && stackDepth < STACK_WORDS;
+    emit({safe ? Opcode::PUSH_NC : Opcode::PUSH, reg});
+    ++stackDepth;
+}
+
+void Codegen::emitPop(uint16_t reg) {
+    bool safe = uncheckedOps && stackDepth > 0;
+    emit({safe ? Opcode::POP_NC : Opcode::POP, reg});
+    --stackDepth;
+}
+
 // =====================================================================================
 // Function: genStatement
 // Purpose:
 //   - Translates each high-level language statement into VM instructions.
-//   - Supports: variable declarations, printing, conditionals (if/else), and loops.
+//   - Supports: variable declarations, arrays, printing, conditionals (if/else), and loops.
 // =====================================================================================
 void Codegen::genStatement(const StmtPtr& stmt) {
+    int outerStatement = currentStatement;
+    currentStatement = stmt->id;  // Source map: instructions below belong to this statement
+
     // ---------------- Let Statement ----------------
     if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
         genExpression(let->value);
+        declared.insert(let->name);
+        emit({Opcode::STORE, addressOf(let->name)}); // Store AX in the variable's slot
+    }
 
-        uint16_t reg;
-        if (!symbolTable.count(let->name)) {
-            reg = nextRegister++;
-            symbolTable[let->name] = reg;
+    // ---------------- Array Statements ----------------
+    // Declaration: reserves the elements (zeroed memory), no code.
+    // Store: value, then index (checked), then STX writes BX to element AX.
+    else if (auto decl = std::dynamic_pointer_cast<ArrayDeclStatement>(stmt)) {
+        arrayAddress(decl->name, decl->size);
+    }
+    else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt)) {
+        uint16_t base = arrayAddress(store->array, store->size);
+        if (auto num = std::dynamic_pointer_cast<NumberExpr>(store->value)) {
+            genExpression(store->index);
+            emitBoundsCheck(store->size, store->inBounds);
+            emit({Opcode::MOV_BX, static_cast<uint16_t>(num->value)});
         } else {
-            reg = symbolTable[let->name];
+            genExpression(store->value);
+            emitPush(0);
+            genExpression(store->index);
+            emitBoundsCheck(store->size, store->inBounds);
+            emitPop(1);  // Value → BX
         }
-
-        emit({Opcode::PUSH, 0});  // Push value in AX
-        emit({Opcode::POP, reg}); // Store in variable register
+        emit({Opcode::STX, base});
     }
 
     // ---------------- Print Statement ----------------
@@ -106,20 +251,40 @@ void Codegen::genStatement(const StmtPtr& stmt) {
         emit({Opcode::PRN});         // Print result (AX)
     }
 
+    // ---------------- Print String: one PRS over the data section ----------------
+    else if (auto print = std::dynamic_pointer_cast<PrintStringStatement>(stmt)) {
+        if (print->text.empty()) return;
+        stringPlaceholders.push_back({instructions.size(), internString(print->text)});
+        emit({Opcode::PRS, 0, static_cast<uint16_t>(print->text.size())});
+    }
+
     // ---------------- If Statement ----------------
     else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
-        genExpression(ifs->condition);
-        emit({Opcode::PUSH, 0});
-        emit({Opcode::POP, 1});
-        emit({Opcode::MOV, 0});
-        emit({Opcode::SUB});
-        emit({Opcode::STE});
-        emit({Opcode::CLE});
+        // Taken branches per layout: default = one per else path (plus one per
+        // then path if there is an else); a cold branch moved out of line costs
+        // two each time it runs and nothing otherwise.
+        const BranchProfile* counts = profile ? profile->branch(ifs->id) : nullptr;
+        if (counts) {
+            uint64_t taken = counts->falseCount() + (ifs->elseBranch.empty() ? 0 : counts->trueCount);
+            uint64_t thenCold = 2 * counts->trueCount;
+            uint64_t elseCold = ifs->elseBranch.empty() ? taken : 2 * counts->falseCount();
+
+            if (thenCold < taken && thenCold <= elseCold) {
+                genIfWithColdBranch(*ifs, true);
+                currentStatement = outerStatement;
+                return;
+            }
+            if (elseCold < taken) {
+                genIfWithColdBranch(*ifs, false);
+                currentStatement = outerStatement;
+                return;
+            }
+        }
 
         int elseLabel = newLabel();
         int endLabel = newLabel();
 
-        emitJumpPlaceholder(Opcode::JZ, elseLabel);  // If AX == 0 → jump to else
+        genBranch(ifs->condition, false, elseLabel);  // If false → jump to else
 
         for (const auto& s : ifs->thenBranch)
             genStatement(s);
@@ -135,20 +300,20 @@ void Codegen::genStatement(const StmtPtr& stmt) {
 
     // ---------------- While Statement ----------------
     else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+        // Usually iterates more than once per entry: test at the bottom instead
+        const BranchProfile* counts = profile ? profile->branch(wh->id) : nullptr;
+        if (counts && counts->trueCount > counts->falseCount()) {
+            genRotatedWhile(*wh);
+            currentStatement = outerStatement;
+            return;
+        }
+
         int condLabel = newLabel();
         int endLabel = newLabel();
 
         markLabel(condLabel);  // Loop start
 
-        genExpression(wh->condition);
-        emit({Opcode::PUSH, 0});
-        emit({Opcode::POP, 1});
-        emit({Opcode::MOV, 0});
-        emit({Opcode::SUB});
-        emit({Opcode::STE});
-        emit({Opcode::CLE});
-
-        emitJumpPlaceholder(Opcode::JZ, endLabel);  // Break loop if false
+        genBranch(wh->condition, false, endLabel);  // Break loop if false
 
         for (const auto& s : wh->body)
             genStatement(s);
@@ -156,13 +321,121 @@ void Codegen::genStatement(const StmtPtr& stmt) {
         emitJumpPlaceholder(Opcode::JMP, condLabel);  // Loop back
         markLabel(endLabel);  // Loop exit
     }
+
+    currentStatement = outerStatement;
+}
+
+// =====================================================================================
+// Function: genIfWithColdBranch
+// Purpose:
+//   - Lays out an ifbro so its hot branch falls straight through:
+//         cond; JNZ/JZ cold; <hot branch>; end:
+//     The cold branch is generated after HLT and ends with `JMP end`.
+// =====================================================================================
+void Codegen::genIfWithColdBranch(const IfStatement& ifs, bool thenIsCold) {
+    const auto& hot = thenIsCold ? ifs.elseBranch : ifs.thenBranch;
+    const auto& cold = thenIsCold ? ifs.thenBranch : ifs.elseBranch;
+
+    int coldLabel = newLabel();
+    int endLabel = newLabel();
+    genBranch(ifs.condition, thenIsCold, coldLabel);
+
+    coldBlocks.push_back({coldLabel, endLabel, ifs.id, &cold, declared});
+
+    // Code after the ifbro may read what the cold branch declares
+    std::set<std::string> coldAssigned;
+    AstUtils::collectAssigned(cold, coldAssigned);
+
+    for (const auto& s : hot)
+        genStatement(s);
+
+    declared.insert(coldAssigned.begin(), coldAssigned.end());
+    markLabel(endLabel);
+}
+
+// =====================================================================================
+// Function: genRotatedWhile
+// Purpose:
+//   - Tests the condition at the bottom, so each iteration ends in one taken
+//     JNZ instead of a JMP back to a JZ at the top:
+//         cond; JZ end; body: <body>; cond; JNZ body; end:
+// =====================================================================================
+void Codegen::genRotatedWhile(const WhileStatement& wh) {
+    int bodyLabel = newLabel();
+    int endLabel = newLabel();
+
+    auto declaredAtCondition = declared;  // The bottom copy sees what the top one sees
+
+    genBranch(wh.condition, false, endLabel);  // Loop not entered at all
+
+    markLabel(bodyLabel);
+    for (const auto& s : wh.body)
+        genStatement(s);
+
+    std::swap(declared, declaredAtCondition);
+    genBranch(wh.condition, true, bodyLabel);  // Next iteration
+    std::swap(declared, declaredAtCondition);
+    markLabel(endLabel);
+}
+
+// =====================================================================================
+// Function: genBranch
+// Purpose:
+//   - Lowers a condition straight to jumps, without computing its 0/1 value:
+//       a && b, jump if false:  a; JZ L; b; JZ L
+//       a || b, jump if false:  a; JNZ skip; b; JZ L; skip:
+//     (and the mirror images when jumping if true).
+//   - Inside && / ||, `!a` (parsed as `a == 0`) jumps on `a` with the
+//     opposite sense instead of comparing it with 0.
+//   - Jumps that test only part of a condition get no statement id: a
+//     profile reads every JZ/JNZ of a statement as a test of its whole
+//     condition (see profile.cpp).
+// =====================================================================================
+void Codegen::genBranch(const ExprPtr& cond, bool jumpIfTrue, int labelId) {
+    auto bin = std::dynamic_pointer_cast<BinaryExpr>(cond);
+    bool logical = bin && (bin->op == BinaryOp::And || bin->op == BinaryOp::Or);
+
+    if (logical) {
+        bool isAnd = bin->op == BinaryOp::And;
+        ++shortCircuitDepth;
+        if (jumpIfTrue != isAnd) {
+            // Either operand alone decides: && is false / || is true
+            genBranch(bin->left, jumpIfTrue, labelId);
+            genBranch(bin->right, jumpIfTrue, labelId);
+        } else {
+            // The left operand can only rule the jump out
+            int skipLabel = newLabel();
+            genBranch(bin->left, !jumpIfTrue, skipLabel);
+            genBranch(bin->right, jumpIfTrue, labelId);
+            markLabel(skipLabel);
+        }
+        --shortCircuitDepth;
+        return;
+    }
+
+    if (bin && bin->op == BinaryOp::Equal) {
+        auto zero = std::dynamic_pointer_cast<NumberExpr>(bin->right);
+        auto inner = std::dynamic_pointer_cast<BinaryExpr>(bin->left);
+        bool innerLogical = inner && (inner->op == BinaryOp::And || inner->op == BinaryOp::Or);
+        if (zero && static_cast<uint16_t>(zero->value) == 0 && (shortCircuitDepth > 0 || innerLogical)) {
+            genBranch(bin->left, !jumpIfTrue, labelId);
+            return;
+        }
+    }
+
+    genExpression(cond);
+
+    int owner = currentStatement;
+    if (shortCircuitDepth > 0) currentStatement = -1;
+    emitJumpPlaceholder(jumpIfTrue ? Opcode::JNZ : Opcode::JZ, labelId);
+    currentStatement = owner;
 }
 
 // =====================================================================================
 // Function: genExpression
 // Purpose:
-//   - Translates expressions (numbers, variables, and binary operations)
-//     into VM instructions.
+//   - Translates expressions (numbers, variables, array elements, intrinsic
+//     calls and binary operations) into VM instructions.
 // =====================================================================================
 void Codegen::genExpression(const ExprPtr& expr) {
     // --- Number constant ---
@@ -172,37 +445,144 @@ void Codegen::genExpression(const ExprPtr& expr) {
 
     // --- Variable access ---
     else if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr)) {
-        if (!symbolTable.count(var->name)) {
-            std::cerr << "Unknown variable: " << var->name << "\n";
+        if (!declared.count(var->name)) {
+            error() << "Unknown variable: " << var->name << "\n";
             emit({Opcode::MOV, 0});
             return;
         }
 
-        uint16_t reg = symbolTable[var->name];
-        emit({Opcode::PUSH, reg});
-        emit({Opcode::POP, 0});  // Load variable into AX
+        emit({Opcode::LOAD, addressOf(var->name)});  // Load variable into AX
+    }
+
+    // --- Array element: index in AX, checked, then LDX ---
+    else if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr)) {
+        genExpression(idx->index);
+        emitBoundsCheck(idx->size, idx->inBounds);
+        emit({Opcode::LDX, arrayAddress(idx->array, idx->size)});
+    }
+
+    // --- Intrinsic call: arguments in AX, BX, CX, then one opcode ---
+    else if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+        genExpression(call->args[0]);
+
+        // Two arguments: lowered like a binary operator
+        if (call->fn == Intrinsic::Min || call->fn == Intrinsic::Max) {
+            emitOperator(call->fn == Intrinsic::Min ? Opcode::MIN : Opcode::MAX, call->args[1]);
+            return;
+        }
+
+        // Computed arguments go through the stack, like a binary right operand
+        std::vector<size_t> computed;
+        for (size_t k = 1; k < call->args.size(); ++k)
+            if (!std::dynamic_pointer_cast<NumberExpr>(call->args[k])) computed.push_back(k);
+        if (!computed.empty()) {
+            emitPush(0);
+            for (size_t k : computed) {
+                genExpression(call->args[k]);
+                emitPush(0);
+            }
+            for (auto it = computed.rbegin(); it != computed.rend(); ++it)
+                emitPop(static_cast<uint16_t>(*it));  // Argument k → register k (BX, CX)
+            emitPop(0);
+        }
+
+        // Constant arguments last, so nothing above can clobber them
+        for (size_t k = 1; k < call->args.size(); ++k)
+            if (auto num = std::dynamic_pointer_cast<NumberExpr>(call->args[k]))
+                emit({k == 1 ? Opcode::MOV_BX : Opcode::MOV_CX, static_cast<uint16_t>(num->value)});
+
+        switch (call->fn) {
+            case Intrinsic::Abs:   emit({Opcode::ABS}); break;
+            case Intrinsic::Clamp: emit({Opcode::CLAMP}); break;
+            case Intrinsic::Sign:  emit({Opcode::SGN}); break;
+            default: break;
+        }
     }
 
     // --- Binary operation ---
     else if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
-        genExpression(bin->left);
-        emit({Opcode::PUSH, 0});
-        genExpression(bin->right);
-        emit({Opcode::PUSH, 0});
-        emit({Opcode::POP, 1});  // Right operand → BX
-        emit({Opcode::POP, 0});  // Left operand  → AX
+        // && / || used as a value: branch code, then materialize 0 or 1
+        if (bin->op == BinaryOp::And || bin->op == BinaryOp::Or) {
+            int falseLabel = newLabel();
+            int endLabel = newLabel();
+            genBranch(expr, false, falseLabel);
+            emit({Opcode::MOV, 1});
+            emitJumpPlaceholder(Opcode::JMP, endLabel);
+            markLabel(falseLabel);
+            emit({Opcode::MOV, 0});
+            markLabel(endLabel);
+            return;
+        }
 
+        // Shift by a constant (only produced by the optimizer): one instruction
+        if (bin->op == BinaryOp::Shl || bin->op == BinaryOp::Shr) {
+            auto amount = std::dynamic_pointer_cast<NumberExpr>(bin->right);
+            if (!amount) {
+                error() << "Shift amount must be a constant\n";
+                return;
+            }
+            genExpression(bin->left);
+            emit({bin->op == BinaryOp::Shl ? Opcode::SHL : Opcode::SHR,
+                  static_cast<uint16_t>(amount->value)});
+            return;
+        }
+
+        Opcode op;
         switch (bin->op) {
-            case BinaryOp::Add:     emit({Opcode::ADD}); break;
-            case BinaryOp::Sub:     emit({Opcode::SUB}); break;
-            case BinaryOp::Mul:     emit({Opcode::MUL}); break;
-            case BinaryOp::Div:     emit({Opcode::DIV}); break;
-            case BinaryOp::Equal:   emit({Opcode::SUB}); emit({Opcode::STE}); break;
-            case BinaryOp::Greater: emit({Opcode::SUB}); emit({Opcode::STG}); break;
-            case BinaryOp::Less:    emit({Opcode::SUB}); emit({Opcode::STL}); break;
-            default:
-                std::cerr << "Unknown binary operator\n";
+            case BinaryOp::Add:     op = Opcode::ADD; break;
+            case BinaryOp::Sub:     op = Opcode::SUB; break;
+            case BinaryOp::Mul:     op = Opcode::MUL; break;
+            case BinaryOp::Div:
+                op = uncheckedOps && bin->divisorNonZero ? Opcode::DIV_NC : Opcode::DIV;
                 break;
+            case BinaryOp::Equal:   op = Opcode::EQ; break;
+            case BinaryOp::Greater: op = Opcode::GT; break;
+            case BinaryOp::Less:    op = Opcode::LT; break;
+            default:
+                error() << "Unknown binary operator\n";
+                return;
         }
+
+        genExpression(bin->left);
+        emitOperator(op, bin->right);
+    }
+}
+
+// =====================================================================================
+// Function: emitOperator
+// Purpose:
+//   - With the left operand in AX, computes the right one and applies `op`,
+//     using the sequences brosuper found (codegen_templates.h).
+//   - A constant right operand needs no stack traffic; a computed one is
+//     evaluated with the left operand saved on the stack.
+// =====================================================================================
+void Codegen::emitOperator(Opcode op, const ExprPtr& right) {
+    auto num = std::dynamic_pointer_cast<NumberExpr>(right);
+    uint16_t constant = num ? static_cast<uint16_t>(num->value) : 0;
+    if (!num) {
+        emitPush(0);
+        genExpression(right);
+    }
+
+    const LoweringTemplate* lowering = findTemplate(num ? CONSTANT_TEMPLATES : STACK_TEMPLATES, op);
+    if (!lowering) {
+        // Operator missing from the table (regenerate it): the plain sequence
+        if (num) {
+            emit({Opcode::MOV_BX, constant});
+        } else {
+            emitPush(0);
+            emitPop(1);  // Right operand → BX
+            emitPop(0);  // Left operand  → AX
+        }
+        emit({op});
+        return;
+    }
+
+    for (int k = 0; k < lowering->length; ++k) {
+        const TemplateStep& step = lowering->steps[k];
+        uint16_t a1 = step.constant ? constant : step.a1;
+        if (step.op == Opcode::PUSH) emitPush(a1);
+        else if (step.op == Opcode::POP) emitPop(a1);
+        else emit({step.op, a1});
     }
 }
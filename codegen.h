@@ -16,8 +16,11 @@
 
 #include "ast.h"           // Abstract Syntax Tree structures
 #include "RohitVM.hpp"     // Includes Instruction and Opcode definitions
+#include "profile.h"       // Branch counts for --profile-use
+#include <iostream>
 #include <vector>
 #include <map>
+#include <set>
 #include <string>
 
 // =====================================================================================
@@ -28,19 +31,62 @@
 // =====================================================================================
 class Codegen {
 public:
+    // profile: optional branch counts; hot paths are laid out as fallthrough
+    // uncheckedOps: emit DIV_NC where range analysis proved the divisor
+    //               non-zero, PUSH_NC/POP_NC (stack depth is known here), and
+    //               no CHK before array accesses it proved in bounds
+    explicit Codegen(const Profile* profile = nullptr, bool uncheckedOps = false);
+
     // Main entry point: Generates VM instructions from a full program
     std::vector<Instruction> generate(const Program& program);
 
+    // Statement::id each instruction of the last generate() came from (-1 = none)
+    const std::vector<int>& getSourceMap() const { return sourceMap; }
+
+    // Read-only data of the last generate() (string literals, each stored once),
+    // to be loaded at getDataAddress() with VM::loadData
+    const std::vector<uint8_t>& getData() const { return stringData; }
+    uint16_t getDataAddress() const { return static_cast<uint16_t>(Memory::DATA_BASE - stringData.size()); }
+
+    // Memory slots of the last generate(): variables, and arrays (element 0) with
+    // their sizes in words; an object file (broobj.h) records which is which
+    const std::map<std::string, uint16_t>& getVariables() const { return symbolTable; }
+    const std::map<std::string, uint16_t>& getArrays() const { return arrayTable; }
+    const std::map<std::string, int>& getArraySizes() const { return arraySizes; }
+
+    // Error messages go to `out` instead of std::cerr (set before generate)
+    void setDiagnostics(std::ostream& out) { diagnostics = &out; }
+
+    // Errors reported by the last generate(); its code is only usable if this is 0
+    int getErrorCount() const { return errorCount; }
+
 private:
+    std::ostream* diagnostics = &std::cerr;
+    int errorCount = 0;
+
+    // Counts an error and returns the stream to describe it on
+    std::ostream& error();
+
     // Emits a single instruction into the instruction buffer
     void emit(const Instruction& instr);
 
     // Processes individual high-level statements (let, print, if, while)
     void genStatement(const StmtPtr& stmt);
 
+    // Profile-guided layouts (used only when the profile says they pay off)
+    void genIfWithColdBranch(const IfStatement& ifs, bool thenIsCold);
+    void genRotatedWhile(const WhileStatement& wh);
+
     // Processes high-level expressions (arithmetic, comparison, variables, constants)
     void genExpression(const ExprPtr& expr);
 
+    // Jumps to `labelId` when `cond` is true (jumpIfTrue) or false, else falls through.
+    // && and || become chains of jumps that skip the right operand when they can.
+    void genBranch(const ExprPtr& cond, bool jumpIfTrue, int labelId);
+
+    // AX = AX `op` right, where `op` is a VM opcode taking BX as its second operand
+    void emitOperator(Opcode op, const ExprPtr& right);
+
     // ================= Label + Control Flow Utilities =================
 
     // Creates a new unique label ID
@@ -55,13 +101,55 @@ private:
     // Fills in the correct jump targets after code generation is done
     void patchJumps();
 
+    // Memory slot of a variable, assigned on first use
+    uint16_t addressOf(const std::string& name);
+
+    // First element of an array, assigned on first use (after the variables so far)
+    uint16_t arrayAddress(const std::string& name, int size);
+
+    // Offset of `text` in the data section, added on first use
+    uint16_t internString(const std::string& text);
+
+    // Points each PRS at its string, now that the data section's address is known
+    void patchStrings();
+
+    // CHK size, unless range analysis proved the index in bounds
+    void emitBoundsCheck(int size, bool inBounds);
+
+    // Emits PUSH/POP of register `reg`, tracking the stack depth
+    void emitPush(uint16_t reg);
+    void emitPop(uint16_t reg);
+
     // ================= Internal State =================
 
     std::vector<Instruction> instructions;              // Final output instruction list
-    std::map<std::string, uint16_t> symbolTable;        // Tracks variables to registers
+    std::map<std::string, uint16_t> symbolTable;        // Tracks variables to memory addresses
+    std::map<std::string, uint16_t> arrayTable;         // Array → address of element 0
+    std::map<std::string, int> arraySizes;              // Array → number of elements
+    std::set<std::string> declared;                     // Variables whose letbro came earlier in the source
     std::map<int, size_t> labelTargets;                 // Label ID → instruction index
     std::vector<std::pair<size_t, int>> labelPlaceholders; // Unresolved jumps
+    std::vector<int> sourceMap;                         // Statement id per instruction
+    std::vector<uint8_t> stringData;                    // Data section, ends at DATA_BASE
+    std::map<std::string, uint16_t> stringOffsets;      // Literal → offset in stringData
+    std::vector<std::pair<size_t, uint16_t>> stringPlaceholders; // PRS index → offset
+
+    // Cold ifbro branches, generated after HLT and jumping back when done
+    struct ColdBlock {
+        int label;                            // Start of the block
+        int returnLabel;                      // Where execution continues afterwards
+        int statementId;                      // Owner of the jump back
+        const std::vector<StmtPtr>* stmts;
+        std::set<std::string> declared;       // Variables visible where the block appears in the source
+    };
+    std::vector<ColdBlock> coldBlocks;
+
+    const Profile* profile;
+    bool uncheckedOps;
+    int currentStatement = -1;                // Id recorded for emitted instructions
+    int stackDepth = 0;                       // Words pushed by the expression being generated
+    int shortCircuitDepth = 0;                // > 0 while generating the operands of && / ||
 
-    int nextRegister = 1;   // Used to allocate registers to new variables
+    uint16_t nextAddress = Memory::DATA_BASE;  // Next free variable slot
     int labelCounter = 0;   // Used to create unique label IDs
 };
@@ -0,0 +1,76 @@
+// =====================================================================================
+// Generated by brosuper (brosuper.cpp) - do not edit by hand.
+//   g++ brosuper.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp -o brosuper
+//   ./brosuper -o codegen_templates.h
+//
+// File: codegen_templates.h
+// Purpose:
+//   - Shortest instruction sequences found for each operator lowering in
+//     Codegen. A step with `constant` set takes the constant operand as a1;
+//     Codegen turns PUSH/POP steps into its own (depth-tracked) stack code.
+// =====================================================================================
+
+#pragma once
+
+#include "RohitVM.hpp"
+#include <cstdint>
+
+struct TemplateStep {
+    Opcode op;
+    uint16_t a1;
+    bool constant;
+};
+
+struct LoweringTemplate {
+    Opcode op;             // Operator this sequence computes
+    uint8_t length;
+    TemplateStep steps[4];
+};
+
+// Left operand on the stack, right operand in AX: AX = left op right
+inline constexpr LoweringTemplate STACK_TEMPLATES[] = {
+    // POP 1; ADD (hand-written: 4 instructions)
+    {Opcode::ADD, 2, {{Opcode::POP, 1, false}, {Opcode::ADD, 0, false}}},
+    // PUSH 0; POP 1; POP 0; SUB
+    {Opcode::SUB, 4, {{Opcode::PUSH, 0, false}, {Opcode::POP, 1, false}, {Opcode::POP, 0, false}, {Opcode::SUB, 0, false}}},
+    // POP 1; MUL (hand-written: 4 instructions)
+    {Opcode::MUL, 2, {{Opcode::POP, 1, false}, {Opcode::MUL, 0, false}}},
+    // PUSH 0; POP 1; POP 0; DIV
+    {Opcode::DIV, 4, {{Opcode::PUSH, 0, false}, {Opcode::POP, 1, false}, {Opcode::POP, 0, false}, {Opcode::DIV, 0, false}}},
+    // PUSH 0; POP 1; POP 0; DIV_NC
+    {Opcode::DIV_NC, 4, {{Opcode::PUSH, 0, false}, {Opcode::POP, 1, false}, {Opcode::POP, 0, false}, {Opcode::DIV_NC, 0, false}}},
+    // POP 1; EQ (hand-written: 4 instructions)
+    {Opcode::EQ, 2, {{Opcode::POP, 1, false}, {Opcode::EQ, 0, false}}},
+    // POP 1; LT (hand-written: 4 instructions)
+    {Opcode::GT, 2, {{Opcode::POP, 1, false}, {Opcode::LT, 0, false}}},
+    // POP 1; GT (hand-written: 4 instructions)
+    {Opcode::LT, 2, {{Opcode::POP, 1, false}, {Opcode::GT, 0, false}}},
+    // POP 1; MIN (hand-written: 4 instructions)
+    {Opcode::MIN, 2, {{Opcode::POP, 1, false}, {Opcode::MIN, 0, false}}},
+    // POP 1; MAX (hand-written: 4 instructions)
+    {Opcode::MAX, 2, {{Opcode::POP, 1, false}, {Opcode::MAX, 0, false}}},
+};
+
+// Left operand in AX, right operand the constant K: AX = left op K
+inline constexpr LoweringTemplate CONSTANT_TEMPLATES[] = {
+    // MOV_BX K; ADD
+    {Opcode::ADD, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::ADD, 0, false}}},
+    // MOV_BX K; SUB
+    {Opcode::SUB, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::SUB, 0, false}}},
+    // MOV_BX K; MUL
+    {Opcode::MUL, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::MUL, 0, false}}},
+    // MOV_BX K; DIV
+    {Opcode::DIV, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::DIV, 0, false}}},
+    // MOV_BX K; DIV_NC
+    {Opcode::DIV_NC, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::DIV_NC, 0, false}}},
+    // MOV_BX K; EQ
+    {Opcode::EQ, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::EQ, 0, false}}},
+    // MOV_BX K; GT
+    {Opcode::GT, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::GT, 0, false}}},
+    // MOV_BX K; LT
+    {Opcode::LT, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::LT, 0, false}}},
+    // MOV_BX K; MIN
+    {Opcode::MIN, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::MIN, 0, false}}},
+    // MOV_BX K; MAX
+    {Opcode::MAX, 2, {{Opcode::MOV_BX, 0, true}, {Opcode::MAX, 0, false}}},
+};
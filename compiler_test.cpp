@@ -13,10 +13,14 @@
 //   - Executes and displays the result.
 //
 // Usage Instructions:
-//   g++ broc.cpp lexer.cpp parser.cpp ast.cpp codegen.cpp emitter.cpp -o broc
+//   g++ broc.cpp lexer.cpp parser.cpp astutils.cpp licm.cpp strength.cpp cse.cpp unroll.cpp evaluator.cpp jumpthread.cpp cfg.cpp blocklayout.cpp range.cpp boundscheck.cpp optimizer.cpp profile.cpp codegen.cpp emitter.cpp brobin.cpp broobj.cpp x86backend.cpp -o broc
 //   ./broc test.bro -o prog.cpp
-//   g++ compiler_test.cpp RohitVM.cpp RohitUtils.cpp -o run_bro
-//   ./run_bro
+//   g++ compiler_test.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp -o run_bro
+//   ./run_bro [--profile=prog.profile]
+//
+//   Or, with no rebuild per program (see brobin.h):
+//   ./broc test.bro -o prog.brobin
+//   ./run_bro prog.brobin [--profile=prog.profile]
 // =======================================================================================
 
 #include "RohitVM.hpp"
@@ -26,7 +30,8 @@
 // ---------------------------------------------------------------------------------------
 // NOTE:
 //   - The file `prog.cpp` is generated by your compiler (broc).
-//   - It contains: std::vector<Instruction> prog;
+//   - It contains constexpr std::arrays in read-only data: prog (the instructions),
+//     progSourceMap, and the string data progData loaded at progDataAddress.
 //   - This is the bytecode that will be executed.
 // ---------------------------------------------------------------------------------------
 #include "prog.cpp"
@@ -34,15 +39,18 @@
 // =======================================================================================
 // Function: runProgram
 // Description:
-//   - Loads the given instruction list into the VM
+//   - Loads the given instruction list (or the image at `imagePath`) into the VM
 //   - Executes the VM and returns formatted output as a string
 // Parameters:
-//   - prog: vector of compiled instructions (bytecode)
+//   - prog, count: the compiled instructions (bytecode)
 //   - title: a label to print during execution for clarity
+//   - profilePath: if not empty, execution counts are written there (see profile.h)
+//   - imagePath: if not empty, a .brobin image run instead of `prog`
 // Returns:
 //   - A formatted string representing the VM output for the given program
 // =======================================================================================
-std::string runProgram(const std::vector<Instruction>& prog, const std::string& title) {
+std::string runProgram(const Instruction* prog, size_t count, const std::string& title,
+                       const std::string& profilePath = "", const std::string& imagePath = "") {
     VM vm;
     std::ostringstream out;
 
@@ -50,9 +58,21 @@ std::string runProgram(const std::vector<Instruction>& prog, const std::string&
     out << "Running Compiled Program: " << title << "\n";
     out << "===============================\n";
 
-    vm.loadProgram(prog);
+    vm.profiling = !profilePath.empty();
+    if (imagePath.empty()) {
+        vm.loadProgram(prog, count);
+        vm.loadData(progDataAddress, progData);
+    } else if (!vm.loadImage(imagePath)) {
+        std::exit(EXIT_FAILURE);
+    }
     vm.execute();
 
+    std::vector<int> sourceMap = imagePath.empty() ? std::vector<int>(progSourceMap.begin(), progSourceMap.end())
+                                                   : vm.getSourceMap();
+    if (vm.profiling && vm.writeProfile(profilePath, sourceMap)) {
+        out << "Profile written to " << profilePath << "\n";
+    }
+
     return out.str();
 }
 
@@ -61,8 +81,18 @@ std::string runProgram(const std::vector<Instruction>& prog, const std::string&
 // Purpose:
 //   - Entry point for running compiled Brolang programs on the custom VM.
 //   - Automatically loads `prog.cpp` and runs it.
+//   - `--profile=<file>` also records a profile for `broc --profile-use=<file>`.
+//   - Any other argument names a .brobin image to run instead.
 // =======================================================================================
-int main() {
-    std::cout << runProgram(prog, "test.bro") << "\n";
+int main(int argc, char* argv[]) {
+    std::string profilePath, imagePath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--profile=", 0) == 0) profilePath = arg.substr(10);
+        else imagePath = arg;
+    }
+
+    std::string title = imagePath.empty() ? "test.bro" : imagePath;
+    std::cout << runProgram(prog.data(), prog.size(), title, profilePath, imagePath) << "\n";
     return 0;
 }
@@ -0,0 +1,237 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: cse.cpp
+// Purpose:
+//   - Implements Common Subexpression Elimination by scoped value numbering.
+//
+// Rules that keep the rewrite sound:
+//   - `letbro x = ...` gives x a new version, so expressions reading the old x
+//     never match expressions reading the new one.
+//   - Variables assigned inside an ifbro branch get a new version after the
+//     ifbro; variables assigned inside a whilebro get a new version both on
+//     loop entry (the body may see values from the previous iteration) and on
+//     loop exit.
+//   - A whilebro condition may reuse earlier values but never defines one: it is
+//     re-evaluated every iteration and has no statement slot to hold a temporary.
+//   - Likewise for the right operand of && and ||, which may not run at all.
+//   - Array reads never match anything (element values are not tracked), so
+//     no expression containing one is ever reused; their indexes still are.
+//   - In a statement that accesses an array, an expression that may trap gets
+//     no temporary: computing it ahead of the statement could report a
+//     division by zero where the VM would have stopped at a bad index first.
+// =====================================================================================
+
+#include "cse.h"
+#include "astutils.h"
+#include <cstdint>
+#include <set>
+
+namespace {
+    // Extra instructions a temporary costs: STORE at the definition, and the
+    // definition itself becomes a LOAD
+    constexpr int TEMP_OVERHEAD = 2;
+}
+
+// =====================================================================================
+// Function: run
+// Purpose: Numbers the whole program, then rewrites reuses.
+// =====================================================================================
+void CommonSubexpressions::run(Program& program) {
+    version.clear();
+    nextVersion = 0;
+    scopes.assign(1, Scope{});
+    definitions.clear();
+    pending.clear();
+    tempCounter = 0;
+
+    numberBlock(program.statements);
+
+    for (auto& def : definitions) {
+        for (auto& [slot, holder] : def->holderReuses)
+            *slot = std::make_shared<VariableExpr>(holder);
+
+        if (def->tempReuses.empty()) continue;
+
+        int saved = static_cast<int>(def->tempReuses.size()) * (AstUtils::estimateCost(*def->slot) - 1);
+        if (saved <= TEMP_OVERHEAD) continue;
+
+        std::string name = "__cse" + std::to_string(tempCounter++);
+        pending[def->anchor].push_back(std::make_shared<LetStatement>(name, *def->slot));
+        *def->slot = std::make_shared<VariableExpr>(name);
+        for (ExprPtr* slot : def->tempReuses)
+            *slot = std::make_shared<VariableExpr>(name);
+    }
+
+    insertTemporaries(program.statements);
+}
+
+// =====================================================================================
+// Phase 1: Value Numbering
+// =====================================================================================
+
+// Numbers each statement of a block in execution order
+void CommonSubexpressions::numberBlock(std::vector<StmtPtr>& block) {
+    for (auto& stmt : block) {
+        if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+            anchorAccessesArray = AstUtils::readsArray(let->value);
+            std::string key = numberExpr(let->value, stmt.get(), true);
+            assign(let->name);
+
+            // x now holds this value until it is reassigned
+            if (auto def = lookup(key); def && !def->holderValid) {
+                def->holder = let->name;
+                def->holderValid = true;
+            }
+        }
+        else if (auto print = std::dynamic_pointer_cast<PrintStatement>(stmt)) {
+            anchorAccessesArray = AstUtils::readsArray(print->expr);
+            numberExpr(print->expr, stmt.get(), true);
+        }
+        else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt)) {
+            anchorAccessesArray = true;
+            numberExpr(store->value, stmt.get(), true);
+            numberExpr(store->index, stmt.get(), true);
+        }
+        else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+            anchorAccessesArray = AstUtils::readsArray(ifs->condition);
+            numberExpr(ifs->condition, stmt.get(), true);
+
+            std::set<std::string> thenAssigned, elseAssigned;
+            AstUtils::collectAssigned(ifs->thenBranch, thenAssigned);
+            AstUtils::collectAssigned(ifs->elseBranch, elseAssigned);
+
+            auto before = version;
+            scopes.emplace_back();
+            numberBlock(ifs->thenBranch);
+            scopes.pop_back();
+
+            // The else path never ran the then-branch's assignments
+            version = before;
+            for (const auto& name : thenAssigned) invalidateHolders(name);
+
+            scopes.emplace_back();
+            numberBlock(ifs->elseBranch);
+            scopes.pop_back();
+
+            // Anything assigned on either path holds an unknown value afterwards
+            for (const auto& name : thenAssigned) assign(name);
+            for (const auto& name : elseAssigned) assign(name);
+        }
+        else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+            std::set<std::string> assigned;
+            AstUtils::collectAssigned(wh->body, assigned);
+            for (const auto& name : assigned) assign(name);
+
+            numberExpr(wh->condition, stmt.get(), false);
+
+            scopes.emplace_back();
+            numberBlock(wh->body);
+            scopes.pop_back();
+
+            for (const auto& name : assigned) assign(name);
+        }
+    }
+}
+
+// Records `slot` as a reuse of an available value, or (if allowed) as a new
+// definition after numbering its operands. Returns the value-number key.
+std::string CommonSubexpressions::numberExpr(ExprPtr& slot, Statement* anchor, bool mayDefine) {
+    auto bin = std::dynamic_pointer_cast<BinaryExpr>(slot);
+    auto call = std::dynamic_pointer_cast<CallExpr>(slot);
+    if (auto idx = std::dynamic_pointer_cast<IndexExpr>(slot)) {
+        numberExpr(idx->index, anchor, mayDefine);
+        return keyOf(slot);
+    }
+    if (!bin && !call) return keyOf(slot);
+
+    std::string key = keyOf(slot);
+    if (auto def = lookup(key)) {
+        if (def->holderValid) def->holderReuses.push_back({&slot, def->holder});
+        else                  def->tempReuses.push_back(&slot);
+        return key;
+    }
+
+    if (bin) {
+        numberExpr(bin->left, anchor, mayDefine);
+
+        // The right operand of && / || may be skipped: it can reuse values, but a
+        // temporary for it would be computed even when the operator short-circuits
+        bool shortCircuit = bin->op == BinaryOp::And || bin->op == BinaryOp::Or;
+        numberExpr(bin->right, anchor, mayDefine && !shortCircuit);
+    } else {
+        for (auto& arg : call->args) numberExpr(arg, anchor, mayDefine);
+    }
+
+    if (mayDefine && !(anchorAccessesArray && AstUtils::mayTrap(slot))) {
+        auto def = std::make_shared<Definition>();
+        def->slot = &slot;
+        def->anchor = anchor;
+        scopes.back()[key] = def;
+        definitions.push_back(def);
+    }
+    return key;
+}
+
+// Value-number key: like AstUtils::exprKey, but variables carry their version
+std::string CommonSubexpressions::keyOf(const ExprPtr& expr) {
+    if (auto num = std::dynamic_pointer_cast<NumberExpr>(expr))
+        return std::to_string(static_cast<uint16_t>(num->value));
+    if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr))
+        return var->name + "@" + std::to_string(version[var->name]);
+    if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr))
+        return "(" + binaryOpToString(bin->op) + " " + keyOf(bin->left) + " " + keyOf(bin->right) + ")";
+    if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+        std::string key = "(" + intrinsicName(call->fn);
+        for (const auto& arg : call->args) key += " " + keyOf(arg);
+        return key + ")";
+    }
+    if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr))
+        return "(" + idx->array + "[]#" + std::to_string(reinterpret_cast<uintptr_t>(idx.get())) + ")";  // This read only
+    return "?";
+}
+
+// Finds an available value, innermost scope first
+std::shared_ptr<CommonSubexpressions::Definition> CommonSubexpressions::lookup(const std::string& key) {
+    for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
+        auto found = it->find(key);
+        if (found != it->end()) return found->second;
+    }
+    return nullptr;
+}
+
+// A `letbro name = ...` happened: new version, and `name` stops holding old values
+void CommonSubexpressions::assign(const std::string& name) {
+    version[name] = ++nextVersion;
+    invalidateHolders(name);
+}
+
+// `name` may no longer hold the value it was last known to hold
+void CommonSubexpressions::invalidateHolders(const std::string& name) {
+    for (auto& scope : scopes)
+        for (auto& [key, def] : scope)
+            if (def->holder == name) def->holderValid = false;
+}
+
+// =====================================================================================
+// Phase 2: Insert temporaries in front of the statements that first compute them
+// =====================================================================================
+void CommonSubexpressions::insertTemporaries(std::vector<StmtPtr>& block) {
+    std::vector<StmtPtr> out;
+
+    for (auto& stmt : block) {
+        if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+            insertTemporaries(ifs->thenBranch);
+            insertTemporaries(ifs->elseBranch);
+        } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+            insertTemporaries(wh->body);
+        }
+
+        auto it = pending.find(stmt.get());
+        if (it != pending.end()) out.insert(out.end(), it->second.begin(), it->second.end());
+        out.push_back(stmt);
+    }
+
+    block = std::move(out);
+}
@@ -0,0 +1,81 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: cse.h
+// Purpose:
+//   - Declares the Common Subexpression Elimination (CSE) pass.
+//   - Uses value numbering: every variable carries a version that changes on each
+//     `letbro`, and an expression's number is built from its operator and the
+//     numbers of its operands. Two expressions with the same number compute the
+//     same value, so the second one can reuse the first.
+//
+// Example:
+//   printbro((a + b) * (a + b));   ==>   letbro __cse0 = a + b;
+//                                        printbro(__cse0 * __cse0);
+//
+//   letbro x = a + b;              ==>   letbro x = a + b;
+//   printbro(a + b);                     printbro(x);
+//   letbro a = 1;                        letbro a = 1;
+//   printbro(a + b);                     printbro(a + b);    // a changed
+//
+// Scope:
+//   - There is no CFG, so numbering follows the structure of the AST, which for
+//     BroLang is exactly the dominator tree: a statement dominates everything
+//     after it in its block, including nested blocks. Values computed inside an
+//     ifbro branch or whilebro body are forgotten when that block ends.
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// =====================================================================================
+// Class: CommonSubexpressions
+// Purpose:
+//   - Phase 1 numbers every expression and records which occurrences reuse an
+//     earlier one.
+//   - Phase 2 rewrites reuses to read either the variable the value was first
+//     assigned to, or a new `__cseN` temporary defined right before the
+//     statement that first computed it.
+// =====================================================================================
+class CommonSubexpressions {
+public:
+    // Rewrites `program` in place
+    void run(Program& program);
+
+private:
+    // First occurrence of a value and everything that can reuse it
+    struct Definition {
+        ExprPtr* slot;                        // Where the value is first computed
+        Statement* anchor;                    // Statement containing that slot
+        std::string holder;                   // Variable assigned exactly this value ("" if none)
+        bool holderValid = false;             // False once `holder` is reassigned
+        std::vector<std::pair<ExprPtr*, std::string>> holderReuses;  // Occurrences that read a holder
+        std::vector<ExprPtr*> tempReuses;     // Occurrences that need a temporary
+    };
+    using Scope = std::map<std::string, std::shared_ptr<Definition>>;
+
+    // Phase 1: value numbering
+    void numberBlock(std::vector<StmtPtr>& block);
+    std::string numberExpr(ExprPtr& slot, Statement* anchor, bool mayDefine);
+    std::string keyOf(const ExprPtr& expr);
+    std::shared_ptr<Definition> lookup(const std::string& key);
+    void assign(const std::string& name);
+    void invalidateHolders(const std::string& name);
+
+    // Phase 2: rewriting
+    void insertTemporaries(std::vector<StmtPtr>& block);
+
+    std::map<std::string, int> version;                 // Current version of each variable
+    int nextVersion = 0;
+    std::vector<Scope> scopes;                          // Available values, innermost last
+    std::vector<std::shared_ptr<Definition>> definitions;  // In the order they were computed
+    std::map<Statement*, std::vector<StmtPtr>> pending; // Temporaries to insert before a statement
+    int tempCounter = 0;
+    bool anchorAccessesArray = false;                   // Statement being numbered reads or writes an array
+};
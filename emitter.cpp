@@ -13,6 +13,7 @@
 // =======================================================================================
 
 #include "emitter.h"
+#include "brobin.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -21,77 +22,93 @@
 // Function: writeToFile
 // Description:
 //   - Takes a list of compiled Instructions and writes them to a `.cpp` file.
-//   - The emitted file includes: `#include "RohitVM.hpp"` and a global vector `prog`
+//   - The emitted file includes: `#include "RohitVM.hpp"`, the program `prog`,
+//     its source map `progSourceMap` and the data section `progData` / `progDataAddress`
+//   - All of them are constexpr std::arrays, so the compiler places them in .rodata:
+//     nothing is allocated or copied before main, unlike a global std::vector
 // Parameters:
 //   - filename: output file path (usually "prog.cpp")
 //   - instructions: compiled bytecode to emit
+//   - sourceMap: statement id per instruction (may be empty)
+//   - dataAddress, data: read-only data (string literals) and where it is loaded
 // Returns:
 //   - true if successfully written, false otherwise
 // =======================================================================================
-bool Emitter::writeToFile(const std::string& filename, const std::vector<Instruction>& instructions) {
+bool Emitter::writeToFile(const std::string& filename, const std::vector<Instruction>& instructions,
+                          const std::vector<int>& sourceMap, uint16_t dataAddress,
+                          const std::vector<uint8_t>& data) {
+    // --- Refuse a byte that is not an opcode rather than write something else ---
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        if (!opcodeName(instructions[i].op)) {
+            std::cerr << "Unknown opcode " << static_cast<int>(instructions[i].op)
+                      << " at instruction " << i << "\n";
+            return false;
+        }
+    }
+
     std::ofstream out(filename);
     if (!out.is_open()) {
         std::cerr << "Failed to open output file: " << filename << "\n";
         return false;
     }
 
-    // --- Emit header and global vector declaration ---
+    // --- Emit header and the program array ---
     out << "#include \"RohitVM.hpp\"\n";
-    out << "std::vector<Instruction> prog = {\n";
+    out << "constexpr std::array<Instruction, " << instructions.size() << "> prog = {{\n";
 
-    // --- Emit each instruction ---
+    // --- Emit each instruction, with the operands its size says it has ---
     for (const auto& instr : instructions) {
-        out << "    {Opcode::";
-
-        // Convert Opcode enum to string manually
-        switch (instr.op) {
-            case Opcode::NOP:     out << "NOP"; break;
-            case Opcode::HLT:     out << "HLT"; break;
-            case Opcode::MOV:     out << "MOV"; break;
-            case Opcode::MOV_BX:  out << "MOV_BX"; break;
-            case Opcode::MOV_CX:  out << "MOV_CX"; break;
-            case Opcode::MOV_DX:  out << "MOV_DX"; break;
-            case Opcode::MOV_SP:  out << "MOV_SP"; break;
-            case Opcode::ADD:     out << "ADD"; break;
-            case Opcode::SUB:     out << "SUB"; break;
-            case Opcode::MUL:     out << "MUL"; break;
-            case Opcode::DIV:     out << "DIV"; break;
-            case Opcode::PUSH:    out << "PUSH"; break;
-            case Opcode::POP:     out << "POP"; break;
-            case Opcode::STE:     out << "STE"; break;
-            case Opcode::CLE:     out << "CLE"; break;
-            case Opcode::STG:     out << "STG"; break;
-            case Opcode::CLG:     out << "CLG"; break;
-            case Opcode::STH:     out << "STH"; break;
-            case Opcode::CLH:     out << "CLH"; break;
-            case Opcode::STL:     out << "STL"; break;
-            case Opcode::CLL:     out << "CLL"; break;
-            case Opcode::PRN:     out << "PRN"; break;
-            default:              out << "NOP"; break; // fallback to prevent failure
-        }
+        out << "    {Opcode::" << opcodeName(instr.op);
+        uint8_t size = instructionSize(instr.op);
+        if (size >= 3) out << ", " << instr.a1;
+        if (size == 5) out << ", " << instr.a2;
+        out << "},\n";
+    }
 
-        // Emit operand if the instruction expects one (e.g. MOV, PUSH)
-        switch (instr.op) {
-            case Opcode::MOV:
-            case Opcode::MOV_BX:
-            case Opcode::MOV_CX:
-            case Opcode::MOV_DX:
-            case Opcode::MOV_SP:
-            case Opcode::PUSH:
-            case Opcode::POP:
-                out << ", " << instr.a1;
-                break;
-            default:
-                break;
-        }
+    // --- Close the array ---
+    out << "}};\n";
 
-        out << "},\n";
+    // --- Source map: statement id of each instruction, 16 per line ---
+    out << "constexpr std::array<int, " << sourceMap.size() << "> progSourceMap = {{";
+    for (size_t i = 0; i < sourceMap.size(); ++i) {
+        out << (i % 16 == 0 ? "\n    " : " ") << sourceMap[i] << ",";
     }
+    out << "\n}};\n";
 
-    // --- Close the vector ---
-    out << "};\n";
+    // --- Data section: bytes, 16 per line ---
+    out << "constexpr uint16_t progDataAddress = " << dataAddress << ";\n";
+    out << "constexpr std::array<uint8_t, " << data.size() << "> progData = {{";
+    for (size_t i = 0; i < data.size(); ++i) {
+        out << (i % 16 == 0 ? "\n    " : " ") << static_cast<int>(data[i]) << ",";
+    }
+    out << "\n}};\n";
     out.close();
 
     std::cout << "Wrote program to " << filename << "\n";
     return true;
 }
+
+// =======================================================================================
+// Function: writeImage
+// Description:
+//   - Encodes the instructions as VM::loadProgram would and writes them, with the
+//     data section and the source map, as a `.brobin` image.
+// =======================================================================================
+bool Emitter::writeImage(const std::string& filename, const std::vector<Instruction>& instructions,
+                         const std::vector<int>& sourceMap, uint16_t dataAddress,
+                         const std::vector<uint8_t>& data, bool unchecked) {
+    BroBin::Image image;
+    if (!BroBin::encode(instructions, image.code)) {
+        std::cerr << "Program too large or jump target out of range\n";
+        return false;
+    }
+    image.instructionCount = static_cast<uint32_t>(instructions.size());
+    image.dataAddress = dataAddress;
+    image.data = data;
+    if (sourceMap.size() == instructions.size()) image.sourceMap = sourceMap;
+    image.unchecked = unchecked;
+
+    if (!BroBin::write(filename, image)) return false;
+    std::cout << "Wrote image to " << filename << "\n";
+    return true;
+}
@@ -19,10 +19,12 @@
 // =======================================================================================
 // Class: Emitter
 // Role:
-//   - Static utility class with a single job: write a list of Instructions to a .cpp file.
+//   - Static utility class with a single job: write a list of Instructions to a .cpp
+//     file, or to a binary image.
 //
 // Usage:
-//   Emitter::writeToFile("prog.cpp", instructions);
+//   Emitter::writeToFile("prog.cpp", instructions, sourceMap, dataAddress, data);
+//   Emitter::writeImage("prog.brobin", instructions, sourceMap, dataAddress, data);
 // =======================================================================================
 class Emitter {
 public:
@@ -30,12 +32,33 @@ public:
     // Function: writeToFile
     // Description:
     //   - Serializes the list of compiled Instructions into a C++ source file
-    //   - Each instruction is emitted in a readable, compilable format
+    //   - Each instruction is emitted in a readable, compilable format, as an element
+    //     of `constexpr std::array<Instruction, N> prog` (read-only data, no startup cost)
     // Parameters:
     //   - filename: destination C++ file path (e.g., "prog.cpp")
     //   - instructions: list of VM bytecode instructions to emit
+    //   - sourceMap: statement id per instruction (see Codegen::getSourceMap), written
+    //     as `progSourceMap` so the VM can attribute its profile to source statements
+    //   - dataAddress, data: the read-only data section (see Codegen::getData), written
+    //     as `progDataAddress` and `progData` for VM::loadData
     // Returns:
     //   - true on success, false on file open failure
     // -----------------------------------------------------------------------------------
-    static bool writeToFile(const std::string& filename, const std::vector<Instruction>& instructions);
+    static bool writeToFile(const std::string& filename, const std::vector<Instruction>& instructions,
+                            const std::vector<int>& sourceMap = {}, uint16_t dataAddress = Memory::DATA_BASE,
+                            const std::vector<uint8_t>& data = {});
+
+    // -----------------------------------------------------------------------------------
+    // Function: writeImage
+    // Description:
+    //   - Same program as a binary `.brobin` image (see brobin.h), which VM::loadImage
+    //     runs without compiling any C++
+    //   - `unchecked` marks compiler output, whose DIV_NC / PUSH_NC / POP_NC were
+    //     proven safe; loading refuses those opcodes in an image without the mark
+    // Returns:
+    //   - true on success, false if a jump target is out of range or the file can't be written
+    // -----------------------------------------------------------------------------------
+    static bool writeImage(const std::string& filename, const std::vector<Instruction>& instructions,
+                           const std::vector<int>& sourceMap, uint16_t dataAddress,
+                           const std::vector<uint8_t>& data, bool unchecked = false);
 };
@@ -0,0 +1,283 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: evaluator.cpp
+// Purpose:
+//   - Implements the partial evaluator described in evaluator.h.
+//
+// Why the rollback points are exact:
+//   - Between two top-level statements, and between two iterations of a
+//     top-level whilebro, the whole machine state that matters is the set of
+//     variable values. Re-creating those values with `letbro` and continuing
+//     with the remaining code (the loop itself re-checks its condition) resumes
+//     the program exactly where the evaluator stopped. Arrays are part of
+//     that state too: their non-zero elements are restored the same way.
+// =====================================================================================
+
+#include "evaluator.h"
+#include "astutils.h"
+#include <algorithm>
+#include <set>
+
+namespace {
+
+    // Same bound the unroller uses to turn instruction estimates into bytes
+    constexpr int BYTES_PER_INSTRUCTION = 3;
+
+    // Same results as the VM's MIN/MAX/ABS/CLAMP/SGN instructions
+    uint16_t applyIntrinsic(Intrinsic fn, uint16_t a, uint16_t b, uint16_t c) {
+        bool negative = a & 0x8000;
+        switch (fn) {
+            case Intrinsic::Min:   return std::min(a, b);
+            case Intrinsic::Max:   return std::max(a, b);
+            case Intrinsic::Abs:   return negative ? static_cast<uint16_t>(-a) : a;
+            case Intrinsic::Clamp: return std::min(std::max(a, b), c);
+            case Intrinsic::Sign:  return negative ? 0xFFFF : (a != 0);
+            default:               return 0;
+        }
+    }
+
+} // namespace
+
+PartialEvaluator::PartialEvaluator(long fuel, int codeBudget)
+    : fuel(fuel), codeBudget(codeBudget) {}
+
+// =====================================================================================
+// Function: run
+// Purpose:
+//   - Evaluates as many top-level statements as the fuel allows, then rebuilds
+//     the program as printed constants + variable restores + the rest.
+// =====================================================================================
+void PartialEvaluator::run(Program& program) {
+    std::set<std::string> declared;
+    if (AstUtils::readsBeforeDeclared(program.statements, declared)) return;
+
+    // Each printed constant costs MOV + PRN (a string, one PRS); the rest of the program must still fit
+    long room = codeBudget - (AstUtils::estimateBlockCost(program.statements) + 1) * BYTES_PER_INSTRUCTION;
+    maxOutputs = room > 0 ? room / (2 * BYTES_PER_INSTRUCTION) : 0;
+
+    env.clear();
+    arrays.clear();
+    output.clear();
+
+    auto& stmts = program.statements;
+    size_t done = 0;  // Statements fully evaluated
+
+    while (done < stmts.size()) {
+        auto savedEnv = env;
+        auto savedArrays = arrays;
+        size_t savedOutput = output.size();
+
+        // A top-level loop can also be cut between two iterations
+        if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmts[done])) {
+            bool finished = false;
+            while (true) {
+                savedEnv = env;
+                savedArrays = arrays;
+                savedOutput = output.size();
+
+                uint16_t cond;
+                if (!spend(AstUtils::estimateCost(wh->condition) + 2) ||
+                    !eval(wh->condition, cond))
+                    break;
+                if (cond == 0) {
+                    finished = true;
+                    break;
+                }
+                if (!execBlock(wh->body)) break;
+            }
+            if (!finished) {
+                env = savedEnv;
+                arrays = savedArrays;
+                output.resize(savedOutput);
+                break;
+            }
+            ++done;
+            continue;
+        }
+
+        if (!exec(stmts[done])) {
+            env = savedEnv;
+            arrays = savedArrays;
+            output.resize(savedOutput);
+            break;
+        }
+        ++done;
+    }
+
+    // ---------------- Build the residual program ----------------
+    std::vector<StmtPtr> residual = output;
+
+    if (done < stmts.size()) {
+        // Every variable the evaluated code declared must exist for the rest
+        std::vector<StmtPtr> evaluated(stmts.begin(), stmts.begin() + done);
+        std::set<std::string> assigned;
+        AstUtils::collectAssigned(evaluated, assigned);
+        for (const auto& [name, value] : env) assigned.insert(name);
+
+        for (const auto& name : assigned)
+            residual.push_back(std::make_shared<LetStatement>(name, std::make_shared<NumberExpr>(env[name])));
+
+        // Restores cost MOV, CHK, MOV_BX, STX each; give up if they do not fit
+        long restores = 0;
+        for (const auto& [name, elements] : arrays)
+            restores += elements.size() - std::count(elements.begin(), elements.end(), 0);
+        if ((output.size() * 2 + restores * 4) * BYTES_PER_INSTRUCTION > static_cast<size_t>(std::max(room, 0L)))
+            return;
+
+        for (const auto& [name, elements] : arrays) {
+            for (size_t k = 0; k < elements.size(); ++k) {
+                if (elements[k] == 0) continue;
+                residual.push_back(std::make_shared<ArrayStoreStatement>(
+                    name, static_cast<int>(elements.size()),
+                    std::make_shared<NumberExpr>(static_cast<int>(k)),
+                    std::make_shared<NumberExpr>(elements[k])));
+            }
+        }
+        residual.insert(residual.end(), stmts.begin() + done, stmts.end());
+    }
+
+    stmts = std::move(residual);
+}
+
+// =====================================================================================
+// Interpreter
+// =====================================================================================
+
+bool PartialEvaluator::execBlock(const std::vector<StmtPtr>& block) {
+    for (const auto& stmt : block)
+        if (!exec(stmt)) return false;
+    return true;
+}
+
+bool PartialEvaluator::exec(const StmtPtr& stmt) {
+    uint16_t value;
+
+    if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+        if (!spend(AstUtils::estimateCost(let->value) + 1) || !eval(let->value, value)) return false;
+        env[let->name] = value;
+        return true;
+    }
+
+    if (auto print = std::dynamic_pointer_cast<PrintStatement>(stmt)) {
+        if (!spend(AstUtils::estimateCost(print->expr) + 1) || !eval(print->expr, value)) return false;
+        if (output.size() >= maxOutputs) return false;
+        output.push_back(std::make_shared<PrintStatement>(std::make_shared<NumberExpr>(value)));
+        return true;
+    }
+
+    if (std::dynamic_pointer_cast<PrintStringStatement>(stmt)) {
+        if (!spend(1) || output.size() >= maxOutputs) return false;
+        output.push_back(stmt);  // Nothing to compute: the statement prints itself
+        return true;
+    }
+
+    if (std::dynamic_pointer_cast<ArrayDeclStatement>(stmt))
+        return true;
+
+    // Same order as Codegen: value, index, then the bounds check
+    if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt)) {
+        uint16_t index;
+        if (!spend(AstUtils::estimateBlockCost({stmt})) || !eval(store->value, value) ||
+            !eval(store->index, index))
+            return false;
+        uint16_t* slot = element(store->array, store->size, index);
+        if (!slot) return false;
+        *slot = value;
+        return true;
+    }
+
+    if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+        if (!spend(AstUtils::estimateCost(ifs->condition) + 2) || !eval(ifs->condition, value)) return false;
+        return execBlock(value != 0 ? ifs->thenBranch : ifs->elseBranch);
+    }
+
+    if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+        while (true) {
+            if (!spend(AstUtils::estimateCost(wh->condition) + 2) || !eval(wh->condition, value)) return false;
+            if (value == 0) return true;
+            if (!execBlock(wh->body)) return false;
+        }
+    }
+
+    return false;
+}
+
+// Same results as the VM: 16-bit wrap-around, unsigned comparisons giving 0/1
+bool PartialEvaluator::eval(const ExprPtr& expr, uint16_t& value) {
+    if (auto num = std::dynamic_pointer_cast<NumberExpr>(expr)) {
+        value = static_cast<uint16_t>(num->value);
+        return true;
+    }
+
+    if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr)) {
+        auto it = env.find(var->name);
+        value = (it != env.end()) ? it->second : 0;  // Unwritten variables read as zeroed memory
+        return true;
+    }
+
+    if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr)) {
+        uint16_t index;
+        if (!eval(idx->index, index)) return false;
+        uint16_t* slot = element(idx->array, idx->size, index);
+        if (!slot) return false;  // Would trap at runtime: leave it to the VM
+        value = *slot;
+        return true;
+    }
+
+    if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+        uint16_t args[3] = {0, 0, 0};
+        if (call->args.size() != intrinsicArity(call->fn)) return false;
+        for (size_t k = 0; k < call->args.size(); ++k)
+            if (!eval(call->args[k], args[k])) return false;
+        value = applyIntrinsic(call->fn, args[0], args[1], args[2]);
+        return true;
+    }
+
+    auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr);
+    if (!bin) return false;
+
+    uint16_t lhs, rhs;
+    if (bin->op == BinaryOp::And || bin->op == BinaryOp::Or) {
+        if (!eval(bin->left, lhs)) return false;
+        if ((lhs != 0) == (bin->op == BinaryOp::Or)) {  // Decided by the left operand alone
+            value = lhs != 0;
+            return true;
+        }
+        if (!eval(bin->right, rhs)) return false;
+        value = rhs != 0;
+        return true;
+    }
+    if (!eval(bin->left, lhs) || !eval(bin->right, rhs)) return false;
+
+    switch (bin->op) {
+        case BinaryOp::Add:     value = static_cast<uint16_t>(lhs + rhs); break;
+        case BinaryOp::Sub:     value = static_cast<uint16_t>(lhs - rhs); break;
+        case BinaryOp::Mul:     value = static_cast<uint16_t>(static_cast<uint32_t>(lhs) * rhs); break;
+        case BinaryOp::Div:
+            if (rhs == 0) return false;  // Would trap at runtime: leave it to the VM
+            value = lhs / rhs;
+            break;
+        case BinaryOp::Equal:   value = lhs == rhs; break;
+        case BinaryOp::Greater: value = lhs > rhs; break;
+        case BinaryOp::Less:    value = lhs < rhs; break;
+        case BinaryOp::Shl:     value = rhs < 16 ? static_cast<uint16_t>(lhs << rhs) : 0; break;
+        case BinaryOp::Shr:     value = rhs < 16 ? static_cast<uint16_t>(lhs >> rhs) : 0; break;
+        default:                return false;
+    }
+    return true;
+}
+
+uint16_t* PartialEvaluator::element(const std::string& array, int size, uint16_t index) {
+    if (index >= size) return nullptr;
+    auto& elements = arrays[array];
+    if (elements.empty()) elements.assign(size, 0);
+    return &elements[index];
+}
+
+bool PartialEvaluator::spend(long units) {
+    if (fuel < units) return false;
+    fuel -= units;
+    return true;
+}
@@ -0,0 +1,77 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: evaluator.h
+// Purpose:
+//   - Declares the whole-program partial evaluator (`broc --partial-eval`).
+//   - BroLang programs read no input, so their output is known at compile time.
+//     The evaluator runs the AST with the VM's 16-bit semantics and replaces
+//     everything it finished with the values (and strings) it printed.
+//
+// Example:
+//   letbro a = 10;                       printbro(13);
+//   letbro b = 3;               ==>      printbro(0);
+//   printbro(a + b);                     printbro(1);
+//   letbro i = 0;                        printbro(2);
+//   whilebro (i < 3) {
+//       printbro(i);
+//       letbro i = i + 1;
+//   }
+//
+// Fuel:
+//   - Evaluation is bounded by a fuel budget counted in VM instructions (the
+//     same estimate the other passes use). When it runs out, or a statement
+//     would trap (division by zero, array index out of bounds), the program is cut at the last complete
+//     top-level statement or loop iteration: the printed values come first,
+//     then `letbro`s restoring every variable and non-zero array element,
+//     then the unevaluated rest.
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// =====================================================================================
+// Class: PartialEvaluator
+// Purpose:
+//   - Interprets top-level statements in order, keeping a snapshot at each
+//     statement (and each iteration of a top-level whilebro) so a failed step
+//     can be rolled back and left to normal code generation.
+//   - Programs that read a variable before any `letbro` declares it are left
+//     untouched, so Codegen still reports the error.
+// =====================================================================================
+class PartialEvaluator {
+public:
+    // fuel:       VM instructions the evaluator may simulate
+    // codeBudget: maximum size of the generated code, in bytes
+    PartialEvaluator(long fuel, int codeBudget);
+
+    // Rewrites `program` in place
+    void run(Program& program);
+
+private:
+    // Runs statements / one statement; false if evaluation had to stop
+    bool execBlock(const std::vector<StmtPtr>& block);
+    bool exec(const StmtPtr& stmt);
+
+    // Evaluates `expr` into `value`; false on division by zero or a bad index
+    bool eval(const ExprPtr& expr, uint16_t& value);
+
+    // Element `index` of `array` (created zeroed on first use); nullptr if out of bounds
+    uint16_t* element(const std::string& array, int size, uint16_t index);
+
+    // Charges `units` of fuel; false if there is not enough left
+    bool spend(long units);
+
+    std::map<std::string, uint16_t> env;  // Current variable values (missing = 0)
+    std::map<std::string, std::vector<uint16_t>> arrays;  // Current array contents
+    std::vector<StmtPtr> output;          // printbro of each value / string printed so far
+    long fuel;
+    int codeBudget;
+    size_t maxOutputs = 0;                // Printed values that fit in the code budget
+};
@@ -0,0 +1,185 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: jumpthread.cpp
+// Purpose:
+//   - Implements jump threading, branch inversion and dead jump removal on
+//     the instruction list produced by Codegen.
+//
+// Why threading through conditional jumps is exact:
+//   - JMP, JZ and JNZ never change AX. Once a `JZ` is taken AX is known to be 0
+//     until the next non-jump instruction, so any JZ/JNZ met on the way has a
+//     known outcome.
+// =====================================================================================
+
+#include "jumpthread.h"
+#include <cstddef>
+
+namespace {
+
+    bool isJump(Opcode op) {
+        return op == Opcode::JMP || op == Opcode::JZ || op == Opcode::JNZ;
+    }
+
+} // namespace
+
+// =====================================================================================
+// Function: run
+// Purpose: Applies every rewrite until the code stops changing.
+// =====================================================================================
+void JumpThreader::run(std::vector<Instruction>& code, std::vector<int>& sourceMap) {
+    sourceMap.resize(code.size(), -1);
+
+    bool changed = true;
+    while (changed) {
+        changed = thread(code);
+        changed |= invert(code);
+        changed |= removeDead(code, sourceMap);
+    }
+}
+
+// =====================================================================================
+// Function: thread
+// Purpose:
+//   - Follows each jump through the jumps it lands on and points it at the
+//     first instruction that does real work.
+//   - A chain longer than the program is a loop of jumps (e.g. `JMP` to itself)
+//     and is left alone.
+// =====================================================================================
+bool JumpThreader::thread(std::vector<Instruction>& code) {
+    bool changed = false;
+
+    for (auto& instr : code) {
+        if (!isJump(instr.op)) continue;
+
+        size_t target = instr.a1;
+        bool cyclic = false;
+
+        for (size_t steps = 0; target < code.size(); ++steps) {
+            if (steps > code.size()) {
+                cyclic = true;
+                break;
+            }
+
+            const Instruction& at = code[target];
+            if (at.op == Opcode::JMP) {
+                target = at.a1;
+            } else if (instr.op != Opcode::JMP && (at.op == Opcode::JZ || at.op == Opcode::JNZ)) {
+                // AX is known here: 0 after a taken JZ, non-zero after a taken JNZ
+                target = (at.op == instr.op) ? at.a1 : target + 1;
+            } else {
+                break;
+            }
+        }
+        if (cyclic || target >= code.size()) continue;
+
+        // Jumping to HLT is the same as halting here
+        if (instr.op == Opcode::JMP && code[target].op == Opcode::HLT) {
+            instr = {Opcode::HLT};
+            changed = true;
+            continue;
+        }
+
+        if (target != instr.a1) {
+            instr.a1 = static_cast<uint16_t>(target);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+// =====================================================================================
+// Function: invert
+// Purpose:
+//   - `JZ L1; JMP L2; L1:` branches twice on the path that continues. Flipping
+//     the condition to `JNZ L2` leaves a single branch, taken only when the
+//     original JMP would have been.
+//   - The JMP is only dropped when no other jump lands on it. It is turned into
+//     a jump to the next instruction, which removeDead then deletes.
+// =====================================================================================
+bool JumpThreader::invert(std::vector<Instruction>& code) {
+    std::vector<bool> targeted(code.size() + 1, false);
+    for (const auto& instr : code)
+        if (isJump(instr.op) && instr.a1 <= code.size()) targeted[instr.a1] = true;
+
+    bool changed = false;
+
+    for (size_t i = 0; i + 1 < code.size(); ++i) {
+        Instruction& cond = code[i];
+        Instruction& jump = code[i + 1];
+
+        if (cond.op != Opcode::JZ && cond.op != Opcode::JNZ) continue;
+        if (jump.op != Opcode::JMP || cond.a1 != i + 2 || targeted[i + 1]) continue;
+
+        cond.op = (cond.op == Opcode::JZ) ? Opcode::JNZ : Opcode::JZ;
+        cond.a1 = jump.a1;
+        jump.a1 = static_cast<uint16_t>(i + 2);
+        targeted[cond.a1] = true;
+        changed = true;
+    }
+
+    return changed;
+}
+
+// =====================================================================================
+// Function: removeDead
+// Purpose:
+//   - Deletes jumps whose target is the next instruction, and instructions that
+//     cannot be reached from the entry point.
+//   - Every remaining jump is renumbered. A target that was deleted becomes the
+//     next instruction kept, which is where control went anyway.
+// =====================================================================================
+bool JumpThreader::removeDead(std::vector<Instruction>& code, std::vector<int>& sourceMap) {
+    // ---------------- Reachability from instruction 0 ----------------
+    std::vector<bool> reachable(code.size(), false);
+    std::vector<size_t> work;
+    if (!code.empty()) work.push_back(0);
+
+    while (!work.empty()) {
+        size_t i = work.back();
+        work.pop_back();
+        if (i >= code.size() || reachable[i]) continue;
+        reachable[i] = true;
+
+        const Instruction& instr = code[i];
+        if (isJump(instr.op)) work.push_back(instr.a1);
+        if (instr.op != Opcode::JMP && instr.op != Opcode::HLT) work.push_back(i + 1);
+    }
+
+    // ---------------- Pick the instructions to keep ----------------
+    std::vector<bool> keep(code.size());
+    bool removed = false;
+    for (size_t i = 0; i < code.size(); ++i) {
+        keep[i] = reachable[i] && !(isJump(code[i].op) && code[i].a1 == i + 1);
+        removed |= !keep[i];
+    }
+    if (!removed) return false;
+
+    // newIndex[i] = number of kept instructions before i = index of the first
+    // kept instruction at or after i
+    std::vector<uint16_t> newIndex(code.size() + 1);
+    uint16_t kept = 0;
+    for (size_t i = 0; i < code.size(); ++i) {
+        newIndex[i] = kept;
+        if (keep[i]) ++kept;
+    }
+    newIndex[code.size()] = kept;
+
+    std::vector<Instruction> out;
+    std::vector<int> outMap;
+    out.reserve(kept);
+    outMap.reserve(kept);
+    for (size_t i = 0; i < code.size(); ++i) {
+        if (!keep[i]) continue;
+        Instruction instr = code[i];
+        if (isJump(instr.op) && instr.a1 <= code.size()) instr.a1 = newIndex[instr.a1];
+        out.push_back(instr);
+        outMap.push_back(sourceMap[i]);
+    }
+
+    code = std::move(out);
+    sourceMap = std::move(outMap);
+    return true;
+}
@@ -0,0 +1,65 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: jumpthread.h
+// Purpose:
+//   - Declares the jump threading pass, which cleans up the branches Codegen
+//     emits after `patchJumps` has resolved every label to an instruction index.
+//   - Codegen lays out each ifbro/whilebro on its own, so nested control flow
+//     produces jumps to jumps, e.g. the `JMP end` after a then-branch landing on
+//     the back-edge `JMP cond` of the enclosing whilebro.
+//
+// Rewrites (repeated until nothing changes):
+//   → Threading:    a jump to a `JMP L` goes straight to L. A `JZ` landing on
+//                   another `JZ` follows it too (AX is still 0), and one landing
+//                   on a `JNZ` skips past it.
+//   → Halting:      `JMP L` where L is `HLT` becomes `HLT`.
+//   → Inversion:    `JZ L1; JMP L2; L1:` becomes `JNZ L2; L1:`, so the common
+//                   path falls through instead of taking the JMP.
+//   → Removal:      jumps to the next instruction and unreachable code are
+//                   deleted, and every jump target is renumbered.
+//
+// Example (ifbro/elsebro at the end of a whilebro body):
+//   0: ...loop cond       0: ...loop cond
+//   2: JZ 10              2: JZ 10
+//   3: ...if cond         3: ...if cond
+//   5: JZ 8               5: JZ 8
+//   6: ...then     ==>    6: ...then
+//   7: JMP 9              7: JMP 0      ← was a jump to a jump
+//   8: ...else            8: ...else
+//   9: JMP 0              9: JMP 0
+//  10: HLT               10: HLT
+// =====================================================================================
+
+#pragma once
+
+#include "RohitVM.hpp"   // Instruction and Opcode definitions
+#include <vector>
+
+// =====================================================================================
+// Class: JumpThreader
+// Role:
+//   - Static utility class: rewrites an instruction list whose jump operands are
+//     instruction indices (the form Codegen produces, before VM::loadProgram
+//     turns them into byte addresses).
+//
+// Usage:
+//   JumpThreader::run(bytecode, sourceMap);
+// =====================================================================================
+class JumpThreader {
+public:
+    // sourceMap holds one statement id per instruction and is kept in step
+    static void run(std::vector<Instruction>& code, std::vector<int>& sourceMap);
+
+private:
+    // Retargets every jump to the end of its chain; returns true if anything changed
+    static bool thread(std::vector<Instruction>& code);
+
+    // Turns `JZ L1; JMP L2; L1:` into `JNZ L2`; returns true if anything changed
+    static bool invert(std::vector<Instruction>& code);
+
+    // Deletes jumps to the next instruction and unreachable code; returns true
+    // if anything was deleted
+    static bool removeDead(std::vector<Instruction>& code, std::vector<int>& sourceMap);
+};
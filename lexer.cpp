@@ -11,8 +11,8 @@
 //
 //   - It handles:
 //       → Identifiers and keywords (e.g., letbro, ifbro, whilebro)
-//       → Numbers
-//       → Operators and punctuation
+//       → Numbers and string literals
+//       → Operators (arithmetic, comparison, && || !) and punctuation
 //       → Whitespace skipping and error handling for invalid characters
 // =======================================================================================
 
@@ -80,10 +80,13 @@ Token Lexer::nextToken() {
     if (c == '*') { advance(); return Token(TokenType::Star, "*"); }
     if (c == '/') { advance(); return Token(TokenType::Slash, "/"); }
     if (c == ';') { advance(); return Token(TokenType::Semicolon, ";"); }
+    if (c == ',') { advance(); return Token(TokenType::Comma, ","); }
     if (c == '(') { advance(); return Token(TokenType::LParen, "("); }
     if (c == ')') { advance(); return Token(TokenType::RParen, ")"); }
     if (c == '{') { advance(); return Token(TokenType::LBrace, "{"); }
     if (c == '}') { advance(); return Token(TokenType::RBrace, "}"); }
+    if (c == '[') { advance(); return Token(TokenType::LBracket, "["); }
+    if (c == ']') { advance(); return Token(TokenType::RBracket, "]"); }
 
     // Handle assignment '=' or comparison '=='
     if (c == '=') {
@@ -96,8 +99,17 @@ Token Lexer::nextToken() {
     if (c == '>') { advance(); return Token(TokenType::Greater, ">"); }
     if (c == '<') { advance(); return Token(TokenType::Less, "<"); }
 
-    // Number literals
+    // Logical operators ('&' and '|' on their own are not valid)
+    if (c == '!') { advance(); return Token(TokenType::Bang, "!"); }
+    if (c == '&' || c == '|') {
+        advance();
+        if (match(c)) return c == '&' ? Token(TokenType::AndAnd, "&&") : Token(TokenType::OrOr, "||");
+        return Token(TokenType::Invalid, std::string(1, c));
+    }
+
+    // Number and string literals
     if (std::isdigit(c)) return number();
+    if (c == '"') { advance(); return string(); }
 
     // Identifiers and keywords
     if (std::isalpha(c)) return identifierOrKeyword();
@@ -118,7 +130,7 @@ Token Lexer::identifierOrKeyword() {
     while (std::isalnum(peek())) advance();
     std::string text = src.substr(start, pos - start);
 
-    static std::unordered_map<std::string, TokenType> keywords = {
+    static const std::unordered_map<std::string, TokenType> keywords = {
         {"letbro",    TokenType::LetBro},
         {"ifbro",     TokenType::IfBro},
         {"elsebro",   TokenType::ElseBro},
@@ -142,6 +154,33 @@ Token Lexer::number() {
     return Token(TokenType::Number, src.substr(start, pos - start));
 }
 
+// ---------------------------------------------------------------------------------------
+// string()
+// Parses the rest of a string literal; the token text holds the bytes it stands for.
+// Escapes: \n, \t, \\ and \". A literal left open at the end of a line (or of
+// the source), or an unknown escape, gives an Invalid token.
+// Example: "Hi\n" becomes Token(String, "Hi" + newline).
+// ---------------------------------------------------------------------------------------
+Token Lexer::string() {
+    std::string text;
+    while (true) {
+        char c = advance();
+        if (c == '"') return Token(TokenType::String, text);
+        if (c == '\0' || c == '\n') return Token(TokenType::Invalid, "\"" + text);
+        if (c != '\\') {
+            text += c;
+            continue;
+        }
+
+        char escaped = advance();
+        if      (escaped == 'n')  text += '\n';
+        else if (escaped == 't')  text += '\t';
+        else if (escaped == '\\') text += '\\';
+        else if (escaped == '"')  text += '"';
+        else return Token(TokenType::Invalid, "\\" + std::string(1, escaped));
+    }
+}
+
 // ---------------------------------------------------------------------------------------
 // peekToken()
 // Optional utility: Allows peeking ahead at the next token without consuming it.
@@ -61,4 +61,5 @@ private:
     void skipWhitespace();           // Skip whitespace (tabs, spaces, newlines)
     Token identifierOrKeyword();     // Handle identifiers and reserved words (e.g., letbro)
     Token number();                  // Handle numeric literals
+    Token string();                  // Handle string literals (after the opening quote)
 };
@@ -0,0 +1,107 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: licm.cpp
+// Purpose:
+//   - Implements Loop-Invariant Code Motion for `whilebro` loops.
+//
+// Safety rules:
+//   - An expression is invariant when none of the variables it reads is assigned
+//     anywhere inside the loop (nested blocks included).
+//   - Only operator and intrinsic expressions are hoisted; a lone number or
+//     variable is already a single instruction.
+//   - Divisions whose divisor is not a known non-zero constant stay put: moving
+//     them to the preheader could raise "Division by zero" in a program that
+//     would never have executed them.
+//   - Array reads stay put (the elements may change, and the index may be out
+//     of bounds), but invariant parts of their index are still hoisted.
+// =====================================================================================
+
+#include "licm.h"
+#include "astutils.h"
+
+// =====================================================================================
+// Function: run
+// Purpose: Entry point; hoists out of every loop in the program.
+// =====================================================================================
+void LoopInvariantMotion::run(Program& program) {
+    tempCounter = 0;
+    processBlock(program.statements);
+}
+
+// =====================================================================================
+// Function: processBlock
+// Purpose:
+//   - Rebuilds `block`, inserting a preheader in front of each whilebro.
+//   - Inner loops are handled first, so their preheaders become part of the
+//     outer loop body and can be hoisted again if they are invariant there too.
+// =====================================================================================
+void LoopInvariantMotion::processBlock(std::vector<StmtPtr>& block) {
+    std::vector<StmtPtr> out;
+
+    for (auto& stmt : block) {
+        if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+            processBlock(ifs->thenBranch);
+            processBlock(ifs->elseBranch);
+        }
+        else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+            processBlock(wh->body);
+
+            std::set<std::string> variant;
+            AstUtils::collectAssigned(wh->body, variant);
+
+            std::vector<StmtPtr> preheader;
+            std::map<std::string, std::string> temps;  // exprKey → temporary name
+
+            wh->condition = hoist(wh->condition, variant, preheader, temps);
+            AstUtils::forEachExpr(wh->body, [&](ExprPtr& e) {
+                e = hoist(e, variant, preheader, temps);
+            });
+
+            out.insert(out.end(), preheader.begin(), preheader.end());
+        }
+        out.push_back(stmt);
+    }
+
+    block = std::move(out);
+}
+
+// =====================================================================================
+// Function: hoist
+// Purpose:
+//   - Finds the largest invariant sub-trees of `expr` and replaces each with a
+//     read of a temporary. Identical invariant expressions share one temporary.
+// =====================================================================================
+ExprPtr LoopInvariantMotion::hoist(const ExprPtr& expr,
+                                   const std::set<std::string>& variant,
+                                   std::vector<StmtPtr>& preheader,
+                                   std::map<std::string, std::string>& temps) {
+    if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr)) {
+        idx->index = hoist(idx->index, variant, preheader, temps);
+        return expr;
+    }
+
+    auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr);
+    auto call = std::dynamic_pointer_cast<CallExpr>(expr);
+    if (!bin && !call) return expr;  // Numbers and variables are not worth a temporary
+
+    if (!AstUtils::usesAny(expr, variant) && !AstUtils::mayTrap(expr)) {
+        std::string key = AstUtils::exprKey(expr);
+        auto it = temps.find(key);
+        if (it == temps.end()) {
+            std::string name = "__licm" + std::to_string(tempCounter++);
+            preheader.push_back(std::make_shared<LetStatement>(name, expr));
+            it = temps.emplace(key, name).first;
+        }
+        return std::make_shared<VariableExpr>(it->second);
+    }
+
+    if (call) {
+        for (auto& arg : call->args) arg = hoist(arg, variant, preheader, temps);
+        return expr;
+    }
+    bin->left = hoist(bin->left, variant, preheader, temps);
+    bin->right = hoist(bin->right, variant, preheader, temps);
+    return expr;
+}
@@ -0,0 +1,55 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: licm.h
+// Purpose:
+//   - Declares the Loop-Invariant Code Motion (LICM) pass.
+//   - Expressions inside a `whilebro` that only read variables the loop never
+//     assigns are computed once, before the loop, instead of on every iteration.
+//
+// Example:
+//   letbro i = 0;                         letbro i = 0;
+//   whilebro (i < n * 2) {       ==>      letbro __licm0 = n * 2;
+//       printbro(i + k * k);              letbro __licm1 = k * k;
+//       letbro i = i + 1;                 whilebro (i < __licm0) {
+//   }                                         printbro(i + __licm1);
+//                                             letbro i = i + 1;
+//                                         }
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// =====================================================================================
+// Class: LoopInvariantMotion
+// Purpose:
+//   - Walks the AST, innermost loops first, and moves invariant sub-expressions
+//     into compiler temporaries (`__licmN`) assigned in a preheader that runs
+//     once immediately before the loop.
+//   - Temporaries start with "__", which the lexer never produces, so they can
+//     not clash with user variables.
+// =====================================================================================
+class LoopInvariantMotion {
+public:
+    // Rewrites `program` in place
+    void run(Program& program);
+
+private:
+    // Processes one statement list, hoisting out of every loop it contains
+    void processBlock(std::vector<StmtPtr>& block);
+
+    // Returns `expr` with invariant sub-trees replaced by temporaries;
+    // their definitions are appended to `preheader`.
+    ExprPtr hoist(const ExprPtr& expr,
+                  const std::set<std::string>& variant,
+                  std::vector<StmtPtr>& preheader,
+                  std::map<std::string, std::string>& temps);
+
+    int tempCounter = 0;  // Used to create unique temporary names
+};
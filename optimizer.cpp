@@ -0,0 +1,70 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: optimizer.cpp
+// Purpose:
+//   - Runs the enabled AST and instruction passes in a fixed order.
+// =====================================================================================
+
+#include "optimizer.h"
+#include "evaluator.h"
+#include "licm.h"
+#include "strength.h"
+#include "cse.h"
+#include "unroll.h"
+#include "jumpthread.h"
+#include "blocklayout.h"
+#include "range.h"
+#include "boundscheck.h"
+
+// =====================================================================================
+// Function: run
+// Purpose: Applies every enabled pass to `program`.
+// =====================================================================================
+void Optimizer::run(Program& program, const OptimizerOptions& options) {
+    if (options.partialEval) {
+        PartialEvaluator evaluator(options.fuel, options.codeBudget);
+        evaluator.run(program);
+    }
+    if (options.licm) {
+        LoopInvariantMotion licm;
+        licm.run(program);
+    }
+    if (options.strength) {
+        StrengthReduction strength;
+        strength.run(program);
+    }
+    if (options.unroll) {
+        LoopUnroller unroller(options.unrollFactor, options.codeBudget, options.profile);
+        unroller.run(program);
+    }
+    if (options.cse) {
+        CommonSubexpressions cse;
+        cse.run(program);
+    }
+    // Last: proves facts about the exact tree Codegen will see, then again
+    // once array loops it could not prove have a guarded copy
+    if (options.elideChecks) {
+        RangeAnalysis ranges;
+        ranges.run(program);
+        BoundsCheckHoisting hoisting(options.codeBudget);
+        if (hoisting.run(program)) ranges.run(program);
+    }
+}
+
+// =====================================================================================
+// Function: run
+// Purpose: Applies every enabled instruction-level pass to `code` (and its source map).
+// =====================================================================================
+void Optimizer::run(std::vector<Instruction>& code, std::vector<int>& sourceMap,
+                    const OptimizerOptions& options) {
+    if (options.jumpThreading) {
+        JumpThreader::run(code, sourceMap);
+    }
+    // Static guesses would undo the layout Codegen chose from a real profile
+    if (options.blockLayout && !options.profile) {
+        BlockLayout::run(code, sourceMap);
+        if (options.jumpThreading) JumpThreader::run(code, sourceMap);  // Tidy the new jumps
+    }
+}
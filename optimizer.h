@@ -0,0 +1,69 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: optimizer.h
+// Purpose:
+//   - Runs the AST-level optimization passes between parsing and code generation,
+//     and the instruction-level passes after it.
+//   - Each pass can be switched on or off through OptimizerOptions, so broc can
+//     compare optimized and unoptimized output (`-O0`).
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include "RohitVM.hpp"   // Instruction, and memory layout (code must end before DATA_BASE)
+#include "profile.h"     // Branch counts for --profile-use
+#include <vector>
+
+// -------------------------------------------------------------------------------------
+// Struct: OptimizerOptions
+// Purpose: Selects which passes run.
+// -------------------------------------------------------------------------------------
+struct OptimizerOptions {
+    bool partialEval = false;  // Run the program at compile time (broc --partial-eval)
+    bool licm = true;      // Hoist loop-invariant expressions out of whilebro loops
+    bool strength = true;  // Shifts for powers of two, running sums for i * c
+    bool cse = true;       // Reuse values already computed (value numbering)
+    bool unroll = true;    // Unroll whilebro loops with a constant trip count
+    bool jumpThreading = true;  // Collapse jump chains in the generated code
+    bool blockLayout = true;    // Reorder basic blocks so hot edges fall through
+    bool elideChecks = true;    // Unchecked DIV/PUSH/POP and no CHK where range analysis proves them safe
+
+    int unrollFactor = 4;                    // Body copies per partially unrolled loop
+    long fuel = 1000000;                     // VM instructions the partial evaluator may simulate
+    const Profile* profile = nullptr;        // Branch counts from a previous run (--profile-use)
+    int codeBudget = Memory::DATA_BASE;      // Unrolling stops before code reaches this size
+
+    // Every pass disabled (broc -O0)
+    static OptimizerOptions none() {
+        OptimizerOptions o;
+        o.licm = false;
+        o.strength = false;
+        o.cse = false;
+        o.unroll = false;
+        o.jumpThreading = false;
+        o.blockLayout = false;
+        o.elideChecks = false;
+        return o;
+    }
+};
+
+// =====================================================================================
+// Class: Optimizer
+// Role:
+//   - Static utility class: rewrites a parsed Program, or the instructions
+//     generated from it, in place.
+//
+// Usage:
+//   Optimizer::run(program, options);
+//   bytecode = codegen.generate(program);
+//   Optimizer::run(bytecode, sourceMap, options);
+// =====================================================================================
+class Optimizer {
+public:
+    static void run(Program& program, const OptimizerOptions& options);
+    static void run(std::vector<Instruction>& code, std::vector<int>& sourceMap,
+                    const OptimizerOptions& options);
+};
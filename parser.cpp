@@ -6,12 +6,15 @@
 // Purpose:
 //   - Implements the Parser, which turns tokens into an Abstract Syntax Tree (AST).
 //   - Follows Recursive Descent Parsing with basic precedence handling for expressions.
-//   - Supports: variable declarations, arithmetic, print statements, conditionals, loops.
+//   - Supports: variable declarations, fixed-size arrays, arithmetic, intrinsic calls,
+//     print statements, conditionals, loops.
 // =======================================================================================
 
 #include "parser.h"
+#include <algorithm>
 #include <stdexcept>
 #include <iostream>
+#include <map>
 
 // =======================================================================================
 // SECTION: Token Navigation Utilities
@@ -20,6 +23,21 @@
 // Constructor: Takes ownership of the token stream from the Lexer
 Parser::Parser(std::vector<Token> tokens) : tokens(std::move(tokens)) {}
 
+// Counts an error; the caller writes the message
+std::ostream& Parser::error() {
+    ++errorCount;
+    return *diagnostics;
+}
+
+void Parser::enter() {
+    if (++nesting > MAX_NESTING) throw TooDeep();
+}
+
+void Parser::grow(int leftHeight) {
+    height = std::max(leftHeight, height) + 1;
+    if (height > MAX_NESTING) throw TooDeep();
+}
+
 // Peek at the current token without consuming it
 Token Parser::peek() const {
     return pos < tokens.size() ? tokens[pos] : Token(TokenType::EndOfFile, "");
@@ -47,7 +65,7 @@ bool Parser::match(TokenType type) {
 // Like match(), but prints error if token not found
 bool Parser::expect(TokenType type, const std::string& msgIfFail) {
     if (!match(type)) {
-        std::cerr << "Parse error: " << msgIfFail << "\n";
+        error() << "Parse error: " << msgIfFail << "\n";
         return false;
     }
     return true;
@@ -60,9 +78,13 @@ bool Parser::expect(TokenType type, const std::string& msgIfFail) {
 // Parses a full program = list of statements until EOF
 Program Parser::parseProgram() {
     Program prog;
-    while (!isAtEnd()) {
-        StmtPtr stmt = parseStatement();
-        if (stmt) prog.statements.push_back(stmt);
+    try {
+        while (!isAtEnd()) {
+            StmtPtr stmt = parseStatement();
+            if (stmt) prog.statements.push_back(stmt);
+        }
+    } catch (const TooDeep&) {
+        error() << "Parse error: nested more than " << MAX_NESTING << " levels deep\n";
     }
     return prog;
 }
@@ -73,35 +95,95 @@ Program Parser::parseProgram() {
 
 // Dispatch based on keyword: letbro, printbro, ifbro, whilebro
 StmtPtr Parser::parseStatement() {
-    if (match(TokenType::LetBro))    return parseLet();
-    if (match(TokenType::PrintBro))  return parsePrint();
-    if (match(TokenType::IfBro))     return parseIf();
-    if (match(TokenType::WhileBro))  return parseWhile();
+    int id = nextStatementId++;  // Taken before nested blocks, so ids follow source order
+
+    StmtPtr stmt;
+    if (match(TokenType::LetBro))         stmt = parseLet();
+    else if (match(TokenType::PrintBro))  stmt = parsePrint();
+    else if (match(TokenType::IfBro))     stmt = parseIf();
+    else if (match(TokenType::WhileBro))  stmt = parseWhile();
+    else {
+        error() << "Unexpected token: " << peek().text << "\n";
+        advance(); // Skip bad token
+        return nullptr;
+    }
 
-    std::cerr << "Unexpected token: " << peek().text << "\n";
-    advance(); // Skip bad token
-    return nullptr;
+    if (stmt) stmt->id = id;
+    return stmt;
 }
 
 // letbro a = 5;
 StmtPtr Parser::parseLet() {
     if (peek().type != TokenType::Identifier) {
-        std::cerr << "Expected variable name after letbro\n";
+        error() << "Expected variable name after letbro\n";
         return nullptr;
     }
 
     std::string name = advance().text;
 
+    // letbro arr[i] = 5;
+    if (peek().type == TokenType::LBracket && arrays.count(name)) {
+        auto target = std::dynamic_pointer_cast<IndexExpr>(parseIndex(name));
+        if (!target) return nullptr;
+        if (peek().type == TokenType::Semicolon) {
+            error() << "Array already declared: " << name << "\n";
+            advance();
+            return nullptr;
+        }
+        if (!expect(TokenType::Assign, "Expected '=' after array element")) return nullptr;
+        ExprPtr value = parseExpression();
+        if (!expect(TokenType::Semicolon, "Expected ';' after expression")) return nullptr;
+        return std::make_shared<ArrayStoreStatement>(name, target->size, target->index, value);
+    }
+
+    // letbro arr[10];
+    if (match(TokenType::LBracket)) return parseArrayDecl(name);
+
     if (!expect(TokenType::Assign, "Expected '=' after variable name")) return nullptr;
     ExprPtr value = parseExpression();
     if (!expect(TokenType::Semicolon, "Expected ';' after expression")) return nullptr;
 
+    if (arrays.count(name)) {
+        error() << "Cannot assign to array " << name << " without an index\n";
+        return nullptr;
+    }
+
     return std::make_shared<LetStatement>(name, value);
 }
 
-// printbro(a + b);
+// letbro arr[10];  (after the '[')
+// Arrays are declared once, before their first use in the source, and hold
+// 1 to MAX_ARRAY_SIZE elements that all start at 0.
+StmtPtr Parser::parseArrayDecl(const std::string& name) {
+    constexpr int MAX_ARRAY_SIZE = 4096;
+
+    if (peek().type != TokenType::Number) {
+        error() << "Expected a constant array size for " << name << "\n";
+        return nullptr;
+    }
+    std::string sizeText = advance().text;
+    int size = sizeText.size() > 5 ? MAX_ARRAY_SIZE + 1 : std::stoi(sizeText);
+
+    if (!expect(TokenType::RBracket, "Expected ']' after array size")) return nullptr;
+    if (!expect(TokenType::Semicolon, "Expected ';' after array declaration")) return nullptr;
+
+    if (size < 1 || size > MAX_ARRAY_SIZE) {
+        error() << "Array size of " << name << " must be between 1 and " << MAX_ARRAY_SIZE << "\n";
+        return nullptr;
+    }
+    arrays[name] = size;
+    return std::make_shared<ArrayDeclStatement>(name, size);
+}
+
+// printbro(a + b);  or  printbro("text");
 StmtPtr Parser::parsePrint() {
     if (!expect(TokenType::LParen, "Expected '(' after printbro")) return nullptr;
+    if (peek().type == TokenType::String) {
+        std::string text = advance().text;
+        if (!expect(TokenType::RParen, "Expected ')' after string")) return nullptr;
+        if (!expect(TokenType::Semicolon, "Expected ';' after printbro")) return nullptr;
+        return std::make_shared<PrintStringStatement>(text);
+    }
     ExprPtr expr = parseExpression();
     if (!expect(TokenType::RParen, "Expected ')' after expression")) return nullptr;
     if (!expect(TokenType::Semicolon, "Expected ';' after printbro")) return nullptr;
@@ -139,21 +221,54 @@ StmtPtr Parser::parseWhile() {
 
 // { stmt1; stmt2; }
 std::vector<StmtPtr> Parser::parseBlock() {
+    enter();
     std::vector<StmtPtr> stmts;
     while (!isAtEnd() && !match(TokenType::RBrace)) {
         auto stmt = parseStatement();
         if (stmt) stmts.push_back(stmt);
     }
+    leave();
     return stmts;
 }
 
 // =======================================================================================
-// SECTION: Expression Parsing — handles precedence (==, >, <, +, *, etc.)
+// SECTION: Expression Parsing — handles precedence (||, &&, ==, >, <, +, *, !, etc.)
 // =======================================================================================
 
 // Start of expression parsing (top-level call)
 ExprPtr Parser::parseExpression() {
-    return parseEquality(); // Root: check for ==
+    enter();
+    ExprPtr expr = parseOr(); // Root: lowest precedence is ||
+    leave();
+    return expr;
+}
+
+// Handles: a || b
+ExprPtr Parser::parseOr() {
+    auto expr = parseAnd();
+
+    while (match(TokenType::OrOr)) {
+        int left = height;
+        auto right = parseAnd();
+        grow(left);
+        expr = std::make_shared<BinaryExpr>(BinaryOp::Or, expr, right);
+    }
+
+    return expr;
+}
+
+// Handles: a && b
+ExprPtr Parser::parseAnd() {
+    auto expr = parseEquality();
+
+    while (match(TokenType::AndAnd)) {
+        int left = height;
+        auto right = parseEquality();
+        grow(left);
+        expr = std::make_shared<BinaryExpr>(BinaryOp::And, expr, right);
+    }
+
+    return expr;
 }
 
 // Handles: a == b
@@ -161,7 +276,9 @@ ExprPtr Parser::parseEquality() {
     auto expr = parseComparison();
 
     while (match(TokenType::Equal)) {
+        int left = height;
         auto right = parseComparison();
+        grow(left);
         expr = std::make_shared<BinaryExpr>(BinaryOp::Equal, expr, right);
     }
 
@@ -173,11 +290,14 @@ ExprPtr Parser::parseComparison() {
     auto expr = parseTerm();
 
     while (true) {
+        int left = height;
         if (match(TokenType::Greater)) {
             auto right = parseTerm();
+            grow(left);
             expr = std::make_shared<BinaryExpr>(BinaryOp::Greater, expr, right);
         } else if (match(TokenType::Less)) {
             auto right = parseTerm();
+            grow(left);
             expr = std::make_shared<BinaryExpr>(BinaryOp::Less, expr, right);
         } else {
             break;
@@ -192,11 +312,14 @@ ExprPtr Parser::parseTerm() {
     auto expr = parseFactor();
 
     while (true) {
+        int left = height;
         if (match(TokenType::Plus)) {
             auto right = parseFactor();
+            grow(left);
             expr = std::make_shared<BinaryExpr>(BinaryOp::Add, expr, right);
         } else if (match(TokenType::Minus)) {
             auto right = parseFactor();
+            grow(left);
             expr = std::make_shared<BinaryExpr>(BinaryOp::Sub, expr, right);
         } else {
             break;
@@ -208,14 +331,17 @@ ExprPtr Parser::parseTerm() {
 
 // Handles: a * b or a / b
 ExprPtr Parser::parseFactor() {
-    auto expr = parsePrimary();
+    auto expr = parseUnary();
 
     while (true) {
+        int left = height;
         if (match(TokenType::Star)) {
-            auto right = parsePrimary();
+            auto right = parseUnary();
+            grow(left);
             expr = std::make_shared<BinaryExpr>(BinaryOp::Mul, expr, right);
         } else if (match(TokenType::Slash)) {
-            auto right = parsePrimary();
+            auto right = parseUnary();
+            grow(left);
             expr = std::make_shared<BinaryExpr>(BinaryOp::Div, expr, right);
         } else {
             break;
@@ -225,14 +351,36 @@ ExprPtr Parser::parseFactor() {
     return expr;
 }
 
+// Handles: !a
+// There is no separate NOT node: !a means exactly a == 0, which every pass
+// already understands, and Codegen turns it into a jump on `a` itself.
+ExprPtr Parser::parseUnary() {
+    if (match(TokenType::Bang)) {
+        enter();
+        auto operand = parseUnary();
+        leave();
+        grow(1);
+        return std::make_shared<BinaryExpr>(BinaryOp::Equal, operand, std::make_shared<NumberExpr>(0));
+    }
+    return parsePrimary();
+}
+
 // Handles literals, identifiers, and parenthesis
 ExprPtr Parser::parsePrimary() {
+    height = 1;  // A leaf, unless a call, an index or parentheses say otherwise
     if (match(TokenType::Number)) {
         return std::make_shared<NumberExpr>(std::stoi(tokens[pos - 1].text));
     }
 
     if (match(TokenType::Identifier)) {
-        return std::make_shared<VariableExpr>(tokens[pos - 1].text);
+        std::string name = tokens[pos - 1].text;
+        if (peek().type == TokenType::LParen) return parseCall(name);
+        if (peek().type == TokenType::LBracket) return parseIndex(name);
+        if (arrays.count(name)) {
+            error() << "Array " << name << " used without an index\n";
+            return nullptr;
+        }
+        return std::make_shared<VariableExpr>(name);
     }
 
     if (match(TokenType::LParen)) {
@@ -241,7 +389,59 @@ ExprPtr Parser::parsePrimary() {
         return expr;
     }
 
-    std::cerr << "Unexpected token in expression: " << peek().text << "\n";
+    error() << "Unexpected token in expression: " << peek().text << "\n";
     advance();
     return nullptr;
 }
+
+// minbro(a, b), maxbro(a, b), absbro(a), clampbro(x, lo, hi), signbro(a)
+ExprPtr Parser::parseCall(const std::string& name) {
+    static const std::map<std::string, Intrinsic> intrinsics = {
+        {"minbro",   Intrinsic::Min},
+        {"maxbro",   Intrinsic::Max},
+        {"absbro",   Intrinsic::Abs},
+        {"clampbro", Intrinsic::Clamp},
+        {"signbro",  Intrinsic::Sign}
+    };
+
+    advance();  // '('
+    std::vector<ExprPtr> args;
+    int tallest = 0;
+    if (peek().type != TokenType::RParen) {
+        do {
+            args.push_back(parseExpression());
+            tallest = std::max(tallest, height);
+        } while (match(TokenType::Comma));
+    }
+    height = tallest;
+    grow(0);
+    if (!expect(TokenType::RParen, "Expected ')' after arguments")) return nullptr;
+
+    auto it = intrinsics.find(name);
+    if (it == intrinsics.end()) {
+        error() << "Unknown function: " << name << "\n";
+        return nullptr;
+    }
+    if (args.size() != intrinsicArity(it->second)) {
+        error() << name << " expects " << intrinsicArity(it->second) << " argument(s), got "
+                  << args.size() << "\n";
+        return nullptr;
+    }
+    return std::make_shared<CallExpr>(it->second, args);
+}
+
+// arr[i + 1]  (after the array name)
+ExprPtr Parser::parseIndex(const std::string& name) {
+    advance();  // '['
+    ExprPtr index = parseExpression();
+    grow(0);
+    if (!expect(TokenType::RBracket, "Expected ']' after index")) return nullptr;
+
+    auto it = arrays.find(name);
+    if (it == arrays.end()) {
+        error() << "Unknown array: " << name << "\n";
+        return nullptr;
+    }
+    if (!index) return nullptr;
+    return std::make_shared<IndexExpr>(name, it->second, index);
+}
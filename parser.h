@@ -13,6 +13,8 @@
 
 #include "lexer.h"
 #include "ast.h"
+#include <iostream>
+#include <map>
 
 // =======================================================================================
 // CLASS: Parser
@@ -28,10 +30,42 @@ public:
     // Entry point: Parse entire program (multiple statements)
     Program parseProgram();
 
+    // Error messages go to `out` instead of std::cerr (set before parseProgram)
+    void setDiagnostics(std::ostream& out) { diagnostics = &out; }
+
+    // Errors reported so far; the program is only usable if this is 0
+    int getErrorCount() const { return errorCount; }
+
+    // Deepest nesting accepted: of parentheses, `!` and blocks, and of the
+    // expression trees built (a + b + c is three levels: two additions over a
+    // leaf). Every later pass walks the AST recursively, so a deeper program
+    // would overflow the stack (of a brod worker, say) instead of failing to
+    // compile.
+    static constexpr int MAX_NESTING = 256;
 
 private:
     std::vector<Token> tokens;  // Token stream to parse
     size_t pos = 0;             // Current token index
+    int nextStatementId = 0;    // Numbers statements in source order (Statement::id)
+    std::map<std::string, int> arrays;  // Arrays declared so far → size
+    std::ostream* diagnostics = &std::cerr;
+    int errorCount = 0;
+    int nesting = 0;            // Parse functions currently nested (enter / leave)
+    int height = 0;             // Height of the expression the last parse function built
+
+    // Thrown past MAX_NESTING; parseProgram reports it once and stops
+    struct TooDeep {};
+
+    // Counts an error and returns the stream to describe it on
+    std::ostream& error();
+
+    // One more level of nesting, or TooDeep
+    void enter();
+    void leave() { --nesting; }
+
+    // `height` of a binary node over a left operand of `leftHeight` and the
+    // right operand just parsed, or TooDeep
+    void grow(int leftHeight);
 
     // -----------------------------------------------------------------------------------
     // Token Navigation Helpers
@@ -60,8 +94,12 @@ private:
     StmtPtr parseStatement();
 
     // Parses: letbro <identifier> = <expr>;
+    //         letbro <identifier>[<size>];  letbro <identifier>[<expr>] = <expr>;
     StmtPtr parseLet();
 
+    // Parses the `[size];` of an array declaration
+    StmtPtr parseArrayDecl(const std::string& name);
+
     // Parses: printbro(<expr>);
     StmtPtr parsePrint();
 
@@ -81,6 +119,12 @@ private:
     // Entry point for expression parsing
     ExprPtr parseExpression();
 
+    // Handles || operator
+    ExprPtr parseOr();
+
+    // Handles && operator
+    ExprPtr parseAnd();
+
     // Handles == operator
     ExprPtr parseEquality();
 
@@ -93,6 +137,15 @@ private:
     // Handles *, / operators
     ExprPtr parseFactor();
 
+    // Handles prefix ! (parsed as `operand == 0`)
+    ExprPtr parseUnary();
+
     // Handles literals, identifiers, and parenthesis
     ExprPtr parsePrimary();
+
+    // Parses the argument list of an intrinsic call: minbro(a, b)
+    ExprPtr parseCall(const std::string& name);
+
+    // Parses `[<expr>]` after an array name; nullptr if `name` is not an array
+    ExprPtr parseIndex(const std::string& name);
 };
@@ -0,0 +1,67 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: profile.cpp
+// Purpose:
+//   - Parses VM profiles and condenses them into per-statement branch counts.
+//
+// Why JZ and JNZ both work:
+//   - Every conditional jump Codegen emits for a statement tests that
+//     statement's condition, whatever layout or jump threading chose. A JZ is
+//     taken when the condition is false, a JNZ when it is true.
+//   - The jumps for the operands of && and || test only part of a condition,
+//     so Codegen gives them no statement id and they are skipped here.
+// =====================================================================================
+
+#include "profile.h"
+#include "RohitVM.hpp"   // Opcode values
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// =====================================================================================
+// Function: load
+// Purpose: Reads every instruction line and adds conditional jumps to `branches`.
+// =====================================================================================
+bool Profile::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open profile: " << path << "\n";
+        return false;
+    }
+
+    branches.clear();
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream fields(line);
+        size_t index;
+        unsigned opcode;
+        int statement;
+        uint64_t executed, taken;
+        if (!(fields >> index >> std::hex >> opcode >> std::dec >> statement >> executed >> taken) ||
+            taken > executed) {
+            std::cerr << "Malformed profile line " << lineNumber << " in " << path << "\n";
+            return false;
+        }
+
+        Opcode op = static_cast<Opcode>(opcode);
+        if (statement < 0 || (op != Opcode::JZ && op != Opcode::JNZ)) continue;
+
+        BranchProfile& branch = branches[statement];
+        branch.checks += executed;
+        branch.trueCount += (op == Opcode::JNZ) ? taken : executed - taken;
+    }
+
+    return true;
+}
+
+const BranchProfile* Profile::branch(int statementId) const {
+    auto it = branches.find(statementId);
+    return it != branches.end() ? &it->second : nullptr;
+}
@@ -0,0 +1,60 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: profile.h
+// Purpose:
+//   - Reads the execution profile written by the VM (VM::writeProfile) so broc
+//     can optimize for the branches that are actually hot (`--profile-use`).
+//
+// Profile file (one line per instruction, `#` starts a comment):
+//   <index> <opcode> <statement id> <times executed> <times taken>
+//
+//   `statement id` is Statement::id of the source statement the instruction
+//   was generated for (-1 for compiler-made code). `times taken` is only
+//   non-zero for jumps.
+//
+// Workflow:
+//   ./broc prog.bro -o prog.cpp
+//   g++ compiler_test.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp -o run_bro
+//   ./run_bro --profile=prog.profile
+//   ./broc prog.bro -o prog.cpp --profile-use=prog.profile
+// =====================================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+// -------------------------------------------------------------------------------------
+// Struct: BranchProfile
+// Purpose:
+//   - How an ifbro/whilebro condition behaved, summed over every conditional
+//     jump generated for it (unrolled copies included).
+// -------------------------------------------------------------------------------------
+struct BranchProfile {
+    uint64_t checks = 0;     // Times the condition was tested
+    uint64_t trueCount = 0;  // Times it was non-zero
+
+    uint64_t falseCount() const { return checks - trueCount; }
+};
+
+// =====================================================================================
+// Class: Profile
+// Purpose:
+//   - Branch behaviour per source statement. A stale profile (from an older
+//     version of the program) can only make layout choices worse, never change
+//     what the program computes.
+// =====================================================================================
+class Profile {
+public:
+    // Reads `path`; prints an error and returns false if it cannot be used
+    bool load(const std::string& path);
+
+    // Profile of the ifbro/whilebro with this Statement::id, or nullptr
+    const BranchProfile* branch(int statementId) const;
+
+private:
+    std::map<int, BranchProfile> branches;
+};
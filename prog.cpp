@@ -1,167 +1,113 @@
 #include "RohitVM.hpp"
-std::vector<Instruction> prog = {
+constexpr std::array<Instruction, 98> prog = {{
     {Opcode::MOV, 10},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
+    {Opcode::STORE, 49152},
     {Opcode::MOV, 3},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 2},
-    {Opcode::PUSH, 1},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::PUSH, 2},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::POP, 0},
+    {Opcode::STORE, 49154},
+    {Opcode::LOAD, 49152},
+    {Opcode::PUSH_NC, 0},
+    {Opcode::LOAD, 49154},
+    {Opcode::POP_NC, 1},
     {Opcode::ADD},
     {Opcode::PRN},
     {Opcode::MOV, 10},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
+    {Opcode::STORE, 49152},
     {Opcode::MOV, 3},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 2},
-    {Opcode::PUSH, 1},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::PUSH, 2},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::POP, 0},
-    {Opcode::DIV},
+    {Opcode::STORE, 49154},
+    {Opcode::LOAD, 49152},
+    {Opcode::PUSH_NC, 0},
+    {Opcode::LOAD, 49154},
+    {Opcode::PUSH_NC, 0},
+    {Opcode::POP_NC, 1},
+    {Opcode::POP_NC, 0},
+    {Opcode::DIV_NC},
     {Opcode::PRN},
     {Opcode::MOV, 10},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
+    {Opcode::STORE, 49152},
     {Opcode::MOV, 3},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 2},
-    {Opcode::PUSH, 1},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::PUSH, 2},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::POP, 0},
+    {Opcode::STORE, 49154},
+    {Opcode::LOAD, 49152},
+    {Opcode::PUSH_NC, 0},
+    {Opcode::LOAD, 49154},
+    {Opcode::PUSH_NC, 0},
+    {Opcode::POP_NC, 1},
+    {Opcode::POP_NC, 0},
     {Opcode::SUB},
     {Opcode::PRN},
     {Opcode::MOV, 10},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
+    {Opcode::STORE, 49152},
     {Opcode::MOV, 3},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 2},
-    {Opcode::PUSH, 1},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::PUSH, 2},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::POP, 0},
+    {Opcode::STORE, 49154},
+    {Opcode::LOAD, 49152},
+    {Opcode::PUSH_NC, 0},
+    {Opcode::LOAD, 49154},
+    {Opcode::POP_NC, 1},
     {Opcode::MUL},
     {Opcode::PRN},
-    {Opcode::PUSH, 1},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::PUSH, 2},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::POP, 0},
-    {Opcode::SUB},
-    {Opcode::STG},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::MOV, 0},
-    {Opcode::SUB},
-    {Opcode::STE},
-    {Opcode::CLE},
-    {Opcode::NOP},
+    {Opcode::LOAD, 49152},
+    {Opcode::PUSH_NC, 0},
+    {Opcode::LOAD, 49154},
+    {Opcode::POP_NC, 1},
+    {Opcode::LT},
+    {Opcode::JZ, 53},
     {Opcode::MOV, 999},
     {Opcode::PRN},
-    {Opcode::NOP},
+    {Opcode::JMP, 55},
     {Opcode::MOV, 111},
     {Opcode::PRN},
-    {Opcode::PUSH, 1},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::PUSH, 2},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::POP, 0},
-    {Opcode::SUB},
-    {Opcode::STL},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::MOV, 0},
-    {Opcode::SUB},
-    {Opcode::STE},
-    {Opcode::CLE},
-    {Opcode::NOP},
+    {Opcode::LOAD, 49152},
+    {Opcode::PUSH_NC, 0},
+    {Opcode::LOAD, 49154},
+    {Opcode::POP_NC, 1},
+    {Opcode::GT},
+    {Opcode::JZ, 64},
     {Opcode::MOV, 222},
     {Opcode::PRN},
-    {Opcode::NOP},
+    {Opcode::JMP, 66},
     {Opcode::MOV, 888},
     {Opcode::PRN},
-    {Opcode::PUSH, 1},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::PUSH, 2},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::POP, 0},
-    {Opcode::SUB},
-    {Opcode::STE},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::MOV, 0},
-    {Opcode::SUB},
-    {Opcode::STE},
-    {Opcode::CLE},
-    {Opcode::NOP},
+    {Opcode::LOAD, 49152},
+    {Opcode::PUSH_NC, 0},
+    {Opcode::LOAD, 49154},
+    {Opcode::POP_NC, 1},
+    {Opcode::EQ},
+    {Opcode::JZ, 75},
     {Opcode::MOV, 333},
     {Opcode::PRN},
-    {Opcode::NOP},
+    {Opcode::JMP, 77},
     {Opcode::MOV, 777},
     {Opcode::PRN},
     {Opcode::MOV, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 3},
-    {Opcode::PUSH, 3},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::MOV, 3},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::POP, 0},
-    {Opcode::SUB},
-    {Opcode::STL},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::MOV, 0},
-    {Opcode::SUB},
-    {Opcode::STE},
-    {Opcode::CLE},
-    {Opcode::NOP},
-    {Opcode::PUSH, 3},
-    {Opcode::POP, 0},
+    {Opcode::STORE, 49156},
+    {Opcode::LOAD, 49156},
+    {Opcode::PRN},
+    {Opcode::LOAD, 49156},
+    {Opcode::MOV_BX, 1},
+    {Opcode::ADD},
+    {Opcode::STORE, 49156},
+    {Opcode::LOAD, 49156},
+    {Opcode::PRN},
+    {Opcode::LOAD, 49156},
+    {Opcode::MOV_BX, 1},
+    {Opcode::ADD},
+    {Opcode::STORE, 49156},
+    {Opcode::LOAD, 49156},
     {Opcode::PRN},
-    {Opcode::PUSH, 3},
-    {Opcode::POP, 0},
-    {Opcode::PUSH, 0},
-    {Opcode::MOV, 1},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 1},
-    {Opcode::POP, 0},
+    {Opcode::LOAD, 49156},
+    {Opcode::MOV_BX, 1},
     {Opcode::ADD},
-    {Opcode::PUSH, 0},
-    {Opcode::POP, 3},
-    {Opcode::NOP},
+    {Opcode::STORE, 49156},
     {Opcode::HLT},
-};
+}};
+constexpr std::array<int, 98> progSourceMap = {{
+    0, 0, 1, 1, 2, 2, 2, 2, 2, 2, 3, 3, 4, 4, 5, 5,
+    5, 5, 5, 5, 5, 5, 6, 6, 7, 7, 8, 8, 8, 8, 8, 8,
+    8, 8, 9, 9, 10, 10, 11, 11, 11, 11, 11, 11, 12, 12, 12, 12,
+    12, 12, 13, 13, 12, 14, 14, 15, 15, 15, 15, 15, 15, 16, 16, 15,
+    17, 17, 18, 18, 18, 18, 18, 18, 19, 19, 18, 20, 20, 21, 21, 23,
+    23, 24, 24, 24, 24, 23, 23, 24, 24, 24, 24, 23, 23, 24, 24, 24,
+    24, -1,
+}};
+constexpr uint16_t progDataAddress = 49152;
+constexpr std::array<uint8_t, 0> progData = {{
+}};
@@ -0,0 +1,317 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: range.cpp
+// Purpose:
+//   - Implements the interval analysis declared in range.h: an abstract run
+//     of the AST where every variable holds a range instead of a value.
+// =====================================================================================
+
+#include "range.h"
+#include <algorithm>
+
+namespace {
+
+    // Loop rounds computed exactly before growing bounds are widened
+    constexpr int WIDEN_AFTER = 2;
+
+    constexpr uint32_t MAX_VALUE = 0xFFFF;
+
+} // namespace
+
+// =====================================================================================
+// Function: run
+// Purpose: Analyzes the whole program, then records the proven divisions.
+// =====================================================================================
+void RangeAnalysis::run(Program& program) {
+    safeDivisions.clear();
+    safeIndexes.clear();
+    Env env;
+    analyzeBlock(program.statements, env);
+
+    for (const auto& [node, safe] : safeDivisions)
+        node->divisorNonZero = safe;
+    for (const auto& [flag, safe] : safeIndexes)
+        *flag = safe;
+}
+
+void RangeAnalysis::recordIndex(bool* inBounds, Range index, int size) {
+    bool safe = index.hi < size;
+    auto it = safeIndexes.find(inBounds);
+    if (it == safeIndexes.end()) safeIndexes[inBounds] = safe;
+    else it->second = it->second && safe;
+}
+
+void RangeAnalysis::analyzeBlock(const std::vector<StmtPtr>& stmts, Env& env) {
+    for (const auto& stmt : stmts) analyze(stmt, env);
+}
+
+// =====================================================================================
+// Function: analyze
+// Purpose: Applies one statement to `env`.
+// =====================================================================================
+void RangeAnalysis::analyze(const StmtPtr& stmt, Env& env) {
+    if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+        env[let->name] = {eval(let->value, env), true};
+    } else if (auto print = std::dynamic_pointer_cast<PrintStatement>(stmt)) {
+        eval(print->expr, env);
+    } else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt)) {
+        eval(store->value, env);
+        recordIndex(&store->inBounds, eval(store->index, env), store->size);
+    } else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+        eval(ifs->condition, env);
+        Env thenEnv = refine(ifs->condition, env, true);
+        Env elseEnv = refine(ifs->condition, env, false);
+        analyzeBlock(ifs->thenBranch, thenEnv);
+        analyzeBlock(ifs->elseBranch, elseEnv);
+        env = join(thenEnv, elseEnv);
+    } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+        // State at the condition: entry joined with the end of every iteration
+        Env head = env;
+        for (int round = 0;; ++round) {
+            eval(wh->condition, head);
+            Env body = refine(wh->condition, head, true);
+            analyzeBlock(wh->body, body);
+
+            Env next = join(env, body);
+            if (round >= WIDEN_AFTER) next = widen(head, next);
+            if (next == head) break;
+            head = next;
+        }
+        env = refine(wh->condition, head, false);
+    }
+}
+
+// =====================================================================================
+// Function: eval
+// Purpose:
+//   - Range of an expression under `env`, following the VM's 16-bit unsigned
+//     arithmetic. Anything that may wrap around becomes [0, 65535].
+// =====================================================================================
+RangeAnalysis::Range RangeAnalysis::eval(const ExprPtr& expr, const Env& env) {
+    const Range full = {0, static_cast<uint16_t>(MAX_VALUE)};
+
+    if (auto num = std::dynamic_pointer_cast<NumberExpr>(expr)) {
+        uint16_t v = static_cast<uint16_t>(num->value);
+        return {v, v};
+    }
+    if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr))
+        return read(env, var->name);
+
+    if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr)) {
+        recordIndex(&idx->inBounds, eval(idx->index, env), idx->size);
+        return full;
+    }
+
+    if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+        std::vector<Range> args;
+        for (const auto& arg : call->args) args.push_back(eval(arg, env));
+        if (args.size() != intrinsicArity(call->fn)) return full;
+
+        const uint16_t signBit = 0x8000;
+
+        switch (call->fn) {
+            case Intrinsic::Min:
+                return {std::min(args[0].lo, args[1].lo), std::min(args[0].hi, args[1].hi)};
+            case Intrinsic::Max:
+                return {std::max(args[0].lo, args[1].lo), std::max(args[0].hi, args[1].hi)};
+            case Intrinsic::Clamp: {
+                Range atLeast = {std::max(args[0].lo, args[1].lo), std::max(args[0].hi, args[1].hi)};
+                return {std::min(atLeast.lo, args[2].lo), std::min(atLeast.hi, args[2].hi)};
+            }
+            case Intrinsic::Abs:
+                if (args[0].hi < signBit) return args[0];                       // All non-negative
+                if (args[0].lo >= signBit)                                      // All negative
+                    return {static_cast<uint16_t>(-args[0].hi), static_cast<uint16_t>(-args[0].lo)};
+                return {0, signBit};                                            // -32768 stays 0x8000
+            case Intrinsic::Sign:
+                if (args[0].hi == 0) return {0, 0};
+                if (args[0].lo > 0 && args[0].hi < signBit) return {1, 1};
+                return full;
+            default:
+                return full;
+        }
+    }
+
+    auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr);
+    if (!bin) return full;
+
+    // The right operand of && / || runs only where the left one did not decide
+    if (bin->op == BinaryOp::And || bin->op == BinaryOp::Or) {
+        bool isAnd = bin->op == BinaryOp::And;
+        eval(bin->left, env);
+        eval(bin->right, refine(bin->left, env, isAnd));
+        return {0, 1};
+    }
+
+    Range l = eval(bin->left, env);
+    Range r = eval(bin->right, env);
+    auto make = [&](uint32_t lo, uint32_t hi) {
+        return hi > MAX_VALUE ? full : Range{static_cast<uint16_t>(lo), static_cast<uint16_t>(hi)};
+    };
+
+    switch (bin->op) {
+        case BinaryOp::Add:
+            return make(uint32_t(l.lo) + r.lo, uint32_t(l.hi) + r.hi);
+        case BinaryOp::Sub:
+            if (l.lo < r.hi) return full;  // May go below zero
+            return make(l.lo - r.hi, l.hi - r.lo);
+        case BinaryOp::Mul:
+            return make(uint32_t(l.lo) * r.lo, uint32_t(l.hi) * r.hi);
+
+        case BinaryOp::Div: {
+            bool safe = r.lo > 0;
+            auto it = safeDivisions.find(bin.get());
+            if (it == safeDivisions.end()) safeDivisions[bin.get()] = safe;
+            else it->second = it->second && safe;
+
+            if (r.hi == 0) return {0, 0};  // Always traps: nothing flows on
+            uint16_t divisorLo = std::max<uint16_t>(r.lo, 1);
+            return make(l.lo / r.hi, l.hi / divisorLo);
+        }
+
+        case BinaryOp::Equal:
+            if (l.lo == l.hi && l == r) return {1, 1};
+            if (l.hi < r.lo || r.hi < l.lo) return {0, 0};
+            return {0, 1};
+        case BinaryOp::Greater:
+            if (l.lo > r.hi) return {1, 1};
+            if (l.hi <= r.lo) return {0, 0};
+            return {0, 1};
+        case BinaryOp::Less:
+            if (l.hi < r.lo) return {1, 1};
+            if (l.lo >= r.hi) return {0, 0};
+            return {0, 1};
+
+        // Shift amounts are constants (see ast.h)
+        case BinaryOp::Shl:
+            if (r.lo >= 16) return {0, 0};
+            return make(uint32_t(l.lo) << r.lo, uint32_t(l.hi) << r.lo);
+        case BinaryOp::Shr:
+            if (r.lo >= 16) return {0, 0};
+            return make(l.lo >> r.lo, l.hi >> r.lo);
+
+        default:
+            return full;
+    }
+}
+
+// =====================================================================================
+// Function: refine
+// Purpose:
+//   - Handles conditions of the form `x`, `x op e` and `e op x` (op is <, >
+//     or ==), combined with && and ||. A bound that contradicts what is known means the branch cannot
+//     run; the variable is then left as it was, which is still sound.
+// =====================================================================================
+RangeAnalysis::Env RangeAnalysis::refine(const ExprPtr& cond, const Env& env, bool whenTrue) {
+    Env out = env;
+
+    auto narrow = [&](const std::string& name, uint32_t lo, uint32_t hi) {
+        Range cur = read(out, name);
+        uint32_t newLo = std::max<uint32_t>(cur.lo, lo);
+        uint32_t newHi = std::min<uint32_t>(cur.hi, hi);
+        if (newLo > newHi) return;
+        out[name] = {{static_cast<uint16_t>(newLo), static_cast<uint16_t>(newHi)}, true};
+    };
+
+    if (auto var = std::dynamic_pointer_cast<VariableExpr>(cond)) {
+        if (whenTrue) narrow(var->name, 1, MAX_VALUE);
+        else narrow(var->name, 0, 0);
+        return out;
+    }
+
+    auto bin = std::dynamic_pointer_cast<BinaryExpr>(cond);
+    if (!bin) return out;
+
+    // a && b is true when both are; false when a is, or a is true and b is not
+    // (and the mirror image for ||)
+    if (bin->op == BinaryOp::And || bin->op == BinaryOp::Or) {
+        bool isAnd = bin->op == BinaryOp::And;
+        Env leftDecides = refine(bin->left, env, !isAnd);
+        Env bothRun = refine(bin->right, refine(bin->left, env, isAnd), whenTrue);
+        return whenTrue == isAnd ? bothRun : join(leftDecides, bothRun);
+    }
+
+    // `x op e`, with `e op x` flipped to the same shape
+    auto constrain = [&](const ExprPtr& side, BinaryOp op, const ExprPtr& other) {
+        auto var = std::dynamic_pointer_cast<VariableExpr>(side);
+        if (!var) return;
+        Range e = eval(other, env);
+
+        if (op == BinaryOp::Less) {
+            if (whenTrue) {
+                if (e.hi > 0) narrow(var->name, 0, e.hi - 1u);
+            } else {
+                narrow(var->name, e.lo, MAX_VALUE);
+            }
+        } else if (op == BinaryOp::Greater) {
+            if (whenTrue) {
+                if (e.lo < MAX_VALUE) narrow(var->name, e.lo + 1u, MAX_VALUE);
+            } else {
+                narrow(var->name, 0, e.hi);
+            }
+        } else if (op == BinaryOp::Equal) {
+            if (whenTrue) {
+                narrow(var->name, e.lo, e.hi);
+            } else if (e.lo == e.hi) {
+                // x != c only helps when c sits on one end of x's range
+                Range cur = read(out, var->name);
+                if (cur.lo == e.lo && cur.hi > e.lo) narrow(var->name, e.lo + 1u, MAX_VALUE);
+                else if (cur.hi == e.lo && cur.lo < e.lo) narrow(var->name, 0, e.lo - 1u);
+            }
+        }
+    };
+
+    BinaryOp flipped = bin->op;
+    if (bin->op == BinaryOp::Less) flipped = BinaryOp::Greater;
+    else if (bin->op == BinaryOp::Greater) flipped = BinaryOp::Less;
+    else if (bin->op != BinaryOp::Equal) return out;
+
+    constrain(bin->left, bin->op, bin->right);
+    constrain(bin->right, flipped, bin->left);
+    return out;
+}
+
+// -------------------------------------------------------------------------------------
+// read: a variable not written on every path may still hold (or read as) 0
+// -------------------------------------------------------------------------------------
+RangeAnalysis::Range RangeAnalysis::read(const Env& env, const std::string& name) {
+    auto it = env.find(name);
+    if (it == env.end()) return {0, 0};
+    Range r = it->second.range;
+    if (!it->second.assigned) r.lo = 0;
+    return r;
+}
+
+// -------------------------------------------------------------------------------------
+// join: the state after either of two paths
+// -------------------------------------------------------------------------------------
+RangeAnalysis::Env RangeAnalysis::join(const Env& a, const Env& b) {
+    Env out;
+    auto merge = [&](const std::string& name) {
+        auto ia = a.find(name), ib = b.find(name);
+        Value va = ia != a.end() ? ia->second : Value{};
+        Value vb = ib != b.end() ? ib->second : Value{};
+        out[name] = {{std::min(va.range.lo, vb.range.lo), std::max(va.range.hi, vb.range.hi)},
+                     va.assigned && vb.assigned};
+    };
+    for (const auto& [name, value] : a) merge(name);
+    for (const auto& [name, value] : b) merge(name);
+    return out;
+}
+
+// -------------------------------------------------------------------------------------
+// widen: bounds that moved since the last round jump to their limit
+// -------------------------------------------------------------------------------------
+RangeAnalysis::Env RangeAnalysis::widen(const Env& before, const Env& after) {
+    Env out = after;
+    for (auto& [name, value] : out) {
+        auto it = before.find(name);
+        Value old = it != before.end() ? it->second : Value{};
+        value.range.lo = value.range.lo < old.range.lo ? 0 : old.range.lo;
+        value.range.hi = value.range.hi > old.range.hi ? static_cast<uint16_t>(MAX_VALUE) : old.range.hi;
+        value.assigned = value.assigned && old.assigned;
+    }
+    return out;
+}
@@ -0,0 +1,87 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: range.h
+// Purpose:
+//   - Declares the value-range analysis pass. Every variable gets an interval
+//     [lo, hi] of the 16-bit unsigned values it can hold at each point of the
+//     program; a division whose divisor interval excludes 0 can never trap,
+//     so Codegen emits it as DIV_NC (no zero check in the VM), and an array
+//     index whose interval stays below the array size needs no CHK.
+//
+// How ranges flow:
+//   → letbro x = e;        x takes the range of e (wrapping arithmetic → [0, 65535])
+//   → ifbro (x > e)        the then branch knows x >= lo(e) + 1, the else branch x <= hi(e);
+//                          the two results are joined afterwards
+//   → whilebro             iterated to a fixed point; bounds still growing after
+//                          a few rounds are widened to 0 / 65535
+//   → Array elements are not tracked: reading one gives [0, 65535]
+//   → A variable not assigned on every path so far may still read 0 (its slot
+//     starts at zero, and Codegen loads 0 for names it has not seen declared).
+//
+// Example:
+//   letbro i = 1;
+//   whilebro (i < 100) {
+//       printbro(n / i);      i in [1, 99]: DIV_NC
+//       printbro(n / (i - 1));   may be 0: DIV
+//       letbro i = i + 1;
+//   }
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// =====================================================================================
+// Class: RangeAnalysis
+// Purpose:
+//   - Runs last among the AST passes (it describes the tree Codegen will see)
+//     and sets BinaryExpr::divisorNonZero on every Div it proves safe, and
+//     IndexExpr / ArrayStoreStatement::inBounds on every access it proves.
+//
+// Usage:
+//   RangeAnalysis ranges;
+//   ranges.run(program);
+// =====================================================================================
+class RangeAnalysis {
+public:
+    void run(Program& program);
+
+private:
+    struct Range {
+        uint16_t lo = 0;
+        uint16_t hi = 0;
+        bool operator==(const Range& o) const { return lo == o.lo && hi == o.hi; }
+    };
+
+    struct Value {
+        Range range;
+        bool assigned = false;  // Written on every path to this point
+        bool operator==(const Value& o) const { return range == o.range && assigned == o.assigned; }
+    };
+
+    using Env = std::map<std::string, Value>;
+
+    void analyzeBlock(const std::vector<StmtPtr>& stmts, Env& env);
+    void analyze(const StmtPtr& stmt, Env& env);
+    Range eval(const ExprPtr& expr, const Env& env);
+
+    // Narrows `env` to the states where `cond` is true (or false)
+    Env refine(const ExprPtr& cond, const Env& env, bool whenTrue);
+
+    static Range read(const Env& env, const std::string& name);
+    static Env join(const Env& a, const Env& b);
+    static Env widen(const Env& before, const Env& after);
+
+    // Per Div node: true while every visit proved its divisor non-zero
+    std::map<BinaryExpr*, bool> safeDivisions;
+
+    // Per array access: true while every visit proved its index below the size
+    void recordIndex(bool* inBounds, Range index, int size);
+    std::map<bool*, bool> safeIndexes;
+};
@@ -0,0 +1,245 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: strength.cpp
+// Purpose:
+//   - Implements strength reduction and induction-variable rewriting.
+//
+// Terminology:
+//   - A basic induction variable `i` of a loop is assigned exactly once in the
+//     loop, by a top-level `letbro i = i + c;` (or `i - c`) with a constant c.
+//   - A derived expression is any expression equal to a*i + b for constants
+//     a != 0 and b, built from i, constants, +, -, * and <<. All arithmetic is
+//     modulo 2^16, exactly like the VM, so the running-sum rewrite is exact
+//     even when values wrap.
+// =====================================================================================
+
+#include "strength.h"
+#include "astutils.h"
+#include <map>
+
+namespace {
+
+    // Cost of `letbro __ivN = __ivN + step;` (LOAD, MOV_BX, ADD, STORE)
+    constexpr int UPDATE_COST = 4;
+
+    // Returns n if value == 2^n (n >= 1), otherwise -1
+    int log2Exact(int value) {
+        uint16_t v = static_cast<uint16_t>(value);
+        if (v < 2 || (v & (v - 1)) != 0) return -1;
+        int n = 0;
+        while (v > 1) { v >>= 1; n++; }
+        return n;
+    }
+
+    // ---------------------------------------------------------------------------------
+    // affine: if `expr` == a*iv + b (mod 2^16) for constants a, b, store them
+    // ---------------------------------------------------------------------------------
+    bool affine(const ExprPtr& expr, const std::string& iv, uint16_t& a, uint16_t& b) {
+        if (auto num = std::dynamic_pointer_cast<NumberExpr>(expr)) {
+            a = 0;
+            b = static_cast<uint16_t>(num->value);
+            return true;
+        }
+        if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr)) {
+            if (var->name != iv) return false;
+            a = 1;
+            b = 0;
+            return true;
+        }
+
+        auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr);
+        if (!bin) return false;
+
+        uint16_t la, lb, ra, rb;
+        if (!affine(bin->left, iv, la, lb) || !affine(bin->right, iv, ra, rb)) return false;
+
+        switch (bin->op) {
+            case BinaryOp::Add: a = la + ra; b = lb + rb; return true;
+            case BinaryOp::Sub: a = la - ra; b = lb - rb; return true;
+            case BinaryOp::Mul:
+                if (ra == 0)      { a = la * rb; b = lb * rb; return true; }
+                if (la == 0)      { a = ra * lb; b = rb * lb; return true; }
+                return false;  // i * i is not linear
+            case BinaryOp::Shl:
+                if (ra != 0 || rb >= 16) return false;
+                a = la << rb;
+                b = lb << rb;
+                return true;
+            default:
+                return false;  // Division and comparisons do not distribute
+        }
+    }
+
+    // ---------------------------------------------------------------------------------
+    // findDerived: collect maximal derived sub-expressions, grouped by the
+    // coefficient a; each entry remembers the slot and its offset b
+    // ---------------------------------------------------------------------------------
+    using DerivedGroups = std::map<uint16_t, std::vector<std::pair<ExprPtr*, uint16_t>>>;
+
+    void findDerived(ExprPtr& slot, const std::string& iv, DerivedGroups& groups) {
+        if (auto idx = std::dynamic_pointer_cast<IndexExpr>(slot)) {
+            findDerived(idx->index, iv, groups);
+            return;
+        }
+        if (auto call = std::dynamic_pointer_cast<CallExpr>(slot)) {
+            for (auto& arg : call->args) findDerived(arg, iv, groups);
+            return;
+        }
+
+        auto bin = std::dynamic_pointer_cast<BinaryExpr>(slot);
+        if (!bin) return;
+
+        uint16_t a, b;
+        if (affine(slot, iv, a, b) && a != 0) {
+            groups[a].push_back({&slot, b});
+            return;
+        }
+        findDerived(bin->left, iv, groups);
+        findDerived(bin->right, iv, groups);
+    }
+
+} // namespace
+
+// =====================================================================================
+// Function: run
+// Purpose: Shift rewriting over the whole program, then per-loop IV rewriting.
+// =====================================================================================
+void StrengthReduction::run(Program& program) {
+    tempCounter = 0;
+    AstUtils::forEachExpr(program.statements, [&](ExprPtr& e) { e = reduceShifts(e); });
+    processBlock(program.statements);
+}
+
+// =====================================================================================
+// Function: reduceShifts
+// Purpose:
+//   - x * 2^n → x << n,  2^n * x → x << n,  x / 2^n → x >> n  (unsigned, exact)
+//   - x * 1 and x / 1 → x
+// =====================================================================================
+ExprPtr StrengthReduction::reduceShifts(const ExprPtr& expr) {
+    if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr)) {
+        idx->index = reduceShifts(idx->index);
+        return expr;
+    }
+    if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+        for (auto& arg : call->args) arg = reduceShifts(arg);
+        return expr;
+    }
+
+    auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr);
+    if (!bin) return expr;
+
+    bin->left = reduceShifts(bin->left);
+    bin->right = reduceShifts(bin->right);
+
+    auto lnum = std::dynamic_pointer_cast<NumberExpr>(bin->left);
+    auto rnum = std::dynamic_pointer_cast<NumberExpr>(bin->right);
+
+    if (bin->op == BinaryOp::Mul || bin->op == BinaryOp::Div) {
+        if (rnum && static_cast<uint16_t>(rnum->value) == 1) return bin->left;
+
+        int n = rnum ? log2Exact(rnum->value) : -1;
+        if (n > 0) {
+            BinaryOp shift = bin->op == BinaryOp::Mul ? BinaryOp::Shl : BinaryOp::Shr;
+            return std::make_shared<BinaryExpr>(shift, bin->left, std::make_shared<NumberExpr>(n));
+        }
+    }
+
+    if (bin->op == BinaryOp::Mul && lnum) {
+        if (static_cast<uint16_t>(lnum->value) == 1) return bin->right;
+
+        int n = log2Exact(lnum->value);
+        if (n > 0)
+            return std::make_shared<BinaryExpr>(BinaryOp::Shl, bin->right, std::make_shared<NumberExpr>(n));
+    }
+
+    return expr;
+}
+
+// =====================================================================================
+// Function: processBlock
+// Purpose: Visits every whilebro (inner loops first) and inserts IV preheaders.
+// =====================================================================================
+void StrengthReduction::processBlock(std::vector<StmtPtr>& block) {
+    std::vector<StmtPtr> out;
+
+    for (auto& stmt : block) {
+        if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+            processBlock(ifs->thenBranch);
+            processBlock(ifs->elseBranch);
+        }
+        else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+            processBlock(wh->body);
+
+            std::vector<StmtPtr> preheader;
+            reduceInductionVariables(*wh, preheader);
+            out.insert(out.end(), preheader.begin(), preheader.end());
+        }
+        out.push_back(stmt);
+    }
+
+    block = std::move(out);
+}
+
+// =====================================================================================
+// Function: reduceInductionVariables
+// Purpose:
+//   - For each basic induction variable i (step c), groups derived expressions
+//     a*i + b by their coefficient a and, when the group is used often enough
+//     to pay for the update, replaces each use with `__ivN + b`:
+//         preheader:  letbro __ivN = i * a;
+//         after i++:  letbro __ivN = __ivN + a*c;
+// =====================================================================================
+void StrengthReduction::reduceInductionVariables(WhileStatement& loop, std::vector<StmtPtr>& preheader) {
+    std::map<std::string, int> assignments;
+    AstUtils::countAssigned(loop.body, assignments);
+
+    for (size_t idx = 0; idx < loop.body.size(); ++idx) {
+        std::string iv;
+        uint16_t step;
+        if (!AstUtils::matchIncrement(loop.body[idx], iv, step) || assignments[iv] != 1) continue;
+
+        auto inc = std::static_pointer_cast<LetStatement>(loop.body[idx]);
+
+        // Gather derived expressions from the condition and body (the increment
+        // itself is left alone)
+        DerivedGroups groups;
+        findDerived(loop.condition, iv, groups);
+        AstUtils::forEachExpr(loop.body, [&](ExprPtr& e) {
+            if (&e != &inc->value) findDerived(e, iv, groups);
+        });
+
+        std::vector<StmtPtr> updates;
+        for (auto& [coeff, uses] : groups) {
+            // Each use becomes `__ivN` (1 instruction) or `__ivN + b` (3)
+            int saved = 0;
+            for (auto& [slot, offset] : uses)
+                saved += AstUtils::estimateCost(*slot) - (offset == 0 ? 1 : 3);
+            if (saved <= UPDATE_COST) continue;  // Not used enough to pay for the update
+
+            std::string name = "__iv" + std::to_string(tempCounter++);
+            ExprPtr init = std::make_shared<BinaryExpr>(BinaryOp::Mul,
+                std::make_shared<VariableExpr>(iv), std::make_shared<NumberExpr>(coeff));
+            preheader.push_back(std::make_shared<LetStatement>(name, reduceShifts(init)));
+
+            for (auto& [slot, offset] : uses) {
+                ExprPtr value = std::make_shared<VariableExpr>(name);
+                if (offset != 0)
+                    value = std::make_shared<BinaryExpr>(BinaryOp::Add, value,
+                                                         std::make_shared<NumberExpr>(offset));
+                *slot = value;
+            }
+
+            uint16_t delta = static_cast<uint16_t>(coeff * step);
+            updates.push_back(std::make_shared<LetStatement>(name,
+                std::make_shared<BinaryExpr>(BinaryOp::Add,
+                    std::make_shared<VariableExpr>(name),
+                    std::make_shared<NumberExpr>(delta))));
+        }
+
+        loop.body.insert(loop.body.begin() + idx + 1, updates.begin(), updates.end());
+        idx += updates.size();
+    }
+}
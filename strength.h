@@ -0,0 +1,56 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: strength.h
+// Purpose:
+//   - Declares the strength-reduction pass, which replaces expensive operations
+//     with cheaper equivalents:
+//       → x * 2^n and x / 2^n become single SHL/SHR instructions.
+//       → Linear functions of a loop counter (`i * 3 + 1`) become a temporary
+//         that is bumped by a constant whenever the counter is, so the loop
+//         body runs an ADD per iteration instead of re-evaluating the product.
+//
+// Example:
+//   whilebro (i < 10) {                 letbro __iv0 = i * 3;
+//       printbro(i * 3);        ==>     whilebro (i < 10) {
+//       printbro(i * 3 + 1);                printbro(__iv0);
+//       printbro(i * 3 - 1);                printbro(__iv0 + 1);
+//       letbro i = i + 1;                   printbro(__iv0 + 65535);
+//   }                                       letbro i = i + 1;
+//                                           letbro __iv0 = __iv0 + 3;
+//                                       }
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// =====================================================================================
+// Class: StrengthReduction
+// Purpose:
+//   - Rewrites the AST in place. Shifts are introduced everywhere; induction
+//     variable rewrites are applied per whilebro when the cost model says the
+//     per-iteration update is cheaper than the expressions it replaces.
+// =====================================================================================
+class StrengthReduction {
+public:
+    // Rewrites `program` in place
+    void run(Program& program);
+
+private:
+    // Replaces multiply/divide by a power of two with shifts (recursive)
+    ExprPtr reduceShifts(const ExprPtr& expr);
+
+    // Processes one statement list, visiting inner loops first
+    void processBlock(std::vector<StmtPtr>& block);
+
+    // Rewrites expressions derived from basic induction variables of `loop`;
+    // initializations for the new temporaries are appended to `preheader`.
+    void reduceInductionVariables(WhileStatement& loop, std::vector<StmtPtr>& preheader);
+
+    int tempCounter = 0;  // Used to create unique temporary names
+};
@@ -0,0 +1,126 @@
+#!/bin/sh
+# ===================================================================================
+# Made by: Rohit Yadav
+# NIT Jalandhar
+#
+# File: tests/run_tests.sh
+# Purpose:
+#   - Regression check for the optimizer: every tests/*.bro is compiled and run
+#     at -O0 and with the default (full) optimization through brobatch, and
+#     each program's output must equal tests/<name>.expected at both levels.
+#     The fault_* programs stop with a VM error; the error line is part of
+#     their expected output.
+#   - The corpus is also compiled by broc to `.brobin` images with the default
+#     optimization (so with DIV_NC / PUSH_NC / POP_NC) and run by brod, which
+#     must give the same output; the fault_* programs end with status fault.
+#   - bench_loops.bro is the loop-heavy benchmark: its instruction counts at
+#     both levels are printed at the end.
+#
+# Usage (from the repository root):
+#   sh tests/run_tests.sh              Builds the tools into a temporary directory
+#   BROBATCH=./brobatch BROC=./broc BROD=./brod BROCALL=./brocall sh tests/run_tests.sh
+# ===================================================================================
+
+cd "$(dirname "$0")/.." || exit 1
+work=$(mktemp -d) || exit 1
+brodPid=
+trap '[ -n "$brodPid" ] && kill "$brodPid"; rm -rf "$work"' EXIT
+
+brobatch=${BROBATCH:-}
+if [ -z "$brobatch" ]; then
+    brobatch=$work/brobatch
+    echo "Building brobatch..."
+    g++ -O2 brobatch.cpp brovm.cpp lexer.cpp parser.cpp astutils.cpp licm.cpp strength.cpp cse.cpp unroll.cpp evaluator.cpp jumpthread.cpp cfg.cpp blocklayout.cpp range.cpp boundscheck.cpp optimizer.cpp profile.cpp codegen.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp -pthread -o "$brobatch" || exit 1
+fi
+
+failed=0
+for level in O0 O; do
+    flag=
+    [ "$level" = O0 ] && flag=-O0
+    "$brobatch" tests -j1 $flag --out-dir="$work/$level" > "$work/$level.summary"
+
+    # brobatch names its outputs <n>_<name>.out
+    for actual in "$work/$level"/*.out; do
+        name=$(basename "$actual" .out)
+        name=${name#*_}
+        expected=tests/$name.expected
+        if [ -f "$expected" ] && cmp -s "$expected" "$actual"; then
+            echo "PASS -$level $name"
+        else
+            echo "FAIL -$level $name"
+            [ -f "$expected" ] && diff "$expected" "$actual" | head -20
+            failed=$((failed + 1))
+        fi
+    done
+done
+
+# A fault on the last instruction the limit allows is a fault, not the limit
+count=$(awk '/tests\/fault_divide.bro$/ { print $2 }' "$work/O0.summary")
+if "$brobatch" tests/fault_divide.bro -j1 -O0 --limit="$count" | grep -q '^fault .*fault_divide.bro$'; then
+    echo "PASS limit fault_divide"
+else
+    echo "FAIL limit fault_divide (reported as the instruction limit)"
+    failed=$((failed + 1))
+fi
+
+# --- Default broc images, run by brod ---
+broc=${BROC:-}
+if [ -z "$broc" ]; then
+    broc=$work/broc
+    echo "Building broc..."
+    g++ -O2 broc.cpp lexer.cpp parser.cpp astutils.cpp licm.cpp strength.cpp cse.cpp unroll.cpp evaluator.cpp jumpthread.cpp cfg.cpp blocklayout.cpp range.cpp boundscheck.cpp optimizer.cpp profile.cpp codegen.cpp emitter.cpp brobin.cpp broobj.cpp x86backend.cpp -o "$broc" || exit 1
+fi
+brod=${BROD:-}
+if [ -z "$brod" ]; then
+    brod=$work/brod
+    echo "Building brod..."
+    g++ -O2 brod.cpp broservice.cpp brovm.cpp lexer.cpp parser.cpp astutils.cpp licm.cpp strength.cpp cse.cpp unroll.cpp evaluator.cpp jumpthread.cpp cfg.cpp blocklayout.cpp range.cpp boundscheck.cpp optimizer.cpp profile.cpp codegen.cpp RohitVM.cpp RohitUtils.cpp brobin.cpp -pthread -o "$brod" || exit 1
+fi
+brocall=${BROCALL:-}
+if [ -z "$brocall" ]; then
+    brocall=$work/brocall
+    g++ -O2 brocall.cpp broservice.cpp -pthread -o "$brocall" || exit 1
+fi
+
+socket=$work/brod.sock
+"$brod" --socket="$socket" -j2 --report=0 2> "$work/brod.log" &
+brodPid=$!
+tries=0
+while [ ! -S "$socket" ] && [ "$tries" -lt 50 ]; do
+    sleep 0.1
+    tries=$((tries + 1))
+done
+
+for source in tests/*.bro; do
+    name=$(basename "$source" .bro)
+    expected=tests/$name.expected
+    "$broc" "$source" -o "$work/$name.brobin" > /dev/null || { echo "FAIL brod $name (broc)"; failed=$((failed + 1)); continue; }
+    "$brocall" "$work/$name.brobin" --socket="$socket" > "$work/$name.brod.out" 2> "$work/$name.brod.err"
+    status=$?
+
+    # brod reports a fault in the end frame, not in the output
+    grep -v '^VM Error:' "$expected" > "$work/$name.brod.expected"
+    wantStatus=0
+    grep -q '^VM Error:' "$expected" && wantStatus=1   # brocall exits 0 only if the program halted
+    if cmp -s "$work/$name.brod.expected" "$work/$name.brod.out" && [ "$status" -eq "$wantStatus" ]; then
+        echo "PASS brod $name"
+    else
+        echo "FAIL brod $name"
+        diff "$work/$name.brod.expected" "$work/$name.brod.out" | head -20
+        cat "$work/$name.brod.err"
+        failed=$((failed + 1))
+    fi
+done
+
+echo
+echo "bench_loops.bro instructions:"
+for level in O0 O; do
+    count=$(awk '/tests\/bench_loops.bro$/ { print $2 }' "$work/$level.summary")
+    echo "  -$level  $count"
+done
+
+if [ "$failed" -ne 0 ]; then
+    echo "$failed failed"
+    exit 1
+fi
+echo "All tests passed"
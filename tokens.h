@@ -22,6 +22,7 @@ enum class TokenType {
     // Identifiers & Literals
     Identifier,    // Variable names
     Number,        // Numeric literals
+    String,        // String literals (text holds the decoded bytes)
 
     // Operators
     Plus,          // +
@@ -32,13 +33,19 @@ enum class TokenType {
     Equal,         // ==
     Greater,       // >
     Less,          // <
+    AndAnd,        // &&
+    OrOr,          // ||
+    Bang,          // !
 
     // Symbols / Punctuation
     Semicolon,     // ;
+    Comma,         // ,
     LParen,        // (
     RParen,        // )
     LBrace,        // {
-    RBrace         // }
+    RBrace,        // }
+    LBracket,      // [
+    RBracket       // ]
 };
 
 // ===================================================================
@@ -59,6 +66,7 @@ inline std::string tokenTypeToString(TokenType type) {
         // Identifiers & Literals
         case TokenType::Identifier:  return "Identifier";
         case TokenType::Number:      return "Number";
+        case TokenType::String:      return "String";
 
         // Operators
         case TokenType::Plus:        return "+";
@@ -69,13 +77,19 @@ inline std::string tokenTypeToString(TokenType type) {
         case TokenType::Equal:       return "==";
         case TokenType::Greater:     return ">";
         case TokenType::Less:        return "<";
+        case TokenType::AndAnd:      return "&&";
+        case TokenType::OrOr:        return "||";
+        case TokenType::Bang:        return "!";
 
         // Symbols
         case TokenType::Semicolon:   return ";";
+        case TokenType::Comma:       return ",";
         case TokenType::LParen:      return "(";
         case TokenType::RParen:      return ")";
         case TokenType::LBrace:      return "{";
         case TokenType::RBrace:      return "}";
+        case TokenType::LBracket:    return "[";
+        case TokenType::RBracket:    return "]";
 
         default:                     return "Unknown";
     }
@@ -0,0 +1,211 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: unroll.cpp
+// Purpose:
+//   - Implements full and partial unrolling of constant-trip `whilebro` loops.
+//
+// Why partial unrolling is exact here:
+//   - The counter advances by the same constant every iteration and nothing else
+//     writes it, so the condition is true for the first `trips` checks and false
+//     afterwards. Peeling `trips % factor` iterations leaves a multiple of
+//     `factor`, and the condition is only ever checked at multiples of `factor`.
+// =====================================================================================
+
+#include "unroll.h"
+#include "astutils.h"
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace {
+
+    // Full unrolling limits: at most this many trips, and at most this many
+    // instructions in the unrolled result
+    constexpr long FULL_UNROLL_MAX_TRIPS = 16;
+    constexpr long FULL_UNROLL_MAX_INSTRUCTIONS = 256;
+
+    // Longest loop whose counter we are willing to simulate
+    constexpr long MAX_SIMULATED_TRIPS = 65536;
+
+    // With a profile: loops whose condition held at least this often are hot,
+    // and get at least this many body copies
+    constexpr uint64_t HOT_LOOP_ITERATIONS = 1000;
+    constexpr int HOT_UNROLL_FACTOR = 8;
+
+    // Largest encoding Codegen uses (opcode + 16-bit operand); turns instruction
+    // estimates into a safe upper bound in bytes
+    constexpr int BYTES_PER_INSTRUCTION = 3;
+
+    // Evaluates `lhs op rhs` like the VM's EQ/GT/LT
+    bool compare(BinaryOp op, uint16_t lhs, uint16_t rhs) {
+        switch (op) {
+            case BinaryOp::Equal:   return lhs == rhs;
+            case BinaryOp::Greater: return lhs > rhs;
+            case BinaryOp::Less:    return lhs < rhs;
+            default:                return false;
+        }
+    }
+
+} // namespace
+
+LoopUnroller::LoopUnroller(int factor, int codeBudget, const Profile* profile)
+    : factor(factor), codeBudget(codeBudget), profile(profile) {}
+
+// =====================================================================================
+// Function: run
+// Purpose: Estimates the current program size, then unrolls what fits.
+// =====================================================================================
+void LoopUnroller::run(Program& program) {
+    codeSize = (AstUtils::estimateBlockCost(program.statements) + 1) * BYTES_PER_INSTRUCTION;  // + HLT
+    processBlock(program.statements);
+}
+
+// =====================================================================================
+// Function: processBlock
+// Purpose:
+//   - Rebuilds `block`, replacing each unrollable whilebro with its unrolled form.
+//   - Inner loops are unrolled first, so a small inner loop disappears before its
+//     enclosing loop's body size is measured.
+// =====================================================================================
+void LoopUnroller::processBlock(std::vector<StmtPtr>& block) {
+    std::vector<StmtPtr> out;
+
+    for (auto& stmt : block) {
+        if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+            processBlock(ifs->thenBranch);
+            processBlock(ifs->elseBranch);
+            out.push_back(stmt);
+            continue;
+        }
+
+        auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt);
+        if (!wh) {
+            out.push_back(stmt);
+            continue;
+        }
+
+        // Never ran in the profiled run: unrolling would only cost space
+        const BranchProfile* counts = profile ? profile->branch(wh->id) : nullptr;
+        if (counts && counts->checks == 0) {
+            out.push_back(stmt);
+            continue;
+        }
+
+        int loopFactor = factor;
+        if (counts && counts->trueCount >= HOT_LOOP_ITERATIONS && factor >= 2)
+            loopFactor = std::max(factor, HOT_UNROLL_FACTOR);
+
+        processBlock(wh->body);
+
+        long trips = tripCount(out, *wh);
+        long body = AstUtils::estimateBlockCost(wh->body);
+        long loopOverhead = AstUtils::estimateCost(wh->condition) + 2;  // cond, JZ, JMP
+
+        // ---------------- Full unroll ----------------
+        if (trips >= 0 && trips <= FULL_UNROLL_MAX_TRIPS &&
+            trips * body <= FULL_UNROLL_MAX_INSTRUCTIONS) {
+            long growth = (trips * body - body - loopOverhead) * BYTES_PER_INSTRUCTION;
+            if (codeSize + growth <= codeBudget) {
+                for (long t = 0; t < trips; ++t) {
+                    auto copy = AstUtils::cloneBlock(wh->body);
+                    out.insert(out.end(), copy.begin(), copy.end());
+                }
+                codeSize += growth;
+                continue;
+            }
+        }
+
+        // ---------------- Partial unroll ----------------
+        if (trips >= 2L * loopFactor && loopFactor >= 2) {
+            long remainder = trips % loopFactor;
+            long growth = (remainder + loopFactor - 1) * body * BYTES_PER_INSTRUCTION;
+            if (codeSize + growth <= codeBudget) {
+                for (long t = 0; t < remainder; ++t) {
+                    auto copy = AstUtils::cloneBlock(wh->body);
+                    out.insert(out.end(), copy.begin(), copy.end());
+                }
+
+                std::vector<StmtPtr> unrolled;
+                for (int f = 0; f < loopFactor; ++f) {
+                    auto copy = AstUtils::cloneBlock(wh->body);
+                    unrolled.insert(unrolled.end(), copy.begin(), copy.end());
+                }
+                wh->body = std::move(unrolled);
+                codeSize += growth;
+            }
+        }
+
+        out.push_back(stmt);
+    }
+
+    block = std::move(out);
+}
+
+// =====================================================================================
+// Function: tripCount
+// Purpose:
+//   - Matches the counter pattern described in unroll.h and simulates the
+//     counter to count how many times the body runs.
+// =====================================================================================
+long LoopUnroller::tripCount(const std::vector<StmtPtr>& preceding, const WhileStatement& loop) {
+    // Condition: counter compared with a constant
+    auto cond = std::dynamic_pointer_cast<BinaryExpr>(loop.condition);
+    if (!cond || (cond->op != BinaryOp::Less && cond->op != BinaryOp::Greater &&
+                  cond->op != BinaryOp::Equal))
+        return -1;
+
+    auto lvar = std::dynamic_pointer_cast<VariableExpr>(cond->left);
+    auto rvar = std::dynamic_pointer_cast<VariableExpr>(cond->right);
+    auto lnum = std::dynamic_pointer_cast<NumberExpr>(cond->left);
+    auto rnum = std::dynamic_pointer_cast<NumberExpr>(cond->right);
+
+    bool counterOnLeft = lvar && rnum;
+    if (!counterOnLeft && !(lnum && rvar)) return -1;
+
+    std::string counter = counterOnLeft ? lvar->name : rvar->name;
+    uint16_t limit = static_cast<uint16_t>(counterOnLeft ? rnum->value : lnum->value);
+
+    // Body: exactly one top-level `letbro counter = counter +/- step;`
+    std::map<std::string, int> assignments;
+    AstUtils::countAssigned(loop.body, assignments);
+    if (assignments[counter] != 1) return -1;
+
+    uint16_t step = 0;
+    bool found = false;
+    for (const auto& stmt : loop.body) {
+        std::string name;
+        uint16_t s;
+        if (AstUtils::matchIncrement(stmt, name, s) && name == counter) {
+            step = s;
+            found = true;
+        }
+    }
+    if (!found) return -1;
+
+    // Initial value: the last statement before the loop that writes the counter
+    // must be `letbro counter = <number>;`
+    long start = -1;
+    for (auto it = preceding.rbegin(); it != preceding.rend(); ++it) {
+        if (auto let = std::dynamic_pointer_cast<LetStatement>(*it); let && let->name == counter) {
+            if (auto num = std::dynamic_pointer_cast<NumberExpr>(let->value))
+                start = static_cast<uint16_t>(num->value);
+            break;
+        }
+
+        std::set<std::string> written;
+        AstUtils::collectAssigned({*it}, written);
+        if (written.count(counter)) return -1;
+    }
+    if (start < 0) return -1;
+
+    // Run the counter
+    uint16_t value = static_cast<uint16_t>(start);
+    long trips = 0;
+    while (counterOnLeft ? compare(cond->op, value, limit) : compare(cond->op, limit, value)) {
+        if (++trips > MAX_SIMULATED_TRIPS) return -1;
+        value = static_cast<uint16_t>(value + step);
+    }
+    return trips;
+}
@@ -0,0 +1,69 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: unroll.h
+// Purpose:
+//   - Declares the loop unrolling pass for `whilebro` loops whose trip count is
+//     known at compile time.
+//   - Small loops are unrolled completely (no compare, no branch, no jump left);
+//     larger ones run `factor` copies of the body per compare-and-branch.
+//
+// Example (full unroll):
+//   letbro counter = 0;                 letbro counter = 0;
+//   whilebro (counter < 3) {    ==>     printbro(counter);
+//       printbro(counter);              letbro counter = counter + 1;
+//       letbro counter = counter + 1;   printbro(counter);
+//   }                                   letbro counter = counter + 1;
+//                                       printbro(counter);
+//                                       letbro counter = counter + 1;
+//
+// Example (partial unroll, factor 4, 10 trips):
+//   2 copies of the body (the remainder), then a whilebro whose body holds
+//   4 copies; the condition is checked 3 times instead of 11.
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include "profile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// =====================================================================================
+// Class: LoopUnroller
+// Purpose:
+//   - Recognizes loops of the form
+//         letbro i = C;  ...  whilebro (i < N) { ... letbro i = i + S; ... }
+//     where the statements in between do not assign i, the body assigns i exactly
+//     once, and the condition compares i with a constant (<, > or ==, either
+//     operand order). The trip count is found by running the counter exactly
+//     like the VM would (16-bit, unsigned).
+//   - Every copy is checked against a code-size budget so unrolling can never
+//     push the program past the end of the code region.
+// =====================================================================================
+class LoopUnroller {
+public:
+    // factor:     body copies per iteration for partial unrolling (< 2 disables it)
+    // codeBudget: maximum size of the generated code, in bytes
+    // profile:    optional branch counts; loops that never ran are left rolled
+    //             and hot loops get a larger factor
+    LoopUnroller(int factor, int codeBudget, const Profile* profile = nullptr);
+
+    // Rewrites `program` in place
+    void run(Program& program);
+
+private:
+    // Processes one statement list, unrolling inner loops first
+    void processBlock(std::vector<StmtPtr>& block);
+
+    // Returns the trip count of `loop`, or -1 if it is not known. `preceding`
+    // holds the statements that run before the loop in the same block.
+    long tripCount(const std::vector<StmtPtr>& preceding, const WhileStatement& loop);
+
+    int factor;
+    int codeBudget;
+    const Profile* profile;
+    int codeSize = 0;  // Running estimate of the program size in bytes
+};
@@ -0,0 +1,617 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: x86backend.cpp
+// Purpose:
+//   - Implements the x86-64 backend (see x86backend.h). The output is one
+//     assembly file with `main`, four small runtime routines (bro_print,
+//     bro_print_string, bro_div_zero and bro_index_oob, all calling into libc),
+//     the string literals in .rodata and the .bss slots of arrays and of
+//     variables that did not get a register.
+// =====================================================================================
+
+#include "x86backend.h"
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+    // Callee-saved, so they survive the printf call in bro_print
+    const char* const VARIABLE_REGISTERS[] = {"%ebx", "%ebp", "%r12d", "%r13d", "%r14d", "%r15d"};
+
+    // Caller-saved scratch registers for intermediate results
+    const char* const SCRATCH_REGISTERS[] = {"%esi", "%edi", "%r8d", "%r9d", "%r10d", "%r11d"};
+    constexpr int SCRATCH_COUNT = 6;
+
+    // Relative weight of a use per level of loop nesting (as in blocklayout.cpp)
+    constexpr long LOOP_WEIGHT = 8;
+    constexpr int MAX_WEIGHTED_DEPTH = 6;
+
+    bool isLogical(const BinaryExpr& bin) {
+        return bin.op == BinaryOp::And || bin.op == BinaryOp::Or;
+    }
+
+    // Operand of .ascii: quotes, backslashes and unprintable bytes escaped
+    std::string asciiLiteral(const std::string& text) {
+        std::string out = "\"";
+        for (unsigned char c : text) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (c < 0x20 || c >= 0x7F) {
+                const char digits[] = {'\\', char('0' + (c >> 6)), char('0' + ((c >> 3) & 7)), char('0' + (c & 7))};
+                out.append(digits, 4);
+            } else {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+} // namespace
+
+X86Backend::X86Backend(bool elideChecks) : elideChecks(elideChecks) {}
+
+// =====================================================================================
+// Function: generate
+// Purpose:
+//   - Allocates registers, then writes main, the runtime and the data.
+// =====================================================================================
+std::string X86Backend::generate(const Program& program) {
+    text.str("");
+    labelCount = 0;
+    useCounts.clear();
+    registerOf.clear();
+    memoryVariables.clear();
+    declared.clear();
+    arrays.clear();
+    strings.clear();
+
+    // ---------------- Register allocation ----------------
+    countUses(program.statements, 0);
+    std::vector<std::pair<std::string, long>> byUses(useCounts.begin(), useCounts.end());
+    std::stable_sort(byUses.begin(), byUses.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    for (size_t k = 0; k < byUses.size(); ++k) {
+        if (k < std::size(VARIABLE_REGISTERS)) registerOf[byUses[k].first] = VARIABLE_REGISTERS[k];
+        else memoryVariables.insert(byUses[k].first);
+    }
+
+    // ---------------- main ----------------
+    text << "    .text\n";
+    text << "    .globl main\n";
+    text << "main:\n";
+    emit("pushq %rbx");
+    emit("pushq %rbp");
+    emit("pushq %r12");
+    emit("pushq %r13");
+    emit("pushq %r14");
+    emit("pushq %r15");
+    emit("subq $8, %rsp");                       // Keep rsp 16-byte aligned for calls
+    for (const auto& [name, reg] : registerOf)
+        emit("xorl " + reg + ", " + reg);        // Variables start at 0, like VM memory
+
+    for (const auto& stmt : program.statements)
+        genStatement(stmt);
+
+    emit("addq $8, %rsp");
+    emit("popq %r15");
+    emit("popq %r14");
+    emit("popq %r13");
+    emit("popq %r12");
+    emit("popq %rbp");
+    emit("popq %rbx");
+    emit("xorl %eax, %eax");
+    emit("ret");
+
+    // ---------------- Runtime ----------------
+    text << "\n# bro_print(edi): the two lines PRN prints\n";
+    text << "bro_print:\n";
+    emit("subq $8, %rsp");
+    emit("movl %edi, %esi");
+    emit("movl %edi, %edx");
+    emit("leaq .Lprint_format(%rip), %rdi");
+    emit("xorl %eax, %eax");
+    emit("call printf@PLT");
+    emit("addq $8, %rsp");
+    emit("ret");
+
+    text << "\n# bro_print_string(rdi, esi): writes esi bytes from rdi, as PRS\n";
+    text << "bro_print_string:\n";
+    emit("subq $8, %rsp");
+    emit("movl %esi, %edx");
+    emit("movl $1, %esi");
+    emit("movq stdout@GOTPCREL(%rip), %rax");
+    emit("movq (%rax), %rcx");
+    emit("call fwrite@PLT");
+    emit("addq $8, %rsp");
+    emit("ret");
+
+    text << "\n# Jumped to (not called) when a divisor is 0: VM::handleError's message and status\n";
+    text << "bro_div_zero:\n";
+    emit("andq $-16, %rsp");
+    emit("leaq .Ldiv_zero_message(%rip), %rdi");
+    emit("movq stderr@GOTPCREL(%rip), %rax");
+    emit("movq (%rax), %rsi");
+    emit("call fputs@PLT");
+    emit("movl $1, %edi");
+    emit("call exit@PLT");
+
+    text << "\n# Jumped to (not called) when an array index is out of bounds\n";
+    text << "bro_index_oob:\n";
+    emit("andq $-16, %rsp");
+    emit("leaq .Lindex_message(%rip), %rdi");
+    emit("movq stderr@GOTPCREL(%rip), %rax");
+    emit("movq (%rax), %rsi");
+    emit("call fputs@PLT");
+    emit("movl $1, %edi");
+    emit("call exit@PLT");
+
+    // ---------------- Data ----------------
+    text << "\n    .section .rodata\n";
+    text << ".Lprint_format:\n";
+    text << "    .string \"Output: %u\\nHUMAN OUTPUT: %u\\n\"\n";
+    text << ".Ldiv_zero_message:\n";
+    text << "    .string \"VM Error: Division by zero\\n\"\n";
+    text << ".Lindex_message:\n";
+    text << "    .string \"VM Error: Array index out of bounds\\n\"\n";
+    for (const auto& [literal, n] : strings) {
+        text << ".Lstr" << n << ":\n";
+        text << "    .ascii " << asciiLiteral(literal) << "\n";
+    }
+
+    if (!memoryVariables.empty() || !arrays.empty()) {
+        text << "\n    .bss\n";
+        text << "    .align 4\n";
+        for (const auto& name : memoryVariables) {
+            text << "bro_var_" << name << ":\n";
+            text << "    .zero 4\n";
+        }
+        for (const auto& [name, size] : arrays) {
+            text << "bro_arr_" << name << ":\n";
+            text << "    .zero " << 2 * size << "\n";
+        }
+    }
+    text << "\n    .section .note.GNU-stack,\"\",@progbits\n";
+    return text.str();
+}
+
+// =====================================================================================
+// Function: writeExecutable
+// Purpose: Writes the assembly and, unless the output is itself a `.s` file,
+//          assembles and links it with `cc`.
+// =====================================================================================
+bool X86Backend::writeExecutable(const std::string& assembly, const std::string& outputFile) {
+    bool assemblyOnly = outputFile.size() > 2 && outputFile.compare(outputFile.size() - 2, 2, ".s") == 0;
+    std::string assemblyFile = assemblyOnly ? outputFile : outputFile + ".s";
+
+    std::ofstream out(assemblyFile);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open output file: " << assemblyFile << "\n";
+        return false;
+    }
+    out << assembly;
+    out.close();
+    if (assemblyOnly) return true;
+
+    // cc gets its arguments as a vector, not through a shell, so a path may hold
+    // any character; "./" keeps one starting with '-' from reading as an option
+    std::string source = assemblyFile[0] == '-' ? "./" + assemblyFile : assemblyFile;
+    const char* argv[] = {"cc", "-o", outputFile.c_str(), source.c_str(), nullptr};
+    pid_t pid;
+    int status = 0;
+    int failed = ::posix_spawnp(&pid, "cc", nullptr, nullptr, const_cast<char* const*>(argv), environ);
+    if (failed == 0) {
+        while (::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    }
+    if (failed != 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "Assembling/linking failed: cc -o " << outputFile << " " << source << "\n";
+        return false;
+    }
+    return true;
+}
+
+// =====================================================================================
+// Function: genStatement
+// Purpose:
+//   - Same shapes as Codegen's default layout, except that whilebro tests its
+//     condition at the bottom (one taken jump per iteration).
+// =====================================================================================
+void X86Backend::genStatement(const StmtPtr& stmt) {
+    // ---------------- Let Statement ----------------
+    if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+        auto num = std::dynamic_pointer_cast<NumberExpr>(let->value);
+        if (num) {
+            declared.insert(let->name);
+            emit("movl $" + std::to_string(static_cast<uint16_t>(num->value)) + ", " + locationOf(let->name));
+            return;
+        }
+        genExpression(let->value);
+        declared.insert(let->name);
+        emit("movl %eax, " + locationOf(let->name));
+    }
+
+    // ---------------- Print Statement ----------------
+    else if (auto print = std::dynamic_pointer_cast<PrintStatement>(stmt)) {
+        genExpression(print->expr);
+        emit("movl %eax, %edi");
+        emit("call bro_print");
+    }
+
+    // ---------------- Print String: each literal stored once ----------------
+    else if (auto print = std::dynamic_pointer_cast<PrintStringStatement>(stmt)) {
+        if (print->text.empty()) return;
+        auto it = strings.emplace(print->text, static_cast<int>(strings.size())).first;
+        emit("leaq .Lstr" + std::to_string(it->second) + "(%rip), %rdi");
+        emit("movl $" + std::to_string(print->text.size()) + ", %esi");
+        emit("call bro_print_string");
+    }
+
+    // ---------------- Array Store: value, then index (checked), as in Codegen ----------------
+    else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt)) {
+        auto num = std::dynamic_pointer_cast<NumberExpr>(store->value);
+        if (num) {
+            genExpression(store->index);
+            genArrayAccess(store->array, store->size, store->inBounds);
+            emit("movw $" + std::to_string(static_cast<uint16_t>(num->value)) + ", (%rcx,%rax,2)");
+            return;
+        }
+        genExpression(store->value);
+        saveTemp(0);
+        genExpression(store->index, 1);
+        genArrayAccess(store->array, store->size, store->inBounds);
+        emit("movl %eax, %edx");
+        restoreTemp(0);
+        emit("movw %ax, (%rcx,%rdx,2)");
+    }
+
+    // ---------------- If Statement ----------------
+    else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+        std::string elseLabel = newLabel();
+        std::string endLabel = newLabel();
+
+        genBranch(ifs->condition, false, elseLabel);
+        for (const auto& s : ifs->thenBranch)
+            genStatement(s);
+
+        if (ifs->elseBranch.empty()) {
+            text << elseLabel << ":\n";
+            return;
+        }
+        emit("jmp " + endLabel);
+        text << elseLabel << ":\n";
+        for (const auto& s : ifs->elseBranch)
+            genStatement(s);
+        text << endLabel << ":\n";
+    }
+
+    // ---------------- While Statement ----------------
+    else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+        std::string bodyLabel = newLabel();
+        std::string condLabel = newLabel();
+
+        auto declaredAtCondition = declared;  // The condition sees what the loop entry sees
+        emit("jmp " + condLabel);
+        text << bodyLabel << ":\n";
+        for (const auto& s : wh->body)
+            genStatement(s);
+
+        text << condLabel << ":\n";
+        std::swap(declared, declaredAtCondition);
+        genBranch(wh->condition, true, bodyLabel);
+        std::swap(declared, declaredAtCondition);
+    }
+}
+
+// =====================================================================================
+// Function: genBranch
+// Purpose:
+//   - Comparisons become cmp + one conditional jump; && and || short-circuit
+//     exactly as in Codegen::genBranch.
+// =====================================================================================
+void X86Backend::genBranch(const ExprPtr& cond, bool jumpIfTrue, const std::string& label, int depth) {
+    auto bin = std::dynamic_pointer_cast<BinaryExpr>(cond);
+
+    if (bin && isLogical(*bin)) {
+        bool isAnd = bin->op == BinaryOp::And;
+        if (jumpIfTrue != isAnd) {
+            genBranch(bin->left, jumpIfTrue, label, depth);
+            genBranch(bin->right, jumpIfTrue, label, depth);
+        } else {
+            std::string skipLabel = newLabel();
+            genBranch(bin->left, !jumpIfTrue, skipLabel, depth);
+            genBranch(bin->right, jumpIfTrue, label, depth);
+            text << skipLabel << ":\n";
+        }
+        return;
+    }
+
+    if (bin && (bin->op == BinaryOp::Equal || bin->op == BinaryOp::Greater || bin->op == BinaryOp::Less)) {
+        std::string right = operandOf(bin->right);
+        if (right.empty()) {
+            genExpression(bin->left, depth);
+            saveTemp(depth);
+            genExpression(bin->right, depth + 1);
+            emit("movl %eax, %ecx");
+            restoreTemp(depth);
+            right = "%ecx";
+        } else {
+            genExpression(bin->left, depth);
+        }
+        emit("cmpl " + right + ", %eax");
+
+        const char* jump = "";
+        switch (bin->op) {
+            case BinaryOp::Equal:   jump = jumpIfTrue ? "je"  : "jne"; break;
+            case BinaryOp::Greater: jump = jumpIfTrue ? "ja"  : "jbe"; break;
+            default:                jump = jumpIfTrue ? "jb"  : "jae"; break;
+        }
+        emit(std::string(jump) + " " + label);
+        return;
+    }
+
+    genExpression(cond, depth);
+    emit("testl %eax, %eax");
+    emit(std::string(jumpIfTrue ? "jne " : "je ") + label);
+}
+
+// =====================================================================================
+// Function: genExpression
+// Purpose:
+//   - Leaves the 16-bit value of `expr` (zero-extended) in eax. eax, ecx and
+//     edx are free for each operator; scratch registers from `depth` on are free.
+// =====================================================================================
+void X86Backend::genExpression(const ExprPtr& expr, int depth) {
+    // --- Constants and variables ---
+    if (std::dynamic_pointer_cast<NumberExpr>(expr) || std::dynamic_pointer_cast<VariableExpr>(expr)) {
+        emit("movl " + operandOf(expr) + ", %eax");
+    }
+
+    // --- Array element ---
+    else if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr)) {
+        genExpression(idx->index, depth);
+        genArrayAccess(idx->array, idx->size, idx->inBounds);
+        emit("movzwl (%rcx,%rax,2), %eax");
+    }
+
+    // --- Intrinsic call: arguments in eax, ecx, edx ---
+    else if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+        static const char* const ARGUMENT_REGISTERS[] = {"%eax", "%ecx", "%edx"};
+
+        // Computed arguments first, each saved while the next is computed
+        std::vector<std::string> operands;
+        std::vector<size_t> computed;
+        for (size_t k = 0; k < call->args.size(); ++k) {
+            operands.push_back(k == 0 ? "" : operandOf(call->args[k]));
+            if (operands[k].empty()) computed.push_back(k);
+        }
+        for (size_t n = 0; n < computed.size(); ++n) {
+            genExpression(call->args[computed[n]], depth + static_cast<int>(n));
+            if (n + 1 < computed.size()) saveTemp(depth + static_cast<int>(n));
+        }
+        for (size_t n = computed.size(); n-- > 0;) {
+            if (n + 1 < computed.size()) restoreTemp(depth + static_cast<int>(n));
+            if (computed[n] != 0) emit(std::string("movl %eax, ") + ARGUMENT_REGISTERS[computed[n]]);
+        }
+        for (size_t k = 1; k < call->args.size(); ++k)
+            if (!operands[k].empty()) emit("movl " + operands[k] + ", " + ARGUMENT_REGISTERS[k]);
+
+        switch (call->fn) {
+            case Intrinsic::Min:
+                emit("cmpl %ecx, %eax");
+                emit("cmova %ecx, %eax");
+                break;
+            case Intrinsic::Max:
+                emit("cmpl %ecx, %eax");
+                emit("cmovb %ecx, %eax");
+                break;
+            case Intrinsic::Clamp:
+                emit("cmpl %ecx, %eax");
+                emit("cmovb %ecx, %eax");
+                emit("cmpl %edx, %eax");
+                emit("cmova %edx, %eax");
+                break;
+            case Intrinsic::Abs:
+                emit("movswl %ax, %ecx");       // Signed value
+                emit("movl %ecx, %eax");
+                emit("negl %eax");
+                emit("cmovs %ecx, %eax");       // -x < 0: x was positive
+                emit("movzwl %ax, %eax");
+                break;
+            case Intrinsic::Sign:
+                emit("movswl %ax, %ecx");
+                emit("sarl $31, %ecx");         // -1 if negative, else 0
+                emit("testl %eax, %eax");
+                emit("setne %al");
+                emit("movzbl %al, %eax");
+                emit("orl %ecx, %eax");
+                emit("movzwl %ax, %eax");
+                break;
+        }
+    }
+
+    // --- Binary operation ---
+    else if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+        // && / || used as a value: branch code, then materialize 0 or 1
+        if (isLogical(*bin)) {
+            std::string falseLabel = newLabel();
+            std::string endLabel = newLabel();
+            genBranch(expr, false, falseLabel, depth);
+            emit("movl $1, %eax");
+            emit("jmp " + endLabel);
+            text << falseLabel << ":\n";
+            emit("xorl %eax, %eax");
+            text << endLabel << ":\n";
+            return;
+        }
+
+        // Shift by a constant (only produced by the optimizer)
+        if (bin->op == BinaryOp::Shl || bin->op == BinaryOp::Shr) {
+            auto amount = std::dynamic_pointer_cast<NumberExpr>(bin->right);
+            if (!amount) {
+                std::cerr << "Shift amount must be a constant\n";
+                return;
+            }
+            genExpression(bin->left, depth);
+            uint16_t count = static_cast<uint16_t>(amount->value);
+            if (count >= 16) {
+                emit("xorl %eax, %eax");
+            } else if (bin->op == BinaryOp::Shl) {
+                emit("shll $" + std::to_string(count) + ", %eax");
+                emit("movzwl %ax, %eax");
+            } else {
+                emit("shrl $" + std::to_string(count) + ", %eax");
+            }
+            return;
+        }
+
+        std::string right = operandOf(bin->right);
+        if (right.empty()) {
+            genExpression(bin->left, depth);
+            saveTemp(depth);
+            genExpression(bin->right, depth + 1);
+            emit("movl %eax, %ecx");
+            restoreTemp(depth);
+            right = "%ecx";
+        } else {
+            genExpression(bin->left, depth);
+        }
+
+        switch (bin->op) {
+            case BinaryOp::Add:
+                emit("addl " + right + ", %eax");
+                emit("movzwl %ax, %eax");           // 16-bit wraparound
+                break;
+            case BinaryOp::Sub:
+                emit("subl " + right + ", %eax");
+                emit("movzwl %ax, %eax");
+                break;
+            case BinaryOp::Mul:
+                emit(right[0] == '$' ? "imull " + right + ", %eax, %eax" : "imull " + right + ", %eax");
+                emit("movzwl %ax, %eax");
+                break;
+            case BinaryOp::Div: {
+                if (right == "$0") {
+                    emit("jmp bro_div_zero");
+                    break;
+                }
+                if (right != "%ecx") emit("movl " + right + ", %ecx");
+                bool checked = right[0] != '$' && !(elideChecks && bin->divisorNonZero);
+                if (checked) {
+                    emit("testl %ecx, %ecx");
+                    emit("je bro_div_zero");
+                }
+                emit("xorl %edx, %edx");
+                emit("divl %ecx");
+                break;
+            }
+            case BinaryOp::Equal:
+            case BinaryOp::Greater:
+            case BinaryOp::Less:
+                emit("cmpl " + right + ", %eax");
+                emit(bin->op == BinaryOp::Equal ? "sete %al" : bin->op == BinaryOp::Greater ? "seta %al" : "setb %al");
+                emit("movzbl %al, %eax");
+                break;
+            default:
+                std::cerr << "Unknown binary operator\n";
+                break;
+        }
+    }
+}
+
+std::string X86Backend::operandOf(const ExprPtr& expr) {
+    if (auto num = std::dynamic_pointer_cast<NumberExpr>(expr))
+        return "$" + std::to_string(static_cast<uint16_t>(num->value));
+    if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr)) {
+        if (!declared.count(var->name)) {
+            std::cerr << "Unknown variable: " << var->name << "\n";
+            return "$0";
+        }
+        return locationOf(var->name);
+    }
+    return "";
+}
+
+void X86Backend::genArrayAccess(const std::string& array, int size, bool inBounds) {
+    if (!(elideChecks && inBounds)) {
+        emit("cmpl $" + std::to_string(size) + ", %eax");
+        emit("jae bro_index_oob");
+    }
+    emit("leaq bro_arr_" + array + "(%rip), %rcx");
+}
+
+void X86Backend::saveTemp(int depth) {
+    if (depth < SCRATCH_COUNT) emit(std::string("movl %eax, ") + SCRATCH_REGISTERS[depth]);
+    else emit("pushq %rax");
+}
+
+void X86Backend::restoreTemp(int depth) {
+    if (depth < SCRATCH_COUNT) emit(std::string("movl ") + SCRATCH_REGISTERS[depth] + ", %eax");
+    else emit("popq %rax");
+}
+
+// =====================================================================================
+// Register allocation helpers
+// =====================================================================================
+void X86Backend::countUses(const std::vector<StmtPtr>& stmts, int loopDepth) {
+    long weight = 1;
+    for (int d = 0; d < std::min(loopDepth, MAX_WEIGHTED_DEPTH); ++d) weight *= LOOP_WEIGHT;
+
+    for (const auto& stmt : stmts) {
+        if (auto let = std::dynamic_pointer_cast<LetStatement>(stmt)) {
+            useCounts[let->name] += weight;
+            countUses(let->value, weight);
+        } else if (auto print = std::dynamic_pointer_cast<PrintStatement>(stmt)) {
+            countUses(print->expr, weight);
+        } else if (auto decl = std::dynamic_pointer_cast<ArrayDeclStatement>(stmt)) {
+            arrays[decl->name] = decl->size;
+        } else if (auto store = std::dynamic_pointer_cast<ArrayStoreStatement>(stmt)) {
+            arrays[store->array] = store->size;
+            countUses(store->value, weight);
+            countUses(store->index, weight);
+        } else if (auto ifs = std::dynamic_pointer_cast<IfStatement>(stmt)) {
+            countUses(ifs->condition, weight);
+            countUses(ifs->thenBranch, loopDepth);
+            countUses(ifs->elseBranch, loopDepth);
+        } else if (auto wh = std::dynamic_pointer_cast<WhileStatement>(stmt)) {
+            countUses(wh->condition, weight * LOOP_WEIGHT);
+            countUses(wh->body, loopDepth + 1);
+        }
+    }
+}
+
+void X86Backend::countUses(const ExprPtr& expr, long weight) {
+    if (auto var = std::dynamic_pointer_cast<VariableExpr>(expr)) {
+        useCounts[var->name] += weight;
+    } else if (auto bin = std::dynamic_pointer_cast<BinaryExpr>(expr)) {
+        countUses(bin->left, weight);
+        countUses(bin->right, weight);
+    } else if (auto call = std::dynamic_pointer_cast<CallExpr>(expr)) {
+        for (const auto& arg : call->args) countUses(arg, weight);
+    } else if (auto idx = std::dynamic_pointer_cast<IndexExpr>(expr)) {
+        arrays[idx->array] = idx->size;
+        countUses(idx->index, weight);
+    }
+}
+
+std::string X86Backend::locationOf(const std::string& name) {
+    auto it = registerOf.find(name);
+    if (it != registerOf.end()) return it->second;
+    return "bro_var_" + name + "(%rip)";
+}
+
+std::string X86Backend::newLabel() {
+    return ".L" + std::to_string(labelCount++);
+}
+
+void X86Backend::emit(const std::string& line) {
+    text << "    " << line << "\n";
+}
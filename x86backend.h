@@ -0,0 +1,97 @@
+// =====================================================================================
+// Made by: Rohit Yadav
+// NIT Jalandhar
+//
+// File: x86backend.h
+// Purpose:
+//   - Declares the native backend: walks the (optimized) AST and writes GNU
+//     assembler text for x86-64 Linux, skipping bytecode altogether
+//     (`broc --target=x86_64`).
+//
+// Matching the VM:
+//   → Values are kept zero-extended in 32-bit registers and cut back to 16
+//     bits after every operation that can carry out of them (+, -, *, <<).
+//   → Division tests its divisor and stops with the VM's message
+//     ("VM Error: Division by zero", exit status 1), unless range analysis
+//     proved it non-zero (BinaryExpr::divisorNonZero, as for DIV_NC).
+//   → Array indexes are compared with the size the same way ("VM Error: Array
+//     index out of bounds"), unless range analysis proved them (inBounds).
+//     Arrays live in .bss, one 16-bit word per element.
+//   → printbro calls bro_print, which prints the same two lines as PRN; a string
+//     literal goes out through bro_print_string, one fwrite from .rodata, as PRS.
+//   → A variable read before its first letbro in the source reads 0, as in Codegen.
+//
+// Registers:
+//   → The most used variables (uses weighted by loop nesting) live in the
+//     callee-saved registers ebx, ebp, r12d-r15d, so the printf call inside
+//     bro_print leaves them alone; the rest live in .bss.
+//   → Intermediate results go to esi, edi, r8d-r11d (nothing is called while
+//     an expression is evaluated), and to the machine stack after that.
+// =====================================================================================
+
+#pragma once
+
+#include "ast.h"
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+
+// =====================================================================================
+// Class: X86Backend
+// Usage:
+//   X86Backend backend(checkDivisions);
+//   std::string assembly = backend.generate(program);
+//   X86Backend::writeExecutable(assembly, "prog");      // prog.s, then cc -o prog
+// =====================================================================================
+class X86Backend {
+public:
+    // elideChecks: trust BinaryExpr::divisorNonZero / inBounds and skip those tests
+    explicit X86Backend(bool elideChecks = false);
+
+    std::string generate(const Program& program);
+
+    // Writes `assembly` next to `outputFile` and links it there with `cc`; an
+    // output ending in .s gets the assembly only. Prints an error and returns
+    // false on failure.
+    static bool writeExecutable(const std::string& assembly, const std::string& outputFile);
+
+private:
+    void genStatement(const StmtPtr& stmt);
+
+    // Leaves the value of `expr` in eax; `depth` counts scratch registers in use
+    void genExpression(const ExprPtr& expr, int depth = 0);
+
+    // Jumps to `label` when `cond` is true (jumpIfTrue) or false, else falls through
+    void genBranch(const ExprPtr& cond, bool jumpIfTrue, const std::string& label, int depth = 0);
+
+    // Operand for constants and variables (no code needed), or "" if it must be computed
+    std::string operandOf(const ExprPtr& expr);
+
+    // Compares the index in eax with `size` (unless proven) and points rcx at the array
+    void genArrayAccess(const std::string& array, int size, bool inBounds);
+
+    // Saves eax while another operand is computed (scratch register `depth`,
+    // or the machine stack once they run out), and brings it back into eax
+    void saveTemp(int depth);
+    void restoreTemp(int depth);
+
+    // Register allocation: counts uses weighted by loop nesting
+    void countUses(const std::vector<StmtPtr>& stmts, int loopDepth);
+    void countUses(const ExprPtr& expr, long weight);
+    std::string locationOf(const std::string& name);
+
+    std::string newLabel();
+    void emit(const std::string& line);
+
+    bool elideChecks;
+    std::ostringstream text;
+    int labelCount = 0;
+
+    std::map<std::string, long> useCounts;
+    std::map<std::string, std::string> registerOf;    // Variable → register (e.g. "%ebx")
+    std::set<std::string> memoryVariables;            // Variables living in .bss
+    std::set<std::string> declared;                   // letbro seen earlier in the source
+    std::map<std::string, int> arrays;                // Array → number of elements
+    std::map<std::string, int> strings;               // String literal → n in its label .Lstr<n>
+};